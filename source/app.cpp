@@ -1,14 +1,18 @@
 #include "app.hpp"
 #include "utils/date.hpp"
 #include "utils/string.hpp"
+#include "utils/symbol_table.hpp"
 #include "view/view.hpp"
 
 #include <algorithm>
+#include <array>
 #include <fmt/format.h>
 #include <fmt/ranges.h>
+#include <limits>
 #include <memory>
 #include <ranges>
 #include <utility>
+#include <vector>
 
 namespace caps_log {
 
@@ -44,6 +48,20 @@ static const std::string kHelpString = R"(
   You may notice that by selecting a section, the tag list is updated to only show tags that 
   exist within the selected section.
 
+  For more complex filters press `/` and type a tag query, e.g. 
+  `work & !meeting | (section:health & run)`. A plain title matches a tag in any section, 
+  `section:title` matches a section, `!`, `&` and `|` combine them and parentheses group them. 
+  Enter keeps the query applied while navigating, Escape drops it.
+
+  To find logs by their content press `?` and type some words. Logs containing all of them are
+  highlighted and the most recent ones are listed in the preview.
+
+  Lines like `- [ ] (tag) title` are tasks, `- [x]` marks them as done. Press `t` to highlight
+  the days with open tasks and list them in the preview, press it again to go back.
+
+  Tags can carry a number, e.g. `* weight (72.4)` or `* sleep: 7.5`. Select a tag and press `v`
+  to highlight the days it has a value and chart its values by month, week and year.
+
   # Controls:
 
   |---------------------------------------------------------------------|
@@ -56,6 +74,12 @@ static const std::string kHelpString = R"(
   | s                          | Open scratchpad view                   |
   | d                          | Delete focused scratchpad/log          |
   | r                          | Rename focused scratchpad              |
+  | /                          | Highlight logs matching a tag query    |
+  | ?                          | Search the content of the logs         |
+  | t                          | Highlight days with open tasks         |
+  | v                          | Chart the values of the selected tag   |
+  | f                          | Filter the focused tag or section menu |
+  | F12                        | Toggle the latency overlay             |
   | q/Escape                   | Quit application                       |
   |---------------------------------------------------------------------|
   )";
@@ -75,9 +99,63 @@ namespace {
     return "No exception";
 }
 
-[[nodiscard]] bool noMeaningfulContent(const std::string &content,
+[[nodiscard]] std::shared_ptr<LogMetadataIndex> openMetadataIndex(const AppConfig &config) {
+    if (not config.metadataIndexPath) {
+        return nullptr;
+    }
+    return std::make_shared<LogMetadataIndex>(*config.metadataIndexPath, config.skipFirstLine);
+}
+
+/**
+ * Dates the focus is likely to move to next: the neighbouring days in the calendar grid followed
+ * by the rest of the focused month.
+ */
+[[nodiscard]] std::vector<std::chrono::year_month_day>
+makePrefetchDates(const std::chrono::year_month_day &date) {
+    static constexpr std::array kNeighbourOffsets{1, -1, 7, -7};
+    std::vector<std::chrono::year_month_day> dates;
+    for (const auto offset : kNeighbourOffsets) {
+        dates.emplace_back(std::chrono::sys_days{date} + std::chrono::days{offset});
+    }
+    const auto lastDay = (date.year() / date.month() / std::chrono::last).day();
+    for (auto day = date.day() + std::chrono::days{2}; day <= lastDay; day++) {
+        dates.push_back(date.year() / date.month() / day);
+    }
+    return dates;
+}
+
+[[nodiscard]] std::unique_ptr<AnnualLogDataCache>
+makeAnnualLogDataCache(std::shared_ptr<LogRepositoryBase> repo,
+                       std::shared_ptr<LogMetadataIndex> index, const AppConfig &config) {
+    return std::make_unique<AnnualLogDataCache>(
+        std::move(repo), std::move(index),
+        AnnualLogDataCache::Config{
+            .skipFirstLine = config.skipFirstLine,
+            .collectWorkers = config.collectWorkers,
+            .capacityBytes = config.yearCacheSize,
+        });
+}
+
+[[nodiscard]] std::unique_ptr<LogIndexer>
+makeLogIndexer(std::vector<std::shared_ptr<LogIndexBase>> indexes, const AppConfig &config) {
+    std::erase(indexes, nullptr);
+    if (indexes.empty()) {
+        return nullptr;
+    }
+    return std::make_unique<LogIndexer>(std::move(indexes), config.skipFirstLine);
+}
+
+[[nodiscard]] std::unique_ptr<Debouncer> makePreviewLoader(const AppConfig &config) {
+    if (config.previewDebounce <= std::chrono::milliseconds::zero()) {
+        return nullptr;
+    }
+    return std::make_unique<Debouncer>(config.previewDebounce);
+}
+
+[[nodiscard]] bool noMeaningfulContent(std::string_view content,
                                        const std::chrono::year_month_day &date) {
-    return utils::trim(content) == date::formatToString(date, kLogBaseTemplate) || content.empty();
+    return utils::trimView(content) == date::formatToString(date, kLogBaseTemplate) ||
+           content.empty();
 }
 
 [[nodiscard]] std::string makePreviewTitle(std::chrono::year_month_day date,
@@ -127,24 +205,23 @@ namespace {
 
 ViewDataUpdater::ViewDataUpdater(std::shared_ptr<AnnualViewLayoutBase> view,
                                  const AnnualLogData &data)
-    : m_view{std::move(view)}, m_data{data} {}
+    : m_view{std::move(view)}, m_data{&data} {}
 
 void ViewDataUpdater::handleFocusedTagChange() {
     const auto newTag = m_view->getSelectedTag();
     if (m_view->getSelectedSection() == kSelectNoneMenuEntryText) {
         if (newTag == kSelectNoneMenuEntryText) {
-            m_view->setHighlightedDates(nullptr);
+            highlightMenuSelection(nullptr);
         } else {
-            m_view->setHighlightedDates(
-                &m_data.tagsPerSection.at(AnnualLogData::kAnySection).at(newTag));
+            highlightMenuSelection(m_data->findDates(AnnualLogData::kAnySection, newTag));
         }
     } else if (newTag == kSelectNoneMenuEntryText) {
-        m_view->setHighlightedDates(
-            &m_data.tagsPerSection.at(m_view->getSelectedSection()).at(AnnualLogData::kAnyOrNoTag));
+        highlightMenuSelection(
+            m_data->findDates(m_view->getSelectedSection(), AnnualLogData::kAnyOrNoTag));
     } else {
         const auto *const highlightedDates =
-            &m_data.tagsPerSection.at(m_view->getSelectedSection()).at(newTag);
-        m_view->setHighlightedDates(highlightedDates);
+            m_data->findDates(m_view->getSelectedSection(), newTag);
+        highlightMenuSelection(highlightedDates);
     }
 }
 
@@ -153,11 +230,10 @@ void ViewDataUpdater::handleFocusedSectionChange() {
     m_view->setSelectedTag(kSelectNoneMenuEntryText);
     if (newSection == kSelectNoneMenuEntryText) {
         m_view->tagMenuItems() = m_tagMenuItemsPerSection.at(kSelectNoneMenuEntryText);
-        m_view->setHighlightedDates(nullptr);
+        highlightMenuSelection(nullptr);
     } else {
         m_view->tagMenuItems() = m_tagMenuItemsPerSection.at(newSection);
-        m_view->setHighlightedDates(
-            &m_data.tagsPerSection.at(newSection).at(AnnualLogData::kAnyOrNoTag));
+        highlightMenuSelection(m_data->findDates(newSection, AnnualLogData::kAnyOrNoTag));
     }
 }
 
@@ -165,16 +241,59 @@ void ViewDataUpdater::updateTagMenuItemsPerSection() {
     m_tagMenuItemsPerSection.clear();
 
     // update menu items
-    const auto allTags = m_data.getAllTags();
     m_tagMenuItemsPerSection[kSelectNoneMenuEntryText] = makeTagMenuItems(kSelectNoneMenuEntryText);
 
-    for (const auto &section : m_data.getAllSections()) {
+    for (const auto &section : m_data->getAllSections()) {
         m_tagMenuItemsPerSection[section] = makeTagMenuItems(section);
     }
 }
 
+void ViewDataUpdater::handleQueryChange(const std::string &query) {
+    if (utils::trimView(query).empty()) {
+        m_query.clear();
+        m_view->setQueryStatus("");
+        handleFocusedTagChange();
+        return;
+    }
+
+    try {
+        const auto compiled = TagQuery::compile(query);
+        m_query = query;
+        highlightQueryMatches(compiled);
+    } catch (const TagQueryError &error) {
+        // happens while the query is being typed, the last valid query stays highlighted
+        m_view->setQueryStatus(fmt::format("{} (at {})", error.what(), error.getPosition() + 1));
+    }
+}
+
+void ViewDataUpdater::setSearchMatches(std::optional<utils::date::Dates> matches) {
+    m_searchMatches = std::move(matches);
+    if (m_searchMatches) {
+        m_view->setHighlightedDates(&*m_searchMatches);
+    } else {
+        handleFocusedTagChange();
+    }
+}
+
+void ViewDataUpdater::highlightMenuSelection(const date::Dates *dates) {
+    if (m_query.empty() && not m_searchMatches) {
+        m_view->setHighlightedDates(dates);
+    }
+}
+
+void ViewDataUpdater::highlightQueryMatches(const TagQuery &query) {
+    m_queryMatches = query.evaluate(*m_data);
+    m_view->setHighlightedDates(&m_queryMatches);
+    m_view->setQueryStatus(fmt::format("{} matching logs", m_queryMatches.size()));
+}
+
 void ViewDataUpdater::updateViewAfterDataChange(const std::string &previewTitle,
                                                 const std::string &previewString) {
+    updateViewAfterDataChange();
+    m_view->setPreviewString(previewTitle, previewString);
+}
+
+void ViewDataUpdater::updateViewAfterDataChange() {
     // update sections menu items
     {
         const auto oldSections = m_view->sectionMenuItems().getKeys();
@@ -221,17 +340,18 @@ void ViewDataUpdater::updateViewAfterDataChange(const std::string &previewTitle,
 
     if (m_view->getSelectedTag() == kSelectNoneMenuEntryText &&
         m_view->getSelectedSection() == kSelectNoneMenuEntryText) {
-        m_view->setHighlightedDates(nullptr);
+        highlightMenuSelection(nullptr);
     } else if (m_view->getSelectedTag() == kSelectNoneMenuEntryText) {
-        m_view->setHighlightedDates(
-            &m_data.tagsPerSection.at(m_view->getSelectedSection()).at(AnnualLogData::kAnyOrNoTag));
+        highlightMenuSelection(
+            m_data->findDates(m_view->getSelectedSection(), AnnualLogData::kAnyOrNoTag));
     } else {
-        m_view->setHighlightedDates(
-            &m_data.tagsPerSection.at(AnnualLogData::kAnySection).at(m_view->getSelectedTag()));
+        highlightMenuSelection(
+            m_data->findDates(AnnualLogData::kAnySection, m_view->getSelectedTag()));
+    }
+    if (not m_query.empty()) {
+        // titles are resolved when compiling, recompiling picks up the titles new to the data
+        highlightQueryMatches(TagQuery::compile(m_query));
     }
-
-    // update preview string
-    m_view->setPreviewString(previewTitle, previewString);
 }
 
 MenuItems ViewDataUpdater::makeTagMenuItems(const std::string &section) {
@@ -242,12 +362,16 @@ MenuItems ViewDataUpdater::makeTagMenuItems(const std::string &section) {
     menuItems.push_back(kSelectNoneMenuEntryText);
     keys.push_back(kSelectNoneMenuEntryText);
 
-    const auto sect = section == kSelectNoneMenuEntryText ? AnnualLogData::kAnySection : section;
-    for (const auto &[tag, dates] : m_data.tagsPerSection.at(sect)) {
-        if (tag == AnnualLogData::kAnyOrNoTag) {
-            continue;
-        }
-        menuItems.push_back(makeMenuItemTitle(tag, dates.size()));
+    const auto &symbols = utils::SymbolTable::global();
+    const auto sectionId = section == kSelectNoneMenuEntryText
+                               ? std::optional{AnnualLogData::anySectionId()}
+                               : symbols.find(section);
+    if (not sectionId) {
+        return {menuItems, keys};
+    }
+    for (const auto tagId : m_data->getTagIds(*sectionId)) {
+        const auto tag = std::string{symbols.name(tagId)};
+        menuItems.push_back(makeMenuItemTitle(tag, m_data->findDates(*sectionId, tagId)->size()));
         keys.push_back(tag);
     }
     return {menuItems, keys};
@@ -256,26 +380,49 @@ MenuItems ViewDataUpdater::makeTagMenuItems(const std::string &section) {
 MenuItems ViewDataUpdater::makeSectionMenuItems() {
     std::vector<std::string> menuItems;
     std::vector<std::string> keys;
-    menuItems.reserve(m_data.tagsPerSection.size());
-    keys.reserve(m_data.tagsPerSection.size());
+    const auto &symbols = utils::SymbolTable::global();
+    const auto &sectionIds = m_data->getSectionIds();
+    menuItems.reserve(sectionIds.size() + 1);
+    keys.reserve(sectionIds.size() + 1);
 
     // prepend select none
     menuItems.push_back(kSelectNoneMenuEntryText);
     keys.push_back(kSelectNoneMenuEntryText);
 
-    for (const auto &section : m_data.tagsPerSection | std::views::keys) {
-        if (section == AnnualLogData::kAnySection) {
-            continue;
-        }
+    for (const auto sectionId : sectionIds) {
+        const auto section = std::string{symbols.name(sectionId)};
         menuItems.push_back(makeMenuItemTitle(
-            section, m_data.tagsPerSection.at(section).at(AnnualLogData::kAnyOrNoTag).size()));
+            section, m_data->findDates(sectionId, AnnualLogData::anyOrNoTagId())->size()));
         keys.push_back(section);
     }
     return {menuItems, keys};
 }
 
 void App::updateDataAndViewAfterLogChange(const std::chrono::year_month_day &dateOfChangedLog) {
-    m_data.collect(m_repo, dateOfChangedLog, m_config.skipFirstLine);
+    m_data->collect(m_repo, dateOfChangedLog, m_config.skipFirstLine, m_metadataIndex);
+    if (m_collectingYear) {
+        // the month of the log may still be collected from before the change
+        m_changedWhileCollecting.push_back(dateOfChangedLog);
+    }
+    updateIndexesAfterLogChange(dateOfChangedLog);
+    updateViewAfterDataChange(dateOfChangedLog);
+}
+
+void App::updateIndexesAfterLogChange(const std::chrono::year_month_day &dateOfChangedLog) {
+    if (not m_indexer) {
+        return;
+    }
+    // only the changed log is read, once for all indexes
+    if (auto log = m_repo->read(dateOfChangedLog)) {
+        m_indexer->update(std::move(*log));
+    } else {
+        m_indexer->remove(dateOfChangedLog);
+    }
+}
+
+void App::updateViewAfterDataChange(const std::chrono::year_month_day &dateOfChangedLog) {
+    // the preview is set below, a load still in flight would overwrite it
+    cancelPreviewLoad();
     std::string previewString;
     if (dateOfChangedLog == m_view->getAnnualViewLayout()->getFocusedDate()) {
         if (auto log = m_repo->read(m_view->getAnnualViewLayout()->getFocusedDate())) {
@@ -285,6 +432,11 @@ void App::updateDataAndViewAfterLogChange(const std::chrono::year_month_day &dat
 
     m_viewDataUpdater.updateViewAfterDataChange(makePreviewTitle(dateOfChangedLog, m_config.events),
                                                 previewString);
+    if (not m_searchText.empty()) {
+        // the results may have changed with the log or the displayed year
+        showSearchResults();
+    }
+    showPreviewMode();
 }
 
 App::App(std::shared_ptr<ViewBase> view, std::shared_ptr<LogRepositoryBase> repo,
@@ -292,11 +444,23 @@ App::App(std::shared_ptr<ViewBase> view, std::shared_ptr<LogRepositoryBase> repo
          std::shared_ptr<EditorBase> editor, std::optional<GitRepo> gitRepo, AppConfig config)
     : m_config{std::move(config)}, m_view{std::move(view)}, m_repo{std::move(repo)},
       m_scratchpadRepo{std::move(scratchpadRepo)}, m_editor{std::move(editor)},
-      m_data{AnnualLogData::collect(m_repo, m_config.currentYear, m_config.skipFirstLine)},
-      m_viewDataUpdater{m_view->getAnnualViewLayout(), m_data} {
+      m_metadataIndex{openMetadataIndex(m_config)},
+      m_years{makeAnnualLogDataCache(m_repo, m_metadataIndex, m_config)},
+      m_data{m_config.progressiveCollect ? std::make_shared<AnnualLogData>()
+                                         : m_years->get(m_config.currentYear)},
+      m_textIndex{m_config.textSearch ? std::make_shared<TextSearchIndex>() : nullptr},
+      m_taskIndex{m_config.taskIndex ? std::make_shared<TaskIndex>() : nullptr},
+      m_tagValueIndex{m_config.tagValues ? std::make_shared<TagValueIndex>() : nullptr},
+      m_indexer{makeLogIndexer({m_textIndex, m_taskIndex, m_tagValueIndex}, m_config)},
+      m_viewDataUpdater{m_view->getAnnualViewLayout(), *m_data},
+      m_previewLoader{makePreviewLoader(m_config)} {
     m_view->setInputHandler(this);
-    m_view->getAnnualViewLayout()->setDatesWithLogs(&m_data.datesWithLogs);
+    m_view->getAnnualViewLayout()->setDatesWithLogs(&m_data->datesWithLogs);
     m_view->getAnnualViewLayout()->setEventDates(&m_config.events);
+    if (m_config.progressiveCollect) {
+        // the first frame shows an empty calendar that fills in as the months are collected
+        collectInBackground(m_config.currentYear);
+    }
     updateDataAndViewAfterLogChange(m_view->getAnnualViewLayout()->getFocusedDate());
 
     if (gitRepo) {
@@ -311,7 +475,13 @@ App::App(
     std::function<std::shared_ptr<EditorBase>(std::string)> aEditorFactory,
     std::optional<GitRepo> gitRepo, AppConfig config)
     : m_config{std::move(config)}, m_view{std::move(view)},
-      m_viewDataUpdater{m_view->getAnnualViewLayout(), m_data} {
+      m_metadataIndex{openMetadataIndex(m_config)}, m_data{std::make_shared<AnnualLogData>()},
+      m_textIndex{m_config.textSearch ? std::make_shared<TextSearchIndex>() : nullptr},
+      m_taskIndex{m_config.taskIndex ? std::make_shared<TaskIndex>() : nullptr},
+      m_tagValueIndex{m_config.tagValues ? std::make_shared<TagValueIndex>() : nullptr},
+      m_indexer{makeLogIndexer({m_textIndex, m_taskIndex, m_tagValueIndex}, m_config)},
+      m_viewDataUpdater{m_view->getAnnualViewLayout(), *m_data},
+      m_previewLoader{makePreviewLoader(m_config)} {
     m_view->setInputHandler(this);
     m_askForPassword = AskForPassword{
         .logRepoFactory = std::move(aLogRepoFactory),
@@ -348,6 +518,10 @@ bool App::handleInputEvent(const UIEvent &event) {
                 handleFocusedTagChange();
             } else if constexpr (std::is_same_v<T, FocusedSectionChange>) {
                 handleFocusedSectionChange();
+            } else if constexpr (std::is_same_v<T, QueryChange>) {
+                handleQueryChange(arg.query);
+            } else if constexpr (std::is_same_v<T, SearchChange>) {
+                handleSearchChange(arg.text);
             } else if constexpr (std::is_same_v<T, UnhandledRootEvent>) {
                 return handleRootEvent(arg.input);
             }
@@ -367,6 +541,10 @@ bool App::handleRootEvent(const std::string &input) {
         handleDisplayedYearChange(-1);
     } else if (input == "s") {
         handleSwitchLayout();
+    } else if (input == "t") {
+        handleTogglePreviewMode(PreviewMode::kOpenTasks);
+    } else if (input == "v") {
+        handleTogglePreviewMode(PreviewMode::kTagValues);
     } else if (input == ftxui::Event::F1.input()) {
         m_view->getPopUpView().show(PopUpViewBase::Help{kHelpString});
     } else {
@@ -384,18 +562,257 @@ void App::handleSwitchLayout() {
 }
 
 void App::handleFocusedDateChange() {
-    const auto title =
-        makePreviewTitle(m_view->getAnnualViewLayout()->getFocusedDate(), m_config.events);
-    if (auto log = m_repo->read(m_view->getAnnualViewLayout()->getFocusedDate())) {
-        m_view->getAnnualViewLayout()->setPreviewString(title, log->getContent());
+    const auto focusedDate = m_view->getAnnualViewLayout()->getFocusedDate();
+    if (not m_previewLoader) {
+        showPreviewOf(focusedDate);
+        return;
+    }
+
+    // the title follows the focus right away, the content once the focus stays on the date
+    const auto generation = ++m_previewGeneration;
+    m_view->getAnnualViewLayout()->setPreviewString(
+        makePreviewTitle(focusedDate, m_config.events), "");
+    m_previewLoader->schedule([this, repo = m_repo, focusedDate, generation]() {
+        try {
+            auto log = repo->read(focusedDate);
+            m_view->post("task:PreviewRead",
+                         [this, focusedDate, generation, log = std::move(log)]() {
+                             if (generation != m_previewGeneration) {
+                                 return;
+                             }
+                             m_view->getAnnualViewLayout()->setPreviewString(
+                                 makePreviewTitle(focusedDate, m_config.events),
+                                 log ? std::string{log->getContent()} : "");
+                             m_repo->prefetch(makePrefetchDates(focusedDate));
+                         });
+        } catch (const std::exception &) {
+            // read again on the UI thread so the error is reported the same way as without delay
+            m_view->post("task:PreviewReadFailed", [this, focusedDate, generation]() {
+                if (generation == m_previewGeneration) {
+                    showPreviewOf(focusedDate);
+                }
+            });
+        }
+    });
+}
+
+void App::showPreviewOf(const std::chrono::year_month_day &date) {
+    cancelPreviewLoad();
+    const auto title = makePreviewTitle(date, m_config.events);
+    if (auto log = m_repo->read(date)) {
+        m_view->getAnnualViewLayout()->setPreviewString(title, std::string{log->getContent()});
     } else {
         m_view->getAnnualViewLayout()->setPreviewString(title, "");
     }
+    m_repo->prefetch(makePrefetchDates(date));
+}
+
+void App::cancelPreviewLoad() {
+    ++m_previewGeneration;
+    if (m_previewLoader) {
+        m_previewLoader->cancel();
+    }
+}
+
+void App::handleFocusedTagChange() {
+    m_viewDataUpdater.handleFocusedTagChange();
+    if (m_previewMode == PreviewMode::kTagValues) {
+        showTagValues();
+    }
+}
+
+void App::handleFocusedSectionChange() {
+    m_viewDataUpdater.handleFocusedSectionChange();
+    if (m_previewMode == PreviewMode::kTagValues) {
+        // the selected tag was reset with the section
+        showTagValues();
+    }
+}
+
+void App::handleQueryChange(const std::string &query) {
+    m_viewDataUpdater.handleQueryChange(query);
+}
+
+void App::handleSearchChange(const std::string &text) {
+    if (utils::trimView(text).empty()) {
+        m_searchText.clear();
+        m_view->getAnnualViewLayout()->setQueryStatus("");
+        m_viewDataUpdater.setSearchMatches(std::nullopt);
+        // brings back the preview of the focused log
+        handleFocusedDateChange();
+        return;
+    }
+    m_searchText = text;
+    // the search results take over the highlight and the preview
+    m_previewMode = PreviewMode::kFocusedLog;
+    showSearchResults();
+}
+
+void App::showSearchResults() {
+    static constexpr std::ptrdiff_t kMaxListedResults = 20;
+    static constexpr std::size_t kSnippetWidth = 60;
+    const auto layout = m_view->getAnnualViewLayout();
+    if (not m_textIndex) {
+        layout->setQueryStatus("text search is disabled in the config");
+        return;
+    }
+
+    cancelPreviewLoad();
+    const auto results = m_textIndex->search(m_searchText);
+    date::Dates displayedYearMatches;
+    for (const auto &result : results) {
+        if (result.year() == m_config.currentYear) {
+            displayedYearMatches.insert(date::monthDay(result));
+        }
+    }
+    layout->setQueryStatus(fmt::format("{} matching logs, {} in {}", results.size(),
+                                       displayedYearMatches.size(),
+                                       static_cast<int>(m_config.currentYear)));
+    m_viewDataUpdater.setSearchMatches(displayedYearMatches);
+
+    // only the listed logs are read, for their snippets
+    std::string list;
+    const auto listed = std::min(kMaxListedResults, std::ssize(results));
+    for (auto result = results.rbegin(); result != results.rbegin() + listed; ++result) {
+        if (const auto log = m_repo->read(*result)) {
+            list += fmt::format(
+                "- {}: {}\n", date::formatToString(*result),
+                TextSearchIndex::makeSnippet(log->getContent(), m_searchText, kSnippetWidth));
+        }
+    }
+    layout->setPreviewString(fmt::format("Search: {}", utils::trimView(m_searchText)), list);
+}
+
+void App::handleTogglePreviewMode(PreviewMode mode) {
+    m_previewMode = m_previewMode == mode ? PreviewMode::kFocusedLog : mode;
+    if (m_previewMode != PreviewMode::kFocusedLog) {
+        showPreviewMode();
+        return;
+    }
+    m_viewDataUpdater.setSearchMatches(std::nullopt);
+    if (not m_searchText.empty()) {
+        showSearchResults();
+        return;
+    }
+    m_view->getAnnualViewLayout()->setQueryStatus("");
+    // brings back the preview of the focused log
+    handleFocusedDateChange();
 }
 
-void App::handleFocusedTagChange() { m_viewDataUpdater.handleFocusedTagChange(); }
+void App::showPreviewMode() {
+    if (m_previewMode == PreviewMode::kOpenTasks) {
+        showOpenTasks();
+    } else if (m_previewMode == PreviewMode::kTagValues) {
+        showTagValues();
+    }
+}
+
+void App::showOpenTasks() {
+    static constexpr std::size_t kMaxListedTasks = 50;
+    const auto layout = m_view->getAnnualViewLayout();
+    if (not m_taskIndex) {
+        layout->setQueryStatus("the task index is disabled in the config");
+        return;
+    }
+
+    cancelPreviewLoad();
+    const auto tasks = m_taskIndex->openTasks();
+    auto dates = m_taskIndex->datesWithOpenTasks(m_config.currentYear);
+    layout->setQueryStatus(fmt::format("{} open tasks, {} days in {}", tasks.size(), dates.size(),
+                                       static_cast<int>(m_config.currentYear)));
+    m_viewDataUpdater.setSearchMatches(std::move(dates));
+
+    std::string list;
+    for (const auto &task : tasks | std::views::take(kMaxListedTasks)) {
+        list += fmt::format("- {}: {}{}\n", date::formatToString(task.date),
+                            task.tag.empty() ? "" : fmt::format("({}) ", task.tag), task.title);
+    }
+    layout->setPreviewString("Open tasks", list);
+}
+
+void App::showTagValues() {
+    using Aggregation = TagValueIndex::Aggregation;
+    using Period = TagValueIndex::Period;
+    static constexpr int kMaxChartedYears = 10;
+    static constexpr std::size_t kMonthsPerYear = 12;
+    const auto layout = m_view->getAnnualViewLayout();
+    if (not m_tagValueIndex) {
+        layout->setQueryStatus("tag values are disabled in the config");
+        return;
+    }
+
+    cancelPreviewLoad();
+    const auto &tag = layout->getSelectedTag();
+    auto dates = m_tagValueIndex->datesWithValues(tag, m_config.currentYear);
+    layout->setQueryStatus(fmt::format("{} values in {}", dates.size(),
+                                       static_cast<int>(m_config.currentYear)));
+    m_viewDataUpdater.setSearchMatches(std::move(dates));
+
+    const auto years = m_tagValueIndex->years(tag);
+    if (years.empty()) {
+        layout->setPreviewString(
+            "Tag values", "Select a tag with values, e.g. `* weight (72.4)` or `* sleep: 7.5`.");
+        return;
+    }
+
+    // the years of the monthly chart share a scale so they can be compared
+    const auto scaleOf = [](const std::vector<TagValueIndex::Bucket> &buckets) {
+        auto low = std::numeric_limits<double>::max();
+        auto high = std::numeric_limits<double>::lowest();
+        for (const auto &bucket : buckets) {
+            if (bucket.value) {
+                low = std::min(low, *bucket.value);
+                high = std::max(high, *bucket.value);
+            }
+        }
+        return std::pair{low, high};
+    };
+    const auto lastYear = years.back();
+    const auto firstYear =
+        std::max(years.front(), lastYear - std::chrono::years{kMaxChartedYears - 1});
+    const auto months = m_tagValueIndex->aggregate(tag, Aggregation::kAverage, Period::kMonth,
+                                                   firstYear, lastYear);
+    const auto [monthLow, monthHigh] = scaleOf(months);
+    auto preview = fmt::format("# Monthly average, {:g} to {:g}\n", monthLow, monthHigh);
+    for (std::size_t i = 0; i < months.size(); i += kMonthsPerYear) {
+        preview += fmt::format(
+            "- {} {}\n", static_cast<int>(months[i].begin.year()),
+            TagValueIndex::makeSparkline(std::span{months}.subspan(i, kMonthsPerYear), monthLow,
+                                         monthHigh));
+    }
+
+    const auto weeks = m_tagValueIndex->aggregate(tag, Aggregation::kAverage, Period::kWeek,
+                                                  m_config.currentYear, m_config.currentYear);
+    const auto [weekLow, weekHigh] = scaleOf(weeks);
+    preview += fmt::format("\n# Weekly average in {}\n- {}\n\n# Per year\n",
+                           static_cast<int>(m_config.currentYear),
+                           TagValueIndex::makeSparkline(weeks, weekLow, weekHigh));
 
-void App::handleFocusedSectionChange() { m_viewDataUpdater.handleFocusedSectionChange(); }
+    const auto perYear = [&](Aggregation aggregation) {
+        return m_tagValueIndex->aggregate(tag, aggregation, Period::kYear, firstYear, lastYear);
+    };
+    const auto counts = perYear(Aggregation::kCount);
+    const auto sums = perYear(Aggregation::kSum);
+    const auto averages = perYear(Aggregation::kAverage);
+    const auto mins = perYear(Aggregation::kMin);
+    const auto maxes = perYear(Aggregation::kMax);
+    for (std::size_t i = 0; i < counts.size(); i++) {
+        if (not sums[i].value) {
+            continue;
+        }
+        preview += fmt::format("- {}: {:g} values, sum {:g}, average {:g}, min {:g}, max {:g}\n",
+                               static_cast<int>(counts[i].begin.year()), *counts[i].value,
+                               *sums[i].value, *averages[i].value, *mins[i].value,
+                               *maxes[i].value);
+    }
+    layout->setPreviewString(fmt::format("Values of {}", tag), preview);
+}
+
+void App::buildIndexes() {
+    if (m_indexer) {
+        m_indexer->build(m_repo);
+    }
+}
 
 void App::handleUiStarted() {
     const auto paswordReceivedFunc = [this](const auto &input, const auto &logRepoFactory,
@@ -408,8 +825,9 @@ void App::handleUiStarted() {
         m_repo = logRepoFactory(password);
         m_scratchpadRepo = scratchpadRepoFactory(password);
         m_editor = editorFactory(password);
-        m_data = AnnualLogData::collect(m_repo, m_config.currentYear, m_config.skipFirstLine);
-        m_view->getAnnualViewLayout()->setDatesWithLogs(&m_data.datesWithLogs);
+        m_years = makeAnnualLogDataCache(m_repo, m_metadataIndex, m_config);
+        buildIndexes();
+        showDataOfYear(m_config.currentYear);
         m_view->getAnnualViewLayout()->setEventDates(&m_config.events);
         updateDataAndViewAfterLogChange(m_view->getAnnualViewLayout()->getFocusedDate());
         m_view->getPopUpView().show(PopUpViewBase::None{});
@@ -419,13 +837,19 @@ void App::handleUiStarted() {
         // TODO: move from lambdas to a member function
         m_view->getPopUpView().show(PopUpViewBase::Loading{"Pulling from remote..."});
         m_gitRepo->pull([this](std::expected<void, std::exception_ptr> result) {
-            m_view->post([this, result = std::move(result)]() {
+            m_view->post("task:PullDone", [this, result = std::move(result)]() {
                 if (!result.has_value()) {
                     m_view->getPopUpView().show(PopUpViewBase::Ok{fmt::format(
                         "Error pulling from remote:\n{}", exceptionPtrToString(result.error()))});
                 } else {
-                    m_data = AnnualLogData::collect(m_repo, m_config.currentYear,
-                                                    m_config.skipFirstLine);
+                    // any year might have changed
+                    m_repo->invalidateAll();
+                    m_years->clear();
+                    if (m_indexer) {
+                        m_indexer->clear();
+                    }
+                    buildIndexes();
+                    showDataOfYear(m_config.currentYear);
                     updateDataAndViewAfterLogChange(
                         m_view->getAnnualViewLayout()->getFocusedDate());
                     m_view->getPopUpView().show(PopUpViewBase::None{});
@@ -434,6 +858,16 @@ void App::handleUiStarted() {
         });
     };
 
+    // a year collected in the background starts the preload once it is done
+    if (m_years && m_config.preloadYears > 0 && not m_collectingYear) {
+        // the first frame is shown by now, the neighbouring years are collected in the background
+        m_years->preload(m_config.currentYear, m_config.preloadYears);
+    }
+    if (m_repo) {
+        // encrypted logs are indexed once the password is known
+        buildIndexes();
+    }
+
     if (m_askForPassword) {
         auto aLogRepoFactory = std::move(m_askForPassword->logRepoFactory);
         auto aScratchpadRepoFactory = std::move(m_askForPassword->scratchpadRepoFactory);
@@ -451,7 +885,7 @@ void App::handleUiStarted() {
                 // if invoked directly, it causes floating window to not event show up,
                 // this is probably because messing with the active chiled from inside the callback
                 // execution causes issues
-                m_view->post([this, pullFromRemoteFunc]() {
+                m_view->post("task:Pull", [this, pullFromRemoteFunc]() {
                     if (m_gitRepo) {
                         pullFromRemoteFunc();
                     }
@@ -459,13 +893,15 @@ void App::handleUiStarted() {
             }});
 
         // not sure why this is needed, otherwise it renderes popup only after first input.
-        m_view->post(ftxui::Event::Custom);
+        m_view->post("task:Redraw", ftxui::Event::Custom);
     } else if (m_gitRepo) {
         pullFromRemoteFunc();
     }
 }
 
 void App::quit() {
+    // edits only touch the in memory overlay of the index, it is written once on the way out
+    saveMetadataIndex();
     if (!m_gitRepo) {
         m_view->stop();
         return;
@@ -479,19 +915,19 @@ void App::quit() {
                     if (pushResult.has_value()) {
                         m_view->stop();
                     } else {
-                        m_view->post([this, pushResult = std::move(pushResult)]() {
+                        m_view->post("task:PushFailed", [this, error = pushResult.error()]() {
                             m_view->getPopUpView().show(PopUpViewBase::Ok{
                                 fmt::format("Error pushing to remote:\n{}",
-                                            exceptionPtrToString(pushResult.error())),
+                                            exceptionPtrToString(error)),
                                 [this](const auto &) { m_view->stop(); }});
                         });
                     }
                 });
             } else {
-                m_view->post([this]() { m_view->stop(); });
+                m_view->post("task:Stop", [this]() { m_view->stop(); });
             }
         } else {
-            m_view->post([this, result = std::move(result)]() {
+            m_view->post("task:CommitFailed", [this, result = std::move(result)]() {
                 m_view->getPopUpView().show(
                     PopUpViewBase::Ok{fmt::format("Error committing to remote:\n{}",
                                                   exceptionPtrToString(result.error())),
@@ -501,9 +937,20 @@ void App::quit() {
     });
 };
 
+void App::saveMetadataIndex() {
+    if (not m_metadataIndex) {
+        return;
+    }
+    try {
+        m_metadataIndex->save();
+    } catch (const std::runtime_error &) {
+        // the index is only a cache, failing to persist it costs a reparse on next startup
+    }
+}
+
 void App::deleteFocusedLog() {
     auto date = m_view->getAnnualViewLayout()->getFocusedDate();
-    if (m_data.datesWithLogs.contains(date::monthDay(date))) {
+    if (m_data->datesWithLogs.contains(date::monthDay(date))) {
         m_view->getPopUpView().show(PopUpViewBase::YesNo{
             "Are you sure you want to delete a log file?", [date, this](const auto &result) {
                 if (std::holds_alternative<PopUpViewBase::Result::Yes>(result)) {
@@ -516,10 +963,91 @@ void App::deleteFocusedLog() {
 
 void App::handleDisplayedYearChange(int diff) {
     m_config.currentYear = std::chrono::year{static_cast<int>(m_config.currentYear) + diff};
-    m_data = AnnualLogData::collect(m_repo, m_config.currentYear, m_config.skipFirstLine);
+    showDataOfYear(m_config.currentYear);
     m_view->getAnnualViewLayout()->showCalendarForYear(m_config.currentYear);
     m_view->getAnnualViewLayout()->setHighlightedDates(nullptr);
-    updateDataAndViewAfterLogChange(m_view->getAnnualViewLayout()->getFocusedDate());
+    updateViewAfterDataChange(m_view->getAnnualViewLayout()->getFocusedDate());
+}
+
+void App::showDataOfYear(std::chrono::year year) {
+    // a year that is still collected is abandoned, it is collected again once displayed
+    ++m_collectGeneration;
+    m_collectingYear.reset();
+    m_changedWhileCollecting.clear();
+
+    const auto collectLater = m_config.progressiveCollect && not m_years->contains(year);
+    // resident years are only swapped in, the rest is collected here
+    m_data = collectLater ? std::make_shared<AnnualLogData>() : m_years->get(year);
+    m_view->getAnnualViewLayout()->setDatesWithLogs(&m_data->datesWithLogs);
+    m_viewDataUpdater.setData(*m_data);
+    if (collectLater) {
+        collectInBackground(year);
+    } else if (m_config.preloadYears > 0) {
+        m_years->preload(year, m_config.preloadYears);
+    }
+}
+
+void App::collectInBackground(std::chrono::year year) {
+    m_collectingYear = year;
+    const auto generation = m_collectGeneration.load();
+    const auto firstMonth = m_view->getAnnualViewLayout()->getFocusedDate().month();
+    m_collector.post([this, repo = m_repo, index = m_metadataIndex, year, firstMonth, generation,
+                      skipFirstLine = m_config.skipFirstLine,
+                      workers = m_config.collectWorkers]() {
+        try {
+            AnnualLogData::collectByMonth(
+                repo, year, firstMonth, skipFirstLine, workers, index,
+                [this, generation](std::chrono::month month, AnnualLogData data) {
+                    if (m_collectGeneration != generation) {
+                        return false;
+                    }
+                    m_view->post("task:MonthCollected",
+                                 [this, generation, month,
+                                  data = std::make_shared<AnnualLogData>(std::move(data))]() {
+                                     applyCollectedMonth(generation, month, *data);
+                                 });
+                    return true;
+                });
+            m_view->post("task:YearCollected",
+                         [this, generation, year]() { finishCollecting(generation, year); });
+        } catch (const std::exception &) {
+            // rethrown on the ui thread, the same as if the year was collected there
+            m_view->post("task:CollectFailed",
+                         [this, generation, error = std::current_exception()]() {
+                             if (generation == m_collectGeneration) {
+                                 std::rethrow_exception(error);
+                             }
+                         });
+        }
+    });
+}
+
+void App::applyCollectedMonth(std::uint64_t generation, std::chrono::month month,
+                              const AnnualLogData &data) {
+    if (generation != m_collectGeneration) {
+        return;
+    }
+    m_data->merge(data);
+    // merging only adds, logs that changed since their month was read are collected again
+    for (const auto &date : m_changedWhileCollecting) {
+        if (date.month() == month) {
+            m_data->collect(m_repo, date, m_config.skipFirstLine, m_metadataIndex);
+        }
+    }
+    m_viewDataUpdater.updateViewAfterDataChange();
+}
+
+void App::finishCollecting(std::uint64_t generation, std::chrono::year year) {
+    if (generation != m_collectGeneration) {
+        return;
+    }
+    m_collectingYear.reset();
+    m_changedWhileCollecting.clear();
+    m_years->put(year, m_data);
+    saveMetadataIndex();
+    if (m_config.preloadYears > 0) {
+        m_years->preload(year, m_config.preloadYears);
+    }
 }
 
 bool hasSuffix(const std::string &str, const std::string &suffix) {
@@ -628,6 +1156,7 @@ void App::handleOpenLogFile() {
     assert(log);
     m_view->withRestoredIO([this, &log, date]() {
         m_editor->openLog(*log);
+        m_repo->invalidate(date);
 
         // check that after editing still exists
         log = m_repo->read(date);
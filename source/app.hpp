@@ -2,16 +2,29 @@
 
 #include "editor/editor_base.hpp"
 #include "log/annual_log_data.hpp"
+#include "log/annual_log_data_cache.hpp"
+#include "log/log_indexer.hpp"
 #include "log/log_repository_base.hpp"
+#include "log/tag_query.hpp"
+#include "log/tag_value_index.hpp"
+#include "log/task_index.hpp"
+#include "log/text_search_index.hpp"
 #include "utils/async_git_repo.hpp"
+#include "utils/debouncer.hpp"
+#include "utils/task_executor.hpp"
 #include "view/annual_view_layout_base.hpp"
 #include "view/input_handler.hpp"
 #include "view/view.hpp"
 
+#include <atomic>
 #include <cassert>
 #include <chrono>
 #include <cstddef>
+#include <cstdint>
+#include <filesystem>
 #include <memory>
+#include <optional>
+#include <vector>
 
 namespace caps_log {
 
@@ -25,21 +38,49 @@ const std::string kLogBaseTemplate{"# %d. %m. %y."};
  */
 class ViewDataUpdater final {
     std::shared_ptr<view::AnnualViewLayoutBase> m_view;
-    const log::AnnualLogData &m_data; // NOLINT(cppcoreguidelines-avoid-const-or-ref-data-members)
+    const log::AnnualLogData *m_data;
     std::map<std::string, view::MenuItems> m_tagMenuItemsPerSection;
+    // while a tag query is set its matches are highlighted instead of the menu selection
+    std::string m_query;
+    utils::date::Dates m_queryMatches;
+    // same for the results of a text search in the displayed year
+    std::optional<utils::date::Dates> m_searchMatches;
     static constexpr auto kSelectNoneMenuEntryText = "<select none>";
 
   public:
     explicit ViewDataUpdater(std::shared_ptr<view::AnnualViewLayoutBase> view,
                              const log::AnnualLogData &data);
 
+    /**
+     * Points the updater to the data of another year, the view is updated by the next
+     * `updateViewAfterDataChange`.
+     */
+    void setData(const log::AnnualLogData &data) { m_data = &data; }
+
     void handleFocusedTagChange();
     void handleFocusedSectionChange();
+    /**
+     * Compiles the query and highlights the dates that match it, an empty query goes back to
+     * highlighting the menu selection. If the query is not valid the last valid one stays
+     * highlighted.
+     */
+    void handleQueryChange(const std::string &query);
+    /**
+     * Highlights the results of a text search, no value goes back to highlighting the menu
+     * selection.
+     */
+    void setSearchMatches(std::optional<utils::date::Dates> matches);
     void updateViewAfterDataChange(const std::string &previewTitle,
                                    const std::string &previewString);
+    /**
+     * Same as above but leaves the preview as it is.
+     */
+    void updateViewAfterDataChange();
 
   private:
     void updateTagMenuItemsPerSection();
+    void highlightMenuSelection(const utils::date::Dates *dates);
+    void highlightQueryMatches(const log::TagQuery &query);
 
     view::MenuItems makeTagMenuItems(const std::string &section);
     view::MenuItems makeSectionMenuItems();
@@ -50,6 +91,26 @@ struct AppConfig {
     bool skipFirstLine;
     std::chrono::year currentYear;
     view::CalendarEvents events;
+    // number of threads used to collect a year of logs, 0 means one per hardware thread
+    unsigned collectWorkers = 1;
+    // where the log metadata index is persisted, no index is used if not set
+    std::optional<std::filesystem::path> metadataIndexPath;
+    // years before and after the displayed one that are collected in the background
+    unsigned preloadYears = 0;
+    // memory budget in bytes for the data of years other than the displayed one
+    std::size_t yearCacheSize = 0;
+    // whether the words of all logs are indexed in the background for the text search
+    bool textSearch = false;
+    // whether the open tasks of all logs are indexed in the background
+    bool taskIndex = false;
+    // whether the values of the tags of all logs are indexed in the background
+    bool tagValues = false;
+    // whether a year that is not resident is collected in the background a month at a time while
+    // the ui is already shown, rather than before the year is displayed
+    bool progressiveCollect = false;
+    // how long the focused date has to stay put before its log is read for the preview, 0 reads
+    // it right away
+    std::chrono::milliseconds previewDebounce{0};
 };
 
 /**
@@ -61,7 +122,18 @@ class App final : public view::InputHandlerBase {
     std::shared_ptr<log::LogRepositoryBase> m_repo{nullptr};
     std::shared_ptr<log::ScratchpadRepositoryBase> m_scratchpadRepo{nullptr};
     std::shared_ptr<editor::EditorBase> m_editor;
-    log::AnnualLogData m_data;
+    std::shared_ptr<log::LogMetadataIndex> m_metadataIndex;
+    std::unique_ptr<log::AnnualLogDataCache> m_years;
+    std::shared_ptr<log::AnnualLogData> m_data;
+    std::shared_ptr<log::TextSearchIndex> m_textIndex;
+    std::string m_searchText;
+    std::shared_ptr<log::TaskIndex> m_taskIndex;
+    std::shared_ptr<log::TagValueIndex> m_tagValueIndex;
+    // fills the enabled indexes above, null if none is enabled
+    std::unique_ptr<log::LogIndexer> m_indexer;
+    // what the preview shows instead of the focused log, the days it is about are highlighted
+    enum class PreviewMode : std::uint8_t { kFocusedLog, kOpenTasks, kTagValues };
+    PreviewMode m_previewMode = PreviewMode::kFocusedLog;
     std::optional<utils::AsyncGitRepo> m_gitRepo;
     ViewDataUpdater m_viewDataUpdater;
 
@@ -74,6 +146,20 @@ class App final : public view::InputHandlerBase {
 
     std::optional<AskForPassword> m_askForPassword;
 
+    // the displayed year while it is collected in the background, a collection of a year that is
+    // no longer displayed is abandoned by bumping the generation. The collector is declared after
+    // everything its worker uses, so the worker is joined before they are destroyed
+    std::optional<std::chrono::year> m_collectingYear;
+    std::vector<std::chrono::year_month_day> m_changedWhileCollecting;
+    std::atomic<std::uint64_t> m_collectGeneration = 0;
+    utils::ThreadedTaskExecutor m_collector;
+
+    // reads the log of the focused date off the UI thread once the focus settles, declared last
+    // so its worker is joined before any other member is destroyed. Loads that finish after the
+    // preview was replaced by something else are recognised by an outdated generation
+    std::uint64_t m_previewGeneration = 0;
+    std::unique_ptr<utils::Debouncer> m_previewLoader;
+
   public:
     /**
      * Constructs the App with the given view, log repository, scratchpad repository, editor,
@@ -104,7 +190,10 @@ class App final : public view::InputHandlerBase {
     App(App &&) = delete;
     App &operator=(const App &) = delete;
     App &operator=(App &&) = delete;
-    ~App() override { quit(); }
+    ~App() override {
+        ++m_collectGeneration;
+        quit();
+    }
 
     void run();
     bool handleInputEvent(const view::UIEvent &event) override;
@@ -112,8 +201,12 @@ class App final : public view::InputHandlerBase {
   private:
     bool handleRootEvent(const std::string &input);
     void handleFocusedDateChange();
+    void showPreviewOf(const std::chrono::year_month_day &date);
+    void cancelPreviewLoad();
     void handleFocusedTagChange();
     void handleFocusedSectionChange();
+    void handleQueryChange(const std::string &query);
+    void handleSearchChange(const std::string &text);
     void handleUiStarted();
     void handleDisplayedYearChange(int diff);
     void handleOpenScratchpad(std::string name);
@@ -123,6 +216,20 @@ class App final : public view::InputHandlerBase {
     void handleSwitchLayout();
 
     void updateDataAndViewAfterLogChange(const std::chrono::year_month_day &dateOfChangedLog);
+    void updateViewAfterDataChange(const std::chrono::year_month_day &dateOfChangedLog);
+    void showDataOfYear(std::chrono::year year);
+    void collectInBackground(std::chrono::year year);
+    void applyCollectedMonth(std::uint64_t generation, std::chrono::month month,
+                             const log::AnnualLogData &data);
+    void finishCollecting(std::uint64_t generation, std::chrono::year year);
+    void showSearchResults();
+    void handleTogglePreviewMode(PreviewMode mode);
+    void showPreviewMode();
+    void showOpenTasks();
+    void showTagValues();
+    void updateIndexesAfterLogChange(const std::chrono::year_month_day &dateOfChangedLog);
+    void buildIndexes();
+    void saveMetadataIndex();
     void deleteFocusedLog();
     void quit();
 };
@@ -4,16 +4,22 @@
 #include "editor/editor_base.hpp"
 #include "log/log_repository_crypto_applier.hpp"
 #include "utils/git_repo.hpp"
+#include "utils/phase_profiler.hpp"
+#include <algorithm>
 #include <app.hpp>
 #include <boost/property_tree/ptree.hpp>
 #include <config.hpp>
 #include <filesystem>
+#include <fstream>
 #include <ftxui/component/component.hpp>
 #include <ftxui/component/event.hpp>
 #include <ftxui/screen/terminal.hpp>
 #include <functional>
 #include <iostream>
+#include <log/caching_log_repository.hpp>
 #include <log/local_log_repository.hpp>
+#include <log/log_grep.hpp>
+#include <regex>
 #include <string>
 #include <utility>
 #include <view/view.hpp>
@@ -30,44 +36,79 @@ class CapsLog {
         std::vector<std::string> cliArgs;
         EditorFactory editorFactory = defaultEditorFactory;
         std::function<ftxui::Dimensions()> terminalSizeProvider = defaultScreenSizeProvider;
+        // the displayed year is collected in the background while the ui is running, turned off
+        // when rendering without running the ui, as the collected months would never be shown
+        bool progressiveCollect = true;
     };
 
     struct Task {
-        enum class Type : char { kRunAppplication, kApplyCrypto, kInvalidCliArgs, kInvalidConfig };
+        enum class Type : char {
+            kRunAppplication,
+            kApplyCrypto,
+            kGrep,
+            kProfileStartup,
+            kInvalidCliArgs,
+            kInvalidConfig
+        };
         Type type;
         std::function<void()> action;
     };
 
-    CapsLog(const Context &context) : m_config(context.cliArgs) {
+    // the phases of the startup are only measured when profiling it, the flag is looked up in the
+    // raw arguments as parsing them is the first phase
+    CapsLog(const Context &context)
+        : m_startupProfiler{std::ranges::find(context.cliArgs, "--profile-startup") !=
+                            context.cliArgs.end()},
+          m_config(m_startupProfiler.measure(
+              "parse configuration", [&context] { return Configuration{context.cliArgs}; })) {
         m_config.verify();
 
         if (!m_config.shouldRunApplication()) {
             return;
         }
 
-        m_view = std::make_shared<view::View>(m_config.getViewConfig(), context.today,
-                                              context.terminalSizeProvider);
+        m_view = m_startupProfiler.measure("create view", [this, &context] {
+            return std::make_shared<view::View>(m_config.getViewConfig(), context.today,
+                                                context.terminalSizeProvider);
+        });
 
+        // a profiled app is never given the repository, so it can not commit or push on exit
         auto gitRepo = [this] -> std::optional<utils::GitRepo> {
-            if (m_config.getGitRepoConfig()) {
-                return std::make_optional<utils::GitRepo>(*m_config.getGitRepoConfig());
+            if (not m_config.getGitRepoConfig() ||
+                (m_config.shouldProfileStartup() && not m_config.shouldProfileGitPull())) {
+                return std::nullopt;
             }
-            return std::nullopt;
+            return m_startupProfiler.measure("open git repository", [this] {
+                return std::make_optional<utils::GitRepo>(*m_config.getGitRepoConfig());
+            });
         }();
+        if (gitRepo && m_config.shouldProfileStartup()) {
+            // otherwise done in the background behind a loading pop up once the ui is shown
+            m_startupProfiler.measure("git pull", [&gitRepo] { gitRepo->pull(); });
+            gitRepo = std::nullopt;
+        }
 
         // TODO: unify hanling of injected todays date
         auto conf = m_config.getAppConfig();
         conf.currentYear = context.today.year();
+        // the profiled first frame is rendered right after the app is constructed, it has to show
+        // the collected year rather than an empty calendar
+        conf.progressiveCollect = context.progressiveCollect && not m_config.shouldProfileStartup();
 
-        const auto shouldAskForPassword =
-            LogRepositoryCryptoApplier::isEncrypted(m_config.getLogDirPath()) &&
-            !m_config.isPasswordProvided();
+        const auto isEncrypted = LogRepositoryCryptoApplier::isEncrypted(m_config.getLogDirPath());
+        const auto shouldAskForPassword = isEncrypted && !m_config.isPasswordProvided();
+        if (shouldAskForPassword && m_config.shouldProfileStartup()) {
+            throw ConfigParsingException{
+                "Password must be provided to profile the startup with encrypted logs!"};
+        }
+
+        // the index stores section and tag names in plain text
+        if (isEncrypted) {
+            conf.metadataIndexPath = std::nullopt;
+        }
 
         if (shouldAskForPassword) {
-            auto logRepoFactory = [pathProvider = m_config.getLogFilePathProvider(),
-                                   password = m_config.getPassword()](const std::string &pwd) {
-                return std::make_shared<log::LocalLogRepository>(pathProvider, pwd);
-            };
+            auto logRepoFactory = [this](const std::string &pwd) { return makeLogRepository(pwd); };
             auto scratchpadRepoFactory =
                 [scratchpadDirPath = m_config.getScratchpadDirPath()](const std::string &pwd) {
                     return std::make_shared<log::LocalScratchpadRepository>(scratchpadDirPath, pwd);
@@ -81,20 +122,28 @@ class CapsLog {
                                           std::move(scratchpadRepoFactory),
                                           std::move(editorFactory), std::move(gitRepo), conf);
         } else {
-            auto logRepo = std::make_shared<log::LocalLogRepository>(
-                m_config.getLogFilePathProvider(), m_config.getPassword());
+            auto logRepo = m_startupProfiler.measure("open log repository", [this] {
+                return makeLogRepository(m_config.getPassword());
+            });
             auto scratchpadRepo = std::make_shared<log::LocalScratchpadRepository>(
                 m_config.getScratchpadDirPath(), m_config.getPassword());
             auto editor =
                 context.editorFactory(m_config.getLogFilePathProvider(),
                                       m_config.getScratchpadDirPath(), m_config.getPassword());
 
-            m_app = std::make_shared<App>(m_view, logRepo, scratchpadRepo, editor,
-                                          std::move(gitRepo), conf);
+            // collects the data of the displayed year, unless it is collected progressively once
+            // the ui is shown
+            m_app = m_startupProfiler.measure("construct app", [&] {
+                return std::make_shared<App>(m_view, logRepo, scratchpadRepo, editor,
+                                             std::move(gitRepo), conf);
+            });
         }
     }
 
     [[nodiscard]] Task getTask() {
+        if (m_config.shouldProfileStartup()) {
+            return Task{Task::Type::kProfileStartup, [this]() { profileStartup(); }};
+        }
         if (m_config.shouldRunApplication()) {
             return Task{Task::Type::kRunAppplication, [this]() { run(); }};
         }
@@ -102,6 +151,9 @@ class CapsLog {
             return Task{Task::Type::kApplyCrypto,
                         [this]() { applyCrypto(*m_config.getCryptoApplicationType()); }};
         }
+        if (m_config.getGrepPattern()) {
+            return Task{Task::Type::kGrep, [this]() { grep(*m_config.getGrepPattern()); }};
+        }
         return Task{Task::Type::kInvalidCliArgs, []() {}};
     }
 
@@ -118,18 +170,75 @@ class CapsLog {
     void run() {
         if (m_app) {
             m_app->run();
+            if (const auto &perfLogPath = m_config.getPerfLogPath()) {
+                writePerfLog(*perfLogPath);
+            }
         } else {
             throw std::runtime_error("Application is not initialized.");
         }
     }
 
+    [[nodiscard]] std::shared_ptr<log::LogRepositoryBase>
+    makeLogRepository(const std::string &password) const {
+        auto repo =
+            std::make_shared<log::LocalLogRepository>(m_config.getLogFilePathProvider(), password);
+        if (m_config.getLogCacheSize() == 0) {
+            return repo;
+        }
+        return std::make_shared<log::CachingLogRepository>(std::move(repo),
+                                                           m_config.getLogCacheSize());
+    }
+
     void applyCrypto(Crypto crypto) {
+        // the index of plain text logs must not outlive their encryption, wherever it was written
+        if (crypto == Crypto::Encrypt) {
+            for (const auto &indexPath : m_config.getPossibleMetadataIndexPaths()) {
+                std::filesystem::remove(indexPath);
+            }
+        }
         caps_log::LogRepositoryCryptoApplier::apply(
             m_config.getPassword(), m_config.getLogDirPath(),
             caps_log::Configuration::kDefaultScratchpadFolderName, m_config.getLogFilenameFormat(),
             crypto);
     }
 
+    void profileStartup() {
+        // rendered off screen, the terminal is left untouched
+        m_startupProfiler.measure("render first frame", [this] { return m_view->render(); });
+        std::cout << m_startupProfiler.format() << std::flush;
+    }
+
+    void writePerfLog(const std::string &path) const {
+        std::ofstream file{path};
+        if (not file) {
+            throw std::runtime_error{fmt::format("Could not write the perf log to: {}", path)};
+        }
+        file << m_view->getLatencyStats().format();
+    }
+
+    void grep(const std::string &pattern) const {
+        std::regex regex;
+        try {
+            regex = std::regex{pattern};
+        } catch (const std::regex_error &error) {
+            throw ConfigParsingException{
+                fmt::format("Invalid --grep pattern \"{}\": {}", pattern, error.what())};
+        }
+        if (LogRepositoryCryptoApplier::isEncrypted(m_config.getLogDirPath()) &&
+            not m_config.isPasswordProvided()) {
+            throw ConfigParsingException{"Password must be provided to search encrypted logs!"};
+        }
+
+        // encrypted logs are only decrypted in memory, each log is read once so no cache is used
+        const log::LocalLogRepository repo{m_config.getLogFilePathProvider(),
+                                           m_config.getPassword()};
+        log::grepLogs(repo, regex, m_config.getGrepConfig(), [](const log::GrepMatch &match) {
+            std::cout << utils::date::formatToString(match.date, "%Y-%m-%d") << ':' << match.line
+                      << '\n';
+        });
+        std::cout << std::flush;
+    }
+
     /**
      * If the curret log dir has a structure like
      * /
@@ -149,34 +258,10 @@ class CapsLog {
         const caps_log::log::LocalFSLogFilePathProvider &pathProvider) {
 
         const auto logDirPath = pathProvider.getLogDirPath();
-        const auto logFilenameFormat = pathProvider.getLogFilenameFormat();
-
-        const auto parseDate =
-            [logFilenameFormat](
-                const std::filesystem::path &path) -> std::optional<std::chrono::year_month_day> {
-            const auto filenameStr = path.filename().string();
-            std::tm dateTime = {};
-            std::istringstream iss{filenameStr};
-            if (!(iss >> std::get_time(&dateTime, logFilenameFormat.c_str()))) {
-                return std::nullopt;
-            }
-
-            std::string remaining;
-            std::getline(iss, remaining);
-            if (!remaining.empty()) {
-                return std::nullopt;
-            }
-            // The tm_year is years since 1900, so we need to add 1900 to it
-            static constexpr auto kTmYearOffset = 1900;
-            return std::chrono::year_month_day{
-                std::chrono::year{dateTime.tm_year + kTmYearOffset},
-                std::chrono::month{static_cast<unsigned int>(dateTime.tm_mon + 1)},
-                std::chrono::day{static_cast<unsigned int>(dateTime.tm_mday)}};
-        };
 
         for (const auto &entry : std::filesystem::directory_iterator{logDirPath}) {
-            const auto date = parseDate(entry.path());
-            if (!date.has_value()) {
+            const auto date = pathProvider.parseDate(entry.path());
+            if (!date.has_value() || !date->ok()) {
                 continue;
             }
             const auto newPath = pathProvider.path(date.value());
@@ -192,6 +277,8 @@ class CapsLog {
         }
     }
 
+    // declared first, it measures the construction of the configuration
+    utils::PhaseProfiler m_startupProfiler;
     Configuration m_config;
     std::shared_ptr<view::View> m_view;
     std::shared_ptr<App> m_app;
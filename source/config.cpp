@@ -8,6 +8,8 @@
 #include <boost/property_tree/ini_parser.hpp>
 #include <boost/property_tree/ptree.hpp>
 #include <cctype>
+#include <charconv>
+#include <chrono>
 #include <filesystem>
 #include <fmt/format.h>
 #include <ftxui/screen/color.hpp>
@@ -15,7 +17,9 @@
 #include <optional>
 #include <string>
 #include <string_view>
+#include <tuple>
 #include <unordered_map>
+#include <utility>
 #include <vector>
 
 namespace caps_log {
@@ -549,6 +553,31 @@ bool isParentOf(const std::filesystem::path &parent, const std::filesystem::path
     return parentIter == nParent.end() && childIter != nChild.end();
 }
 
+/**
+ * Parses `A..B`, `A..`, `..B` or `A` into inclusive bounds.
+ */
+std::pair<std::optional<std::chrono::year>, std::optional<std::chrono::year>>
+parseYearRange(std::string_view range) {
+    const auto parseYear = [range](std::string_view text) -> std::optional<std::chrono::year> {
+        if (text.empty()) {
+            return std::nullopt;
+        }
+        int year = 0;
+        const auto [end, error] = std::from_chars(text.data(), text.data() + text.size(), year);
+        if (error != std::errc{} || end != text.data() + text.size()) {
+            throw ConfigParsingException{"Invalid year range: " + std::string{range}};
+        }
+        return std::chrono::year{year};
+    };
+
+    const auto separator = range.find("..");
+    if (separator == std::string_view::npos) {
+        const auto year = parseYear(range);
+        return {year, year};
+    }
+    return {parseYear(range.substr(0, separator)), parseYear(range.substr(separator + 2))};
+}
+
 variables_map parseCLIOptions(const std::vector<std::string> &argv) {
     namespace po = boost::program_options;
 
@@ -563,7 +592,12 @@ variables_map parseCLIOptions(const std::vector<std::string> &argv) {
       ("first-line-section", "override the default behaviour of ignoring sections (lines starting with `#`) in the first line of a log entry file")
       ("password", po::value<std::string>(), "password for encrypted log repositories or to be used with --encrypt/--decrypt")
       ("encrypt", "apply encryption to all logs in log dir path (needs --password)")
-      ("decrypt", "apply decryption to all logs in log dir path (needs --password)");
+      ("decrypt", "apply decryption to all logs in log dir path (needs --password)")
+      ("grep", po::value<std::string>(), "print the lines of all logs matching a regular expression as `date:line` and exit")
+      ("year-range", po::value<std::string>(), "only search the years A..B with --grep, either bound can be left out")
+      ("perf-log", po::value<std::string>(), "write the latencies of the ui events, tasks and renders to a file on exit")
+      ("profile-startup", "time the phases of the startup up to the first frame, rendered off screen, print them and exit")
+      ("profile-git-pull", "also time a pull of the git log repository with --profile-startup, which fetches and merges from its remote");
     // clang-format on
 
     std::vector<const char *> args;
@@ -596,6 +630,11 @@ const std::string Configuration::kDefaultScratchpadFolderName = "scratchpads";
 const std::string Configuration::kDefaultLogFilenameFormat = "d%Y_%m_%d.md";
 const bool Configuration::kDefaultSundayStart = false;
 const bool Configuration::kDefaultAcceptSectionsOnFirstLine = false;
+const bool Configuration::kDefaultMetadataIndex = true;
+const std::string Configuration::kDefaultMetadataIndexFileName = ".caps-log-index";
+const bool Configuration::kDefaultTextSearch = true;
+const bool Configuration::kDefaultTaskIndex = true;
+const bool Configuration::kDefaultTagValues = true;
 
 std::function<std::string(const std::filesystem::path &)> Configuration::makeDefaultReadFileFunc() {
     return [](const std::filesystem::path &path) {
@@ -696,8 +735,23 @@ void Configuration::applyDefaults() {
         };
     m_password = "";
     m_cryptoApplicationType = std::nullopt;
+    m_grepPattern = std::nullopt;
+    m_grepConfig = log::GrepConfig{};
+    m_perfLogPath = std::nullopt;
+    m_profileStartup = false;
+    m_profileGitPull = false;
     m_gitRepoConfig = std::nullopt;
     m_acceptSectionsOnFirstLine = Configuration::kDefaultAcceptSectionsOnFirstLine;
+    m_collectWorkers = Configuration::kDefaultCollectWorkers;
+    m_metadataIndex = Configuration::kDefaultMetadataIndex;
+    m_metadataIndexPath = "";
+    m_logCacheSize = Configuration::kDefaultLogCacheSize;
+    m_preloadYears = Configuration::kDefaultPreloadYears;
+    m_yearCacheSize = Configuration::kDefaultYearCacheSize;
+    m_textSearch = Configuration::kDefaultTextSearch;
+    m_taskIndex = Configuration::kDefaultTaskIndex;
+    m_tagValues = Configuration::kDefaultTagValues;
+    m_previewDebounceMs = Configuration::kDefaultPreviewDebounceMs;
     m_logDirPath = expandTilde(Configuration::kDefaultLogDirPath);
     m_logFilenameFormat = Configuration::kDefaultLogFilenameFormat;
     m_calendarEvents = view::CalendarEvents{};
@@ -709,14 +763,25 @@ void Configuration::overrideFromConfigFile(const boost::property_tree::ptree &pt
     setIfValue<bool>(ptree, "sunday-start", m_viewConfig.annualViewConfig.sundayStart);
     setIfValue<bool>(ptree, "first-line-section", m_acceptSectionsOnFirstLine);
     setIfValue<std::string>(ptree, "password", m_password);
+    setIfValue<unsigned>(ptree, "collect-workers", m_collectWorkers);
+    setIfValue<bool>(ptree, "metadata-index", m_metadataIndex);
+    setIfValue<std::string>(ptree, "metadata-index-path", m_metadataIndexPath);
+    setIfValue<std::size_t>(ptree, "log-cache-size", m_logCacheSize);
+    setIfValue<unsigned>(ptree, "preload-years", m_preloadYears);
+    setIfValue<std::size_t>(ptree, "year-cache-size", m_yearCacheSize);
+    setIfValue<bool>(ptree, "text-search", m_textSearch);
+    setIfValue<bool>(ptree, "task-index", m_taskIndex);
+    setIfValue<bool>(ptree, "tag-values", m_tagValues);
+    setIfValue<unsigned>(ptree, "preview-debounce-ms", m_previewDebounceMs);
     setIfValue<unsigned>(ptree, "calendar-events.recent-events-window",
                          m_viewConfig.annualViewConfig.recentEventsWindow);
 
     // Parse and update calendar events
     m_calendarEvents = parseCalendarEvents(ptree);
 
-    // sanitize log dir path
+    // sanitize paths
     m_logDirPath = expandTilde(m_logDirPath);
+    m_metadataIndexPath = expandTilde(m_metadataIndexPath);
 
     if (ptree.get_optional<bool>("git.enable-git-log-repo").value_or(false)) {
         utils::GitRepoConfig gitConf;
@@ -729,6 +794,9 @@ void Configuration::overrideFromConfigFile(const boost::property_tree::ptree &pt
         // sanitize paths
         gitConf.sshKeyPath = expandTilde(gitConf.sshKeyPath);
         gitConf.sshPubKeyPath = expandTilde(gitConf.sshPubKeyPath);
+        // left behind if writing a log is interrupted
+        gitConf.ignoredPatterns = {
+            fmt::format("*{}", log::LocalLogRepository::kTemporaryFileExtension)};
 
         m_gitRepoConfig = gitConf;
     }
@@ -772,6 +840,23 @@ void Configuration::overrideFromCommandLine(const boost::program_options::variab
         }
         m_cryptoApplicationType = Crypto::Decrypt;
     }
+
+    if (vmap.contains("grep")) {
+        m_grepPattern = vmap["grep"].as<std::string>();
+    }
+    if (vmap.contains("year-range")) {
+        std::tie(m_grepConfig.firstYear, m_grepConfig.lastYear) =
+            parseYearRange(vmap["year-range"].as<std::string>());
+    }
+    if (vmap.contains("perf-log")) {
+        m_perfLogPath = expandTilde(vmap["perf-log"].as<std::string>());
+    }
+    if (vmap.contains("profile-startup")) {
+        m_profileStartup = true;
+    }
+    if (vmap.contains("profile-git-pull")) {
+        m_profileGitPull = true;
+    }
 }
 
 void Configuration::verify() const {
@@ -785,6 +870,19 @@ void Configuration::verify() const {
         throw ConfigParsingException{
             "Password must be provided when encryption encrypting/decrypting a repository."};
     }
+    if (m_grepPattern.has_value() && m_cryptoApplicationType.has_value()) {
+        throw ConfigParsingException{"--grep can not be combined with --encrypt or --decrypt!"};
+    }
+    if (not m_grepPattern.has_value() && (m_grepConfig.firstYear || m_grepConfig.lastYear)) {
+        throw ConfigParsingException{"--year-range can only be used with --grep!"};
+    }
+    if (m_profileStartup && not shouldRunApplication()) {
+        throw ConfigParsingException{
+            "--profile-startup can not be combined with --grep, --encrypt or --decrypt!"};
+    }
+    if (m_profileGitPull && not m_profileStartup) {
+        throw ConfigParsingException{"--profile-git-pull can only be used with --profile-startup!"};
+    }
     if (m_gitRepoConfig.has_value()) {
         const auto &gitConf = m_gitRepoConfig.value();
         if (gitConf.sshKeyPath.empty()) {
@@ -830,7 +928,7 @@ void Configuration::verify() const {
 }
 
 [[nodiscard]] bool Configuration::shouldRunApplication() const {
-    return not m_cryptoApplicationType.has_value();
+    return not m_cryptoApplicationType.has_value() && not m_grepPattern.has_value();
 }
 
 [[nodiscard]] std::string Configuration::getLogDirPath() const { return m_logDirPath; }
@@ -855,6 +953,49 @@ void Configuration::verify() const {
     return m_cryptoApplicationType;
 }
 
+[[nodiscard]] std::optional<std::filesystem::path> Configuration::getMetadataIndexPath() const {
+    if (!m_metadataIndex) {
+        return std::nullopt;
+    }
+    if (!m_metadataIndexPath.empty()) {
+        return m_metadataIndexPath;
+    }
+    if (m_gitRepoConfig) {
+        return std::nullopt;
+    }
+    return std::filesystem::path{m_logDirPath} / Configuration::kDefaultMetadataIndexFileName;
+}
+
+[[nodiscard]] std::vector<std::filesystem::path>
+Configuration::getPossibleMetadataIndexPaths() const {
+    std::vector<std::filesystem::path> paths{std::filesystem::path{m_logDirPath} /
+                                             Configuration::kDefaultMetadataIndexFileName};
+    if (!m_metadataIndexPath.empty()) {
+        paths.emplace_back(m_metadataIndexPath);
+    }
+    return paths;
+}
+
+[[nodiscard]] std::size_t Configuration::getLogCacheSize() const { return m_logCacheSize; }
+
+[[nodiscard]] const std::optional<std::string> &Configuration::getGrepPattern() const {
+    return m_grepPattern;
+}
+
+[[nodiscard]] bool Configuration::shouldProfileStartup() const { return m_profileStartup; }
+
+[[nodiscard]] bool Configuration::shouldProfileGitPull() const { return m_profileGitPull; }
+
+[[nodiscard]] const std::optional<std::string> &Configuration::getPerfLogPath() const {
+    return m_perfLogPath;
+}
+
+[[nodiscard]] log::GrepConfig Configuration::getGrepConfig() const {
+    auto config = m_grepConfig;
+    config.workers = m_collectWorkers;
+    return config;
+}
+
 [[nodiscard]] std::filesystem::path Configuration::getConfigFilePath() const {
     return m_configFilePath;
 }
@@ -863,7 +1004,19 @@ void Configuration::verify() const {
     return AppConfig{
         // TODO: align
         .skipFirstLine = !m_acceptSectionsOnFirstLine,
+        // set by the caller from today's date
+        .currentYear = std::chrono::year{},
         .events = m_calendarEvents,
+        .collectWorkers = m_collectWorkers,
+        .metadataIndexPath = getMetadataIndexPath(),
+        .preloadYears = m_preloadYears,
+        .yearCacheSize = m_yearCacheSize,
+        .textSearch = m_textSearch,
+        .taskIndex = m_taskIndex,
+        .tagValues = m_tagValues,
+        // enabled by the caller, it is not a config option
+        .progressiveCollect = false,
+        .previewDebounce = std::chrono::milliseconds{m_previewDebounceMs},
     };
 }
 } // namespace caps_log
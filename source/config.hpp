@@ -2,14 +2,17 @@
 
 #include "app.hpp"
 #include "log/local_log_repository.hpp"
+#include "log/log_grep.hpp"
 #include "log/log_repository_crypto_applier.hpp"
 #include "utils/git_repo.hpp"
 #include "view/annual_view_layout_base.hpp"
 #include "view/view.hpp"
 #include <boost/property_tree/ptree.hpp>
+#include <cstddef>
 #include <filesystem>
 #include <optional>
 #include <string>
+#include <vector>
 
 #include <boost/program_options.hpp>
 
@@ -29,6 +32,16 @@ class Configuration {
     static const bool kDefaultSundayStart;
     static const bool kDefaultAcceptSectionsOnFirstLine;
     static const unsigned kDefaultRecentEventsWindow = 14;
+    static const unsigned kDefaultCollectWorkers = 0;
+    static const bool kDefaultMetadataIndex;
+    static const std::string kDefaultMetadataIndexFileName;
+    static const std::size_t kDefaultLogCacheSize = 4 * 1024 * 1024;
+    static const unsigned kDefaultPreloadYears = 2;
+    static const std::size_t kDefaultYearCacheSize = 32 * 1024 * 1024;
+    static const bool kDefaultTextSearch;
+    static const bool kDefaultTaskIndex;
+    static const bool kDefaultTagValues;
+    static const unsigned kDefaultPreviewDebounceMs = 40;
     static std::function<std::string(const std::filesystem::path &)> makeDefaultReadFileFunc();
 
     Configuration(const std::vector<std::string> &cliArgs,
@@ -55,6 +68,51 @@ class Configuration {
 
     [[nodiscard]] std::optional<Crypto> getCryptoApplicationType() const;
 
+    /**
+     * Pattern given with `--grep`, nullopt if the logs should not be searched.
+     */
+    [[nodiscard]] const std::optional<std::string> &getGrepPattern() const;
+
+    /**
+     * Years given with `--year-range` and the collect workers to search the logs with.
+     */
+    [[nodiscard]] log::GrepConfig getGrepConfig() const;
+
+    /**
+     * File given with `--perf-log` the ui latencies are written to on exit, nullopt if not set.
+     */
+    [[nodiscard]] const std::optional<std::string> &getPerfLogPath() const;
+
+    /**
+     * Whether `--profile-startup` was given, the startup is then timed up to the first frame
+     * instead of running the application. The git repository is left alone while profiling.
+     */
+    [[nodiscard]] bool shouldProfileStartup() const;
+
+    /**
+     * Whether `--profile-git-pull` was given, the profiled startup then also pulls the git
+     * repository, as the application does in the background once the ui is shown.
+     */
+    [[nodiscard]] bool shouldProfileGitPull() const;
+
+    /**
+     * Path of the log metadata index, nullopt if the index is disabled. When the log dir is a git
+     * repository the index is only used if its path is set explicitly, so it does not end up
+     * committed next to the logs.
+     */
+    [[nodiscard]] std::optional<std::filesystem::path> getMetadataIndexPath() const;
+
+    /**
+     * Every path a metadata index may have been written to, the default one and the configured
+     * one, whether or not the index is enabled now.
+     */
+    [[nodiscard]] std::vector<std::filesystem::path> getPossibleMetadataIndexPaths() const;
+
+    /**
+     * Size in bytes of the cache of recently read logs, 0 disables the cache.
+     */
+    [[nodiscard]] std::size_t getLogCacheSize() const;
+
     void setPassword(const std::string &password) { m_password = password; }
 
     [[nodiscard]] AppConfig getAppConfig() const;
@@ -71,7 +129,22 @@ class Configuration {
     std::string m_logDirPath;
     std::string m_logFilenameFormat;
     std::optional<Crypto> m_cryptoApplicationType;
+    std::optional<std::string> m_grepPattern;
+    log::GrepConfig m_grepConfig;
+    std::optional<std::string> m_perfLogPath;
+    bool m_profileStartup{};
+    bool m_profileGitPull{};
     bool m_acceptSectionsOnFirstLine{};
+    unsigned m_collectWorkers{};
+    bool m_metadataIndex{};
+    std::string m_metadataIndexPath;
+    std::size_t m_logCacheSize{};
+    unsigned m_preloadYears{};
+    std::size_t m_yearCacheSize{};
+    bool m_textSearch{};
+    bool m_taskIndex{};
+    bool m_tagValues{};
+    unsigned m_previewDebounceMs{};
     view::CalendarEvents m_calendarEvents;
     std::filesystem::path m_configFilePath;
     void applyDefaults();
@@ -1,83 +1,417 @@
 #include "annual_log_data.hpp"
 #include "utils/date.hpp"
+#include "utils/hash.hpp"
+
+#include <algorithm>
+#include <functional>
+#include <future>
+#include <map>
+#include <span>
+#include <string_view>
+#include <thread>
+#include <utility>
 
 namespace caps_log::log {
 
 using utils::date::monthDay;
 
 namespace {
-void collectEmpty(AnnualLogData &data, const std::shared_ptr<LogRepositoryBase> &repo,
-                  std::chrono::year_month_day date, bool skipFirstLine) {
-    auto input = repo->read(date);
+void addIndexedLog(AnnualLogData &data, std::chrono::month_day monthDayDate,
+                   const LogMetadataView &metadata) {
+    auto &symbols = utils::SymbolTable::global();
+    data.datesWithLogs.insert(monthDayDate);
+    metadata.forEachSectionTag([&](std::string_view section, std::optional<std::string_view> tag) {
+        data.add(monthDayDate, symbols.intern(section),
+                 tag ? std::optional{symbols.intern(*tag)} : std::nullopt);
+    });
+}
 
-    // if there is no log to be processed, return
-    if (not input) {
-        data.datesWithLogs.erase(monthDay(date));
-        return;
+/**
+ * Looks each name up once instead of once per comparison, as every lookup locks the table.
+ */
+void sortByName(std::vector<utils::SymbolId> &ids) {
+    const auto &symbols = utils::SymbolTable::global();
+    std::vector<std::pair<std::string_view, utils::SymbolId>> named;
+    named.reserve(ids.size());
+    for (const auto id : ids) {
+        named.emplace_back(symbols.name(id), id);
+    }
+    std::ranges::sort(named);
+    std::ranges::transform(named, ids.begin(), [](const auto &pair) { return pair.second; });
+}
+
+/**
+ * What the index knows about a log before it is read.
+ */
+struct IndexedLog {
+    std::optional<LogFileFingerprint> fingerprint;
+    std::optional<LogMetadataView> metadata;
+};
+
+IndexedLog findIndexed(const std::shared_ptr<LogRepositoryBase> &repo,
+                       std::chrono::year_month_day date,
+                       const std::shared_ptr<LogMetadataIndex> &index) {
+    IndexedLog indexed;
+    indexed.fingerprint = index ? repo->fingerprint(date) : std::nullopt;
+    indexed.metadata = indexed.fingerprint ? index->find(date) : std::nullopt;
+    return indexed;
+}
+
+/**
+ * Adds the log from the index if it did not change since it was indexed, returns whether it did.
+ */
+bool addIfUnchanged(AnnualLogData &data, std::chrono::year_month_day date,
+                    const IndexedLog &indexed) {
+    // logs that did not change since they were indexed are not read at all
+    if (indexed.metadata && indexed.metadata->fingerprint() == *indexed.fingerprint) {
+        addIndexedLog(data, monthDay(date), *indexed.metadata);
+        return true;
     }
-    input->parse(skipFirstLine);
+    return false;
+}
 
-    data.datesWithLogs.insert(monthDay(date));
+void addMissing(AnnualLogData &data, std::chrono::year_month_day date,
+                const std::shared_ptr<LogMetadataIndex> &index) {
+    data.datesWithLogs.erase(monthDay(date));
+    if (index) {
+        index->erase(date);
+    }
+}
 
+void addRead(AnnualLogData &data, LogFile &input, const IndexedLog &indexed, bool skipFirstLine,
+             const std::shared_ptr<LogMetadataIndex> &index) {
+    const auto date = input.getDate();
     const auto monthDayDate = monthDay(date);
-    for (const auto &[section, tags] : input->getTagsPerSection()) {
-        data.tagsPerSection[section][AnnualLogData::kAnyOrNoTag].insert(monthDayDate);
-        data.tagsPerSection[AnnualLogData::kAnySection][AnnualLogData::kAnyOrNoTag].insert(
-            monthDayDate);
+    const auto contentHash = indexed.fingerprint ? utils::fnv1a(input.getContent()) : 0;
+    if (indexed.metadata && indexed.metadata->contentHash() == contentHash) {
+        // only the file metadata changed (e.g. the file was touched), the content is the same
+        addIndexedLog(data, monthDayDate, *indexed.metadata);
+        index->updateFingerprint(date, *indexed.fingerprint);
+        return;
+    }
+
+    input.parse(skipFirstLine);
+
+    data.datesWithLogs.insert(monthDayDate);
+
+    auto &symbols = utils::SymbolTable::global();
+    const auto sections = input.getSections();
+    for (const auto &[section, tags] : sections) {
+        const auto sectionId = symbols.intern(section);
+        data.add(monthDayDate, sectionId);
         for (const auto &tag : tags) {
-            data.tagsPerSection[section][tag].insert(monthDayDate);
-            data.tagsPerSection[AnnualLogData::kAnySection][tag].insert(monthDayDate);
+            data.add(monthDayDate, sectionId, symbols.intern(tag));
         }
     }
+
+    if (indexed.fingerprint) {
+        index->update(date, *indexed.fingerprint, contentHash, input);
+    }
 }
 
-} // namespace
+void collectEmpty(AnnualLogData &data, const std::shared_ptr<LogRepositoryBase> &repo,
+                  std::chrono::year_month_day date, bool skipFirstLine,
+                  const std::shared_ptr<LogMetadataIndex> &index) {
+    const auto indexed = findIndexed(repo, date, index);
+    if (addIfUnchanged(data, date, indexed)) {
+        return;
+    }
+    if (auto input = repo->read(date)) {
+        addRead(data, *input, indexed, skipFirstLine, index);
+    } else {
+        addMissing(data, date, index);
+    }
+}
 
-AnnualLogData AnnualLogData::collect(const std::shared_ptr<LogRepositoryBase> &repo,
-                                     std::chrono::year year, bool skipFirstLine) {
+/**
+ * Like `collectEmpty` for each of the days, the logs that have to be read are read with a single
+ * `readMany` and parsed as they arrive.
+ */
+AnnualLogData collectEmptyDays(const std::shared_ptr<LogRepositoryBase> &repo,
+                               std::span<const std::chrono::year_month_day> days,
+                               bool skipFirstLine,
+                               const std::shared_ptr<LogMetadataIndex> &index) {
     AnnualLogData data;
+    std::map<std::chrono::year_month_day, IndexedLog> unread;
+    std::vector<std::chrono::year_month_day> toRead;
+    for (const auto &date : days) {
+        auto indexed = findIndexed(repo, date, index);
+        if (not addIfUnchanged(data, date, indexed)) {
+            toRead.push_back(date);
+            unread.emplace(date, std::move(indexed));
+        }
+    }
+
+    repo->readMany(toRead, [&data, &unread, &index, skipFirstLine](LogFile input) {
+        const auto indexed = unread.extract(input.getDate());
+        if (not indexed.empty()) {
+            addRead(data, input, indexed.mapped(), skipFirstLine, index);
+        }
+    });
+    // the logs that were not read no longer exist
+    for (const auto &[date, _] : unread) {
+        addMissing(data, date, index);
+    }
+    return data;
+}
 
-    constexpr auto kDecemberIndex = 12U;
-    constexpr auto kJanuaryIndex = 1U;
-    for (auto monthIndex = kJanuaryIndex; monthIndex <= kDecemberIndex; monthIndex++) {
-        const auto month = std::chrono::month{monthIndex};
-        const auto lastDay =
-            std::chrono::year_month_day_last{year, std::chrono::month_day_last{month}};
-        for (std::chrono::day day{1}; day <= lastDay.day(); day++) {
-            collectEmpty(data, repo, std::chrono::year_month_day{year, month, day}, skipFirstLine);
+std::vector<std::chrono::year_month_day>
+listDays(const std::shared_ptr<LogRepositoryBase> &repo, std::chrono::year year,
+         const std::shared_ptr<LogMetadataIndex> &index) {
+    // only the days that have a log file are read
+    const auto logDates = repo->listLogDates(year);
+    if (index) {
+        index->retain(year, logDates);
+    }
+    std::vector<std::chrono::year_month_day> days;
+    for (const auto &monthDay : logDates) {
+        const auto date = year / monthDay;
+        if (date.ok()) {
+            days.push_back(date);
         }
     }
+    return days;
+}
+
+AnnualLogData collectDays(const std::shared_ptr<LogRepositoryBase> &repo,
+                          std::span<const std::chrono::year_month_day> days, bool skipFirstLine,
+                          unsigned workers, const std::shared_ptr<LogMetadataIndex> &index) {
+    if (workers == 0) {
+        workers = std::max(1U, std::thread::hardware_concurrency());
+    }
+    workers = std::min<unsigned>(workers, days.size());
+
+    const auto collectRange = [&repo, &days, &index, skipFirstLine](std::size_t begin,
+                                                                    std::size_t end) {
+        return collectEmptyDays(repo, days.subspan(begin, end - begin), skipFirstLine, index);
+    };
+
+    if (workers <= 1) {
+        return collectRange(0, days.size());
+    }
+
+    // each worker gets a contiguous range of days, the partial results are merged in order so the
+    // result does not depend on scheduling and exceptions from the repository are rethrown here
+    std::vector<std::future<AnnualLogData>> partials;
+    partials.reserve(workers);
+    for (unsigned worker = 0; worker < workers; worker++) {
+        const auto begin = days.size() * worker / workers;
+        const auto end = days.size() * (worker + 1) / workers;
+        partials.push_back(std::async(std::launch::async, collectRange, begin, end));
+    }
 
+    AnnualLogData data;
+    for (auto &partial : partials) {
+        data.merge(partial.get());
+    }
     return data;
 }
 
-void AnnualLogData::collect(const std::shared_ptr<LogRepositoryBase> &repo,
-                            const std::chrono::year_month_day &date, bool skipFirstLine) {
-    // remove all information in maps for this date first
-    const auto monthDayDate = monthDay(date);
+} // namespace
+
+AnnualLogData::AnnualLogData() {
+    m_datesPerSectionTag[makeKey(anySectionId(), anyOrNoTagId())] = {};
+}
+
+utils::SymbolId AnnualLogData::anySectionId() {
+    static const auto kId = utils::SymbolTable::global().intern(kAnySection);
+    return kId;
+}
+
+utils::SymbolId AnnualLogData::anyOrNoTagId() {
+    static const auto kId = utils::SymbolTable::global().intern(kAnyOrNoTag);
+    return kId;
+}
 
-    for (auto &[_, tags] : tagsPerSection) {
-        for (auto &[_, dates] : tags) {
-            dates.erase(monthDayDate);
+const utils::date::Dates *AnnualLogData::findDates(utils::SymbolId section,
+                                                   utils::SymbolId tag) const {
+    const auto iter = m_datesPerSectionTag.find(makeKey(section, tag));
+    return iter == m_datesPerSectionTag.end() ? nullptr : &iter->second;
+}
+
+const utils::date::Dates *AnnualLogData::findDates(std::string_view section,
+                                                   std::string_view tag) const {
+    // names are only looked up, queries for unknown names must not grow the table
+    const auto &symbols = utils::SymbolTable::global();
+    const auto sectionId = symbols.find(section);
+    const auto tagId = symbols.find(tag);
+    return sectionId && tagId ? findDates(*sectionId, *tagId) : nullptr;
+}
+
+const std::vector<utils::SymbolId> &AnnualLogData::getSectionIds() const {
+    return getSortedIds().sections;
+}
+
+const std::vector<utils::SymbolId> &AnnualLogData::getTagIds(utils::SymbolId section) const {
+    static const std::vector<utils::SymbolId> kNoTags;
+    const auto &tagsPerSection = getSortedIds().tagsPerSection;
+    const auto iter = tagsPerSection.find(section);
+    return iter == tagsPerSection.end() ? kNoTags : iter->second;
+}
+
+std::vector<std::string> AnnualLogData::getAllSections() const {
+    const auto &symbols = utils::SymbolTable::global();
+    std::vector<std::string> sections;
+    sections.reserve(getSectionIds().size());
+    for (const auto section : getSectionIds()) {
+        sections.emplace_back(symbols.name(section));
+    }
+    return sections;
+}
+
+std::vector<std::string> AnnualLogData::getAllTags() const {
+    return getAllTagsForSection(kAnySection);
+}
+
+std::vector<std::string> AnnualLogData::getAllTagsForSection(const std::string &section) const {
+    const auto &symbols = utils::SymbolTable::global();
+    const auto sectionId = symbols.find(section);
+    if (not sectionId || findDates(*sectionId, anyOrNoTagId()) == nullptr) {
+        throw std::out_of_range{"No such section: " + section};
+    }
+    std::vector<std::string> tags;
+    tags.reserve(getTagIds(*sectionId).size());
+    for (const auto tag : getTagIds(*sectionId)) {
+        tags.emplace_back(symbols.name(tag));
+    }
+    return tags;
+}
+
+std::map<std::string, std::map<std::string, utils::date::Dates>>
+AnnualLogData::getTagsPerSection() const {
+    const auto &symbols = utils::SymbolTable::global();
+    std::map<std::string, std::map<std::string, utils::date::Dates>> tagsPerSection;
+    for (const auto &[key, dates] : m_datesPerSectionTag) {
+        const auto section = static_cast<utils::SymbolId>(key >> kSectionShift);
+        const auto tag = static_cast<utils::SymbolId>(key);
+        tagsPerSection[std::string{symbols.name(section)}][std::string{symbols.name(tag)}] = dates;
+    }
+    return tagsPerSection;
+}
+
+void AnnualLogData::add(std::chrono::month_day date, utils::SymbolId section,
+                        std::optional<utils::SymbolId> tag) {
+    addKey(date, makeKey(section, anyOrNoTagId()));
+    addKey(date, makeKey(anySectionId(), anyOrNoTagId()));
+    if (tag) {
+        addKey(date, makeKey(section, *tag));
+        addKey(date, makeKey(anySectionId(), *tag));
+    }
+}
+
+void AnnualLogData::addKey(std::chrono::month_day date, std::uint64_t key) {
+    const auto [iter, inserted] = m_datesPerSectionTag.try_emplace(key);
+    if (inserted) {
+        m_sortedIds.reset();
+    }
+    if (not iter->second.contains(date)) {
+        iter->second.insert(date);
+        m_keysPerDate.at(utils::date::Dates::toIndex(date)).push_back(key);
+    }
+}
+
+const AnnualLogData::SortedIds &AnnualLogData::getSortedIds() const {
+    if (m_sortedIds) {
+        return *m_sortedIds;
+    }
+
+    SortedIds sortedIds;
+    for (const auto &[key, _] : m_datesPerSectionTag) {
+        const auto section = static_cast<utils::SymbolId>(key >> kSectionShift);
+        const auto tag = static_cast<utils::SymbolId>(key);
+        if (tag != anyOrNoTagId()) {
+            sortedIds.tagsPerSection[section].push_back(tag);
+        } else if (section != anySectionId()) {
+            sortedIds.sections.push_back(section);
+        }
+    }
+
+    sortByName(sortedIds.sections);
+    for (auto &[_, tags] : sortedIds.tagsPerSection) {
+        sortByName(tags);
+    }
+    return m_sortedIds.emplace(std::move(sortedIds));
+}
+
+AnnualLogData AnnualLogData::collect(const std::shared_ptr<LogRepositoryBase> &repo,
+                                     std::chrono::year year, bool skipFirstLine, unsigned workers,
+                                     const std::shared_ptr<LogMetadataIndex> &index) {
+    return collectDays(repo, listDays(repo, year, index), skipFirstLine, workers, index);
+}
+
+void AnnualLogData::collectByMonth(
+    const std::shared_ptr<LogRepositoryBase> &repo, std::chrono::year year,
+    std::chrono::month firstMonth, bool skipFirstLine, unsigned workers,
+    const std::shared_ptr<LogMetadataIndex> &index,
+    const std::function<bool(std::chrono::month, AnnualLogData)> &onMonth) {
+    static constexpr auto kMonths = 12;
+    const auto days = listDays(repo, year, index);
+    const auto first = static_cast<int>(static_cast<unsigned>(firstMonth));
+
+    // nearest months first, the earlier one of two equally near months first
+    std::vector<std::chrono::month> months{firstMonth};
+    for (int distance = 1; distance < kMonths; distance++) {
+        for (const auto candidate : {first - distance, first + distance}) {
+            if (candidate >= 1 && candidate <= kMonths) {
+                months.emplace_back(static_cast<unsigned>(candidate));
+            }
         }
-        // remove all tags that after removal of this date would be empty (except for <any tag>)
-        std::erase_if(tags, [monthDayDate](auto &tagAndDates) {
-            const auto &[tag, dates] = tagAndDates;
-            return tag != kAnyOrNoTag && dates.size() == 0;
-        });
     }
 
-    std::erase_if(tagsPerSection, [monthDayDate](auto &item) {
-        const auto &[section, tags] = item;
-        if (section == kAnySection) {
-            return false;
+    for (const auto month : months) {
+        const auto monthDays =
+            std::ranges::equal_range(days, month, {}, &std::chrono::year_month_day::month);
+        if (monthDays.empty()) {
+            continue;
         }
-        assert(tags.contains(kAnyOrNoTag)); // <any tag> should always be present
-        return section != kAnyOrNoTag && tags.size() == 1 && tags.at(kAnyOrNoTag).empty();
-    });
+        if (not onMonth(month, collectDays(repo, monthDays, skipFirstLine, workers, index))) {
+            return;
+        }
+    }
+}
+
+std::size_t AnnualLogData::estimateMemoryUsage() const {
+    // bookkeeping of a hash table node: next pointer and cached hash
+    static constexpr auto kNodeOverhead = 2 * sizeof(void *);
+    std::size_t keys = 0;
+    for (const auto &keysOfDate : m_keysPerDate) {
+        keys += keysOfDate.capacity();
+    }
+    return sizeof(AnnualLogData) + (m_datesPerSectionTag.bucket_count() * sizeof(void *)) +
+           (m_datesPerSectionTag.size() *
+            (kNodeOverhead + sizeof(decltype(m_datesPerSectionTag)::value_type))) +
+           (keys * sizeof(std::uint64_t));
+}
+
+void AnnualLogData::merge(const AnnualLogData &other) {
+    datesWithLogs |= other.datesWithLogs;
+    for (std::size_t day = 0; day < other.m_keysPerDate.size(); day++) {
+        for (const auto key : other.m_keysPerDate.at(day)) {
+            addKey(utils::date::Dates::fromIndex(day), key);
+        }
+    }
+}
+
+void AnnualLogData::collect(const std::shared_ptr<LogRepositoryBase> &repo,
+                            const std::chrono::year_month_day &date, bool skipFirstLine,
+                            const std::shared_ptr<LogMetadataIndex> &index) {
+    // remove all information in maps for this date first, only the pairs the date had are visited
+    const auto monthDayDate = monthDay(date);
+    const auto anyKey = makeKey(anySectionId(), anyOrNoTagId());
+    auto &keys = m_keysPerDate.at(utils::date::Dates::toIndex(monthDayDate));
+    for (const auto key : keys) {
+        const auto entry = m_datesPerSectionTag.find(key);
+        entry->second.erase(monthDayDate);
+        // drop the pairs that no log has anymore (except for <any section>/<any tag>)
+        if (key != anyKey && entry->second.empty()) {
+            m_datesPerSectionTag.erase(entry);
+            m_sortedIds.reset();
+        }
+    }
+    keys.clear();
 
     // collect as if it was empty
-    collectEmpty(*this, repo, date, skipFirstLine);
+    collectEmpty(*this, repo, date, skipFirstLine, index);
 }
 
 } // namespace caps_log::log
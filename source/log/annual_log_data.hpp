@@ -1,11 +1,20 @@
 #pragma once
 
+#include "log_metadata_index.hpp"
 #include "log_repository_base.hpp"
 #include "utils/date.hpp"
-#include <algorithm>
+#include "utils/symbol_table.hpp"
+#include <array>
 #include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <map>
 #include <memory>
+#include <optional>
 #include <string>
+#include <string_view>
+#include <unordered_map>
 #include <vector>
 
 namespace caps_log::log {
@@ -14,6 +23,8 @@ namespace caps_log::log {
  * A class containing superficial data about the collection of logs.
  * It contains data like which dates have log entries, what tags/sections/tasks were
  * mentioned in which log entries but not actual log contents.
+ * Section and tag titles are interned in `utils::SymbolTable::global()`, the dates are stored in
+ * a flat table keyed by (section id, tag id).
  */
 class AnnualLogData {
   public:
@@ -21,57 +32,116 @@ class AnnualLogData {
     static constexpr auto kAnyOrNoTag = "<any tag>";
 
     utils::date::Dates datesWithLogs;
-    std::map<std::string, std::map<std::string, utils::date::Dates>> tagsPerSection;
-
-    [[nodiscard]] std::vector<std::string> getAllSections() const {
-        std::set<std::string> sections;
-        for (const auto &[section, _] : tagsPerSection) {
-            sections.insert(section);
-        }
-        // remove <any section> from the list
-        sections.erase(kAnySection);
-        return {sections.begin(), sections.end()};
-    }
 
-    [[nodiscard]] std::vector<std::string> getAllTags() const {
-        std::set<std::string> tags;
-        for (const auto &[_, tagsMap] : tagsPerSection) {
-            for (const auto &[tag, _] : tagsMap) {
-                if (tag == kAnyOrNoTag) {
-                    continue;
-                }
-                tags.insert(tag);
-            }
-        }
-        // remove <any tag> from the list
-        return {tags.begin(), tags.end()};
-    }
+    AnnualLogData();
 
-    [[nodiscard]] std::vector<std::string> getAllTagsForSection(const std::string &section) const {
-        std::vector<std::string> tags;
-        tags.reserve(tagsPerSection.at(section).size());
-        for (const auto &[tag, _] : tagsPerSection.at(section)) {
-            tags.push_back(tag);
-        }
-        // remove <any tag> from the list
-        tags.erase(std::remove(tags.begin(), tags.end(), kAnyOrNoTag), tags.end());
-        return tags;
-    }
+    [[nodiscard]] static utils::SymbolId anySectionId();
+    [[nodiscard]] static utils::SymbolId anyOrNoTagId();
+
+    /**
+     * Returns the dates of the logs that have `tag` in `section` or nullptr if there are none.
+     * `kAnySection` and `kAnyOrNoTag` match any section and any tag (including none). The
+     * pointer stays valid until the (section, tag) pair is dropped by `collect`.
+     */
+    [[nodiscard]] const utils::date::Dates *findDates(utils::SymbolId section,
+                                                      utils::SymbolId tag) const;
+    [[nodiscard]] const utils::date::Dates *findDates(std::string_view section,
+                                                      std::string_view tag) const;
+
+    /**
+     * Ids of all the sections (without `kAnySection`) sorted by their title.
+     */
+    [[nodiscard]] const std::vector<utils::SymbolId> &getSectionIds() const;
 
-    AnnualLogData() { tagsPerSection[kAnySection][kAnyOrNoTag] = {}; }
+    /**
+     * Ids of the tags of a section (all tags for `kAnySection`, without `kAnyOrNoTag`) sorted by
+     * their title.
+     */
+    [[nodiscard]] const std::vector<utils::SymbolId> &getTagIds(utils::SymbolId section) const;
+
+    [[nodiscard]] std::vector<std::string> getAllSections() const;
+    [[nodiscard]] std::vector<std::string> getAllTags() const;
+    /**
+     * Throws std::out_of_range if there is no such section.
+     */
+    [[nodiscard]] std::vector<std::string> getAllTagsForSection(const std::string &section) const;
+
+    /**
+     * Returns the whole table as section -> tag -> dates, including the `kAnySection` and
+     * `kAnyOrNoTag` entries. Meant for tests and debugging.
+     */
+    [[nodiscard]] std::map<std::string, std::map<std::string, utils::date::Dates>>
+    getTagsPerSection() const;
+
+    /**
+     * Records that the log of `date` has `tag` in `section`, or that it has `section` without
+     * tags if `tag` is not given.
+     */
+    void add(std::chrono::month_day date, utils::SymbolId section,
+             std::optional<utils::SymbolId> tag = std::nullopt);
+
+    /**
+     * Rough estimate of the heap memory used by this object, including the table nodes.
+     */
+    [[nodiscard]] std::size_t estimateMemoryUsage() const;
 
     /**
      * Constructs YearOverviewData from logs in a given year.
+     * Only the dates listed by the repository are read. They are split into contiguous ranges
+     * that are read and parsed on `workers` threads and merged in order, 0 workers means one per
+     * hardware thread and 1 collects on the calling thread.
+     * If an `index` is given, logs whose fingerprint matches the indexed one are not read, the
+     * rest are parsed and their metadata is updated in the index.
+     */
+    [[nodiscard]] static AnnualLogData
+    collect(const std::shared_ptr<LogRepositoryBase> &repo, std::chrono::year year,
+            bool skipFirstLine = true, unsigned workers = 1,
+            const std::shared_ptr<LogMetadataIndex> &index = nullptr);
+
+    /**
+     * Same as the static `collect`, but the logs are collected a month at a time and each month
+     * that has logs is handed to `onMonth` as soon as it is done. Months nearest to `firstMonth`
+     * are collected first, so the months around the one the user looks at are available soonest.
+     * Returning false from `onMonth` stops the collection.
+     */
+    static void
+    collectByMonth(const std::shared_ptr<LogRepositoryBase> &repo, std::chrono::year year,
+                   std::chrono::month firstMonth, bool skipFirstLine, unsigned workers,
+                   const std::shared_ptr<LogMetadataIndex> &index,
+                   const std::function<bool(std::chrono::month, AnnualLogData)> &onMonth);
+
+    /**
+     * Adds all the dates, sections and tags from `other` to this object.
      */
-    [[nodiscard]] static AnnualLogData collect(const std::shared_ptr<LogRepositoryBase> &repo,
-                                               std::chrono::year year, bool skipFirstLine = true);
+    void merge(const AnnualLogData &other);
 
     /**
      * Injects/updates the current object with information parsed from a log entry form a specified
      * date. It will remove/add it to logAvailabilityMap if deleted/written etc.
      */
     void collect(const std::shared_ptr<LogRepositoryBase> &repo,
-                 const std::chrono::year_month_day &date, bool skipFirstLine = true);
+                 const std::chrono::year_month_day &date, bool skipFirstLine = true,
+                 const std::shared_ptr<LogMetadataIndex> &index = nullptr);
+
+  private:
+    struct SortedIds {
+        std::vector<utils::SymbolId> sections;
+        std::unordered_map<utils::SymbolId, std::vector<utils::SymbolId>> tagsPerSection;
+    };
+
+    std::unordered_map<std::uint64_t, utils::date::Dates> m_datesPerSectionTag;
+    // reverse of the table above, keys of the (section, tag) pairs each day (by
+    // `Dates::toIndex`) is in, so re-collecting a day only touches the pairs of that day
+    std::array<std::vector<std::uint64_t>, utils::date::Dates::kCapacity> m_keysPerDate;
+    // rebuilt on demand after the set of (section, tag) pairs changes
+    mutable std::optional<SortedIds> m_sortedIds;
+
+    static constexpr auto kSectionShift = 32U;
+    static constexpr std::uint64_t makeKey(utils::SymbolId section, utils::SymbolId tag) {
+        return (std::uint64_t{section} << kSectionShift) | tag;
+    }
+    const SortedIds &getSortedIds() const;
+    void addKey(std::chrono::month_day date, std::uint64_t key);
 };
 
 } // namespace caps_log::log
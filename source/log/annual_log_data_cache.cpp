@@ -0,0 +1,124 @@
+#include "annual_log_data_cache.hpp"
+
+#include <array>
+#include <cstdlib>
+#include <utility>
+
+namespace caps_log::log {
+
+AnnualLogDataCache::AnnualLogDataCache(std::shared_ptr<LogRepositoryBase> repo,
+                                       std::shared_ptr<LogMetadataIndex> index, Config config)
+    : m_repo{std::move(repo)}, m_index{std::move(index)}, m_config{config} {}
+
+std::shared_ptr<AnnualLogData> AnnualLogDataCache::get(std::chrono::year year) {
+    {
+        const std::scoped_lock lock{m_mutex};
+        m_displayedYear = year;
+        if (const auto entry = m_years.find(year); entry != m_years.end()) {
+            return entry->second.data;
+        }
+    }
+
+    auto data = collect(year);
+
+    const std::scoped_lock lock{m_mutex};
+    // the year might have been preloaded in the meantime
+    if (const auto entry = m_years.find(year); entry != m_years.end()) {
+        return entry->second.data;
+    }
+    insert(year, data);
+    return data;
+}
+
+void AnnualLogDataCache::put(std::chrono::year year, std::shared_ptr<AnnualLogData> data) {
+    const std::scoped_lock lock{m_mutex};
+    m_displayedYear = year;
+    insert(year, std::move(data));
+}
+
+void AnnualLogDataCache::preload(std::chrono::year year, unsigned radius) {
+    m_preloader.post([this, year, radius](const auto &token) {
+        static constexpr std::array kDirections{1, -1};
+        for (unsigned distance = 1; distance <= radius; distance++) {
+            for (const auto direction : kDirections) {
+                const auto candidate =
+                    year + std::chrono::years{direction * static_cast<int>(distance)};
+                if (token.isCancelled()) {
+                    return;
+                }
+                if (contains(candidate)) {
+                    continue;
+                }
+                try {
+                    auto data = collect(candidate);
+                    const std::scoped_lock lock{m_mutex};
+                    // checked again under the lock so nothing is inserted after a `clear`
+                    if (token.isCancelled()) {
+                        return;
+                    }
+                    if (not insert(candidate, std::move(data))) {
+                        // the budget is used up, years that are even farther would not fit either
+                        return;
+                    }
+                } catch (const std::exception &) {
+                    // the year is collected again once it is displayed
+                    return;
+                }
+            }
+        }
+    });
+}
+
+void AnnualLogDataCache::clear() {
+    const std::scoped_lock lock{m_mutex};
+    m_preloader.cancel();
+    m_years.clear();
+    m_memoryUsage = 0;
+}
+
+void AnnualLogDataCache::waitForPreload() { m_preloader.wait(); }
+
+bool AnnualLogDataCache::contains(std::chrono::year year) const {
+    const std::scoped_lock lock{m_mutex};
+    return m_years.contains(year);
+}
+
+std::size_t AnnualLogDataCache::getMemoryUsage() const {
+    const std::scoped_lock lock{m_mutex};
+    return m_memoryUsage;
+}
+
+std::shared_ptr<AnnualLogData> AnnualLogDataCache::collect(std::chrono::year year) const {
+    return std::make_shared<AnnualLogData>(AnnualLogData::collect(
+        m_repo, year, m_config.skipFirstLine, m_config.collectWorkers, m_index));
+}
+
+bool AnnualLogDataCache::insert(std::chrono::year year, std::shared_ptr<AnnualLogData> data) {
+    if (m_years.contains(year)) {
+        return true;
+    }
+    const auto size = data->estimateMemoryUsage();
+    m_years.emplace(year, Entry{.data = std::move(data), .size = size});
+    m_memoryUsage += size;
+
+    const auto distance = [this](std::chrono::year other) {
+        return std::abs(static_cast<int>(other) - static_cast<int>(m_displayedYear));
+    };
+    while (m_memoryUsage > m_config.capacityBytes) {
+        auto farthest = m_years.end();
+        for (auto entry = m_years.begin(); entry != m_years.end(); ++entry) {
+            if (entry->first != m_displayedYear &&
+                (farthest == m_years.end() || distance(entry->first) > distance(farthest->first))) {
+                farthest = entry;
+            }
+        }
+        if (farthest == m_years.end()) {
+            break;
+        }
+        m_memoryUsage -= farthest->second.size;
+        m_years.erase(farthest);
+    }
+    return m_years.contains(year);
+}
+
+} // namespace caps_log::log
@@ -0,0 +1,100 @@
+#pragma once
+
+#include "annual_log_data.hpp"
+#include "log_metadata_index.hpp"
+#include "log_repository_base.hpp"
+#include "utils/task_executor.hpp"
+
+#include <chrono>
+#include <cstddef>
+#include <map>
+#include <memory>
+#include <mutex>
+
+namespace caps_log::log {
+
+/**
+ * Keeps the AnnualLogData of multiple years in memory, so switching the displayed year does not
+ * collect its logs again. Years around the displayed one can be collected ahead of time on a
+ * background thread. When the estimated memory usage exceeds the budget, the years farthest from
+ * the displayed one are evicted first, the displayed year is never evicted.
+ * The data of a year is only ever modified by the owner of the pointer returned by `get`, the
+ * background thread only inserts years that are not resident yet.
+ */
+class AnnualLogDataCache {
+  public:
+    struct Config {
+        bool skipFirstLine = true;
+        unsigned collectWorkers = 1;
+        std::size_t capacityBytes = 0;
+    };
+
+    AnnualLogDataCache(std::shared_ptr<LogRepositoryBase> repo,
+                       std::shared_ptr<LogMetadataIndex> index, Config config);
+    ~AnnualLogDataCache() = default;
+
+    AnnualLogDataCache(const AnnualLogDataCache &) = delete;
+    AnnualLogDataCache(AnnualLogDataCache &&) = delete;
+    AnnualLogDataCache &operator=(const AnnualLogDataCache &) = delete;
+    AnnualLogDataCache &operator=(AnnualLogDataCache &&) = delete;
+
+    /**
+     * Returns the data of the given year and makes it the displayed year. If the year is not
+     * resident it is collected on the calling thread.
+     */
+    [[nodiscard]] std::shared_ptr<AnnualLogData> get(std::chrono::year year);
+
+    /**
+     * Makes a year that was collected by the caller resident and the displayed year, unless it
+     * already is resident. The caller keeps being the owner of `data`.
+     */
+    void put(std::chrono::year year, std::shared_ptr<AnnualLogData> data);
+
+    /**
+     * Collects the years within `radius` of `year` that are not resident on a background thread,
+     * nearest years first. A newer call cancels the years not collected yet.
+     */
+    void preload(std::chrono::year year, unsigned radius);
+
+    /**
+     * Drops all resident years, used when the logs changed behind the application's back.
+     */
+    void clear();
+
+    /**
+     * Blocks until the preloads requested so far are done.
+     */
+    void waitForPreload();
+
+    [[nodiscard]] bool contains(std::chrono::year year) const;
+    [[nodiscard]] std::size_t getMemoryUsage() const;
+
+  private:
+    struct Entry {
+        std::shared_ptr<AnnualLogData> data;
+        // estimated when the year was collected
+        std::size_t size;
+    };
+
+    std::shared_ptr<LogRepositoryBase> m_repo;
+    std::shared_ptr<LogMetadataIndex> m_index;
+    Config m_config;
+
+    mutable std::mutex m_mutex;
+    std::map<std::chrono::year, Entry> m_years;
+    std::chrono::year m_displayedYear{};
+    std::size_t m_memoryUsage{};
+
+    // declared last so the worker is joined before the cache is destroyed
+    utils::CancellableTaskExecutor m_preloader;
+
+    [[nodiscard]] std::shared_ptr<AnnualLogData> collect(std::chrono::year year) const;
+
+    /**
+     * Inserts the year unless it is already resident and evicts far years until the budget is
+     * met. Returns false if the year itself did not fit. Expects `m_mutex` to be held.
+     */
+    bool insert(std::chrono::year year, std::shared_ptr<AnnualLogData> data);
+};
+
+} // namespace caps_log::log
@@ -0,0 +1,191 @@
+#include "caching_log_repository.hpp"
+
+#include <utility>
+
+namespace caps_log::log {
+
+CachingLogRepository::CachingLogRepository(std::shared_ptr<LogRepositoryBase> repo,
+                                           std::size_t capacityBytes,
+                                           std::chrono::milliseconds revalidateAfter)
+    : m_repo{std::move(repo)}, m_capacityBytes{capacityBytes}, m_revalidateAfter{revalidateAfter} {
+}
+
+std::optional<LogFile> CachingLogRepository::read(const std::chrono::year_month_day &date) const {
+    const std::shared_lock lock{m_repoMutex};
+    if (auto cached = findValid(date)) {
+        return std::move(*cached);
+    }
+    return readThrough(date);
+}
+
+void CachingLogRepository::readMany(std::span<const std::chrono::year_month_day> dates,
+                                    const OnLogRead &onLog) const {
+    const std::shared_lock lock{m_repoMutex};
+    std::vector<std::chrono::year_month_day> missedDates;
+    for (const auto &date : dates) {
+        if (auto cached = findValid(date)) {
+            if (*cached) {
+                onLog(std::move(**cached));
+            }
+        } else {
+            missedDates.push_back(date);
+        }
+    }
+    // bulk reads go over whole years, caching them would evict the logs the ui reads
+    m_repo->readMany(missedDates, onLog);
+}
+
+utils::date::Dates CachingLogRepository::listLogDates(std::chrono::year year) const {
+    const std::shared_lock lock{m_repoMutex};
+    return m_repo->listLogDates(year);
+}
+
+std::vector<std::chrono::year> CachingLogRepository::listLogYears() const {
+    const std::shared_lock lock{m_repoMutex};
+    return m_repo->listLogYears();
+}
+
+std::optional<LogFileFingerprint>
+CachingLogRepository::fingerprint(const std::chrono::year_month_day &date) const {
+    const std::shared_lock lock{m_repoMutex};
+    return m_repo->fingerprint(date);
+}
+
+void CachingLogRepository::prefetch(const std::vector<std::chrono::year_month_day> &dates) {
+    m_prefetcher.post([this, dates](const auto &token) {
+        for (const auto &date : dates) {
+            if (token.isCancelled()) {
+                return;
+            }
+            if (not date.ok()) {
+                continue;
+            }
+            try {
+                const std::shared_lock lock{m_repoMutex};
+                if (not findValid(date)) {
+                    readThrough(date);
+                }
+            } catch (const std::exception &) {
+                // a failed prefetch is retried by the next `read` of the same date
+            }
+        }
+    });
+}
+
+void CachingLogRepository::write(const LogFile &log) {
+    const std::unique_lock lock{m_repoMutex};
+    evict(log.getDate());
+    m_repo->write(log);
+}
+
+void CachingLogRepository::remove(const std::chrono::year_month_day &date) {
+    const std::unique_lock lock{m_repoMutex};
+    evict(date);
+    m_repo->remove(date);
+}
+
+void CachingLogRepository::invalidate(const std::chrono::year_month_day &date) {
+    const std::unique_lock lock{m_repoMutex};
+    evict(date);
+}
+
+void CachingLogRepository::invalidateAll() {
+    const std::unique_lock lock{m_repoMutex};
+    const std::scoped_lock cacheLock{m_cacheMutex};
+    m_entries.clear();
+    m_entryByDate.clear();
+    m_cachedBytes = 0;
+}
+
+void CachingLogRepository::waitForPrefetch() { m_prefetcher.wait(); }
+
+std::size_t CachingLogRepository::getCachedBytes() const {
+    const std::scoped_lock lock{m_cacheMutex};
+    return m_cachedBytes;
+}
+
+std::optional<LogFile>
+CachingLogRepository::readThrough(const std::chrono::year_month_day &date) const {
+    // the fingerprint is taken first, a change in between makes the entry stale rather than wrong
+    const auto validatedAt = std::chrono::steady_clock::now();
+    auto fingerprint = m_repo->fingerprint(date);
+    auto log = m_repo->read(date);
+    const auto size = sizeof(Entry) + (log ? log->getContent().size() : 0);
+    insert(Entry{.date = date,
+                 .log = log,
+                 .fingerprint = fingerprint,
+                 .size = size,
+                 .validatedAt = validatedAt});
+    return log;
+}
+
+std::optional<std::optional<LogFile>>
+CachingLogRepository::findValid(const std::chrono::year_month_day &date) const {
+    std::optional<LogFileFingerprint> cachedFingerprint;
+    {
+        const std::scoped_lock lock{m_cacheMutex};
+        const auto entry = m_entryByDate.find(date);
+        if (entry == m_entryByDate.end()) {
+            return std::nullopt;
+        }
+        // recently validated entries are served without checking the disk again
+        if (std::chrono::steady_clock::now() - entry->second->validatedAt < m_revalidateAfter) {
+            m_entries.splice(m_entries.begin(), m_entries, entry->second);
+            return entry->second->log;
+        }
+        cachedFingerprint = entry->second->fingerprint;
+    }
+
+    // checked without holding the cache lock as it may hit the disk
+    const auto validatedAt = std::chrono::steady_clock::now();
+    const auto currentFingerprint = m_repo->fingerprint(date);
+
+    const std::scoped_lock lock{m_cacheMutex};
+    const auto entry = m_entryByDate.find(date);
+    if (entry == m_entryByDate.end() || entry->second->fingerprint != cachedFingerprint) {
+        return std::nullopt;
+    }
+    if (currentFingerprint != cachedFingerprint) {
+        m_cachedBytes -= entry->second->size;
+        m_entries.erase(entry->second);
+        m_entryByDate.erase(entry);
+        return std::nullopt;
+    }
+    entry->second->validatedAt = validatedAt;
+    m_entries.splice(m_entries.begin(), m_entries, entry->second);
+    return entry->second->log;
+}
+
+void CachingLogRepository::insert(Entry entry) const {
+    const std::scoped_lock lock{m_cacheMutex};
+    if (const auto existing = m_entryByDate.find(entry.date); existing != m_entryByDate.end()) {
+        m_cachedBytes -= existing->second->size;
+        m_entries.erase(existing->second);
+        m_entryByDate.erase(existing);
+    }
+    if (entry.size > m_capacityBytes) {
+        return;
+    }
+
+    m_cachedBytes += entry.size;
+    m_entries.push_front(std::move(entry));
+    m_entryByDate[m_entries.front().date] = m_entries.begin();
+
+    while (m_cachedBytes > m_capacityBytes) {
+        const auto &leastRecentlyUsed = m_entries.back();
+        m_cachedBytes -= leastRecentlyUsed.size;
+        m_entryByDate.erase(leastRecentlyUsed.date);
+        m_entries.pop_back();
+    }
+}
+
+void CachingLogRepository::evict(const std::chrono::year_month_day &date) const {
+    const std::scoped_lock lock{m_cacheMutex};
+    if (const auto entry = m_entryByDate.find(date); entry != m_entryByDate.end()) {
+        m_cachedBytes -= entry->second->size;
+        m_entries.erase(entry->second);
+        m_entryByDate.erase(entry);
+    }
+}
+
+} // namespace caps_log::log
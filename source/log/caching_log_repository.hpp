@@ -0,0 +1,102 @@
+#pragma once
+
+#include "log_repository_base.hpp"
+#include "utils/task_executor.hpp"
+
+#include <chrono>
+#include <cstddef>
+#include <list>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <shared_mutex>
+#include <vector>
+
+namespace caps_log::log {
+
+/**
+ * Read-through decorator that keeps the most recently read logs (and the dates that have no log)
+ * in a LRU cache bounded by the total size of the cached log contents.
+ * Changes made behind the repository's back are dropped from the cache by `invalidate`. Changes
+ * nobody reported (e.g. a log edited in another terminal) are picked up by validating a cached
+ * log against the fingerprint of the underlying repository, at most once per `revalidateAfter`
+ * so that repeated reads of the same log do not stat it every time. Logs passed to `prefetch` are
+ * read into the cache on a background thread, a newer `prefetch` cancels the older one.
+ */
+class CachingLogRepository : public LogRepositoryBase {
+  public:
+    static constexpr std::chrono::milliseconds kDefaultRevalidateAfter{2000};
+
+    CachingLogRepository(std::shared_ptr<LogRepositoryBase> repo, std::size_t capacityBytes,
+                         std::chrono::milliseconds revalidateAfter = kDefaultRevalidateAfter);
+    ~CachingLogRepository() override = default;
+
+    CachingLogRepository(const CachingLogRepository &) = delete;
+    CachingLogRepository(CachingLogRepository &&) = delete;
+    CachingLogRepository &operator=(const CachingLogRepository &) = delete;
+    CachingLogRepository &operator=(CachingLogRepository &&) = delete;
+
+    [[nodiscard]] std::optional<LogFile>
+    read(const std::chrono::year_month_day &date) const override;
+    /**
+     * Serves the cached logs and reads the rest with a single `readMany` of the underlying
+     * repository. Unlike `read`, the logs that are read are not cached and their fingerprints are
+     * not taken, so a scan over many logs does not evict the ones read by `read`.
+     */
+    void readMany(std::span<const std::chrono::year_month_day> dates,
+                  const OnLogRead &onLog) const override;
+    [[nodiscard]] utils::date::Dates listLogDates(std::chrono::year year) const override;
+    [[nodiscard]] std::vector<std::chrono::year> listLogYears() const override;
+    [[nodiscard]] std::optional<LogFileFingerprint>
+    fingerprint(const std::chrono::year_month_day &date) const override;
+    void prefetch(const std::vector<std::chrono::year_month_day> &dates) override;
+    void write(const LogFile &log) override;
+    void remove(const std::chrono::year_month_day &date) override;
+    void invalidate(const std::chrono::year_month_day &date) override;
+    void invalidateAll() override;
+
+    /**
+     * Blocks until the prefetches requested so far are done.
+     */
+    void waitForPrefetch();
+
+    [[nodiscard]] std::size_t getCachedBytes() const;
+
+  private:
+    struct Entry {
+        std::chrono::year_month_day date;
+        std::optional<LogFile> log;
+        std::optional<LogFileFingerprint> fingerprint;
+        std::size_t size;
+        std::chrono::steady_clock::time_point validatedAt;
+    };
+
+    std::shared_ptr<LogRepositoryBase> m_repo;
+    std::size_t m_capacityBytes;
+    std::chrono::milliseconds m_revalidateAfter;
+
+    // readers of the underlying repository hold it shared, `write` and `remove` exclusively
+    mutable std::shared_mutex m_repoMutex;
+
+    // most recently used entry first
+    mutable std::mutex m_cacheMutex;
+    mutable std::list<Entry> m_entries;
+    mutable std::map<std::chrono::year_month_day, std::list<Entry>::iterator> m_entryByDate;
+    mutable std::size_t m_cachedBytes{};
+
+    // declared last so the worker is joined before the cache is destroyed
+    utils::CancellableTaskExecutor m_prefetcher;
+
+    /**
+     * Returns the log from the underlying repository and caches it, expects `m_repoMutex` to be
+     * held by the caller.
+     */
+    std::optional<LogFile> readThrough(const std::chrono::year_month_day &date) const;
+    [[nodiscard]] std::optional<std::optional<LogFile>>
+    findValid(const std::chrono::year_month_day &date) const;
+    void insert(Entry entry) const;
+    void evict(const std::chrono::year_month_day &date) const;
+};
+
+} // namespace caps_log::log
@@ -1,22 +1,32 @@
 #include "local_log_repository.hpp"
 
 #include "log/log_repository_crypto_applier.hpp"
+#include <algorithm>
+#include <charconv>
+#include <cstdint>
+#include <fmt/format.h>
 #include <fstream>
+#include <iomanip>
+#include <limits>
+#include <random>
 #include <sstream>
 #include <utility>
+#include <utils/batch_file_reader.hpp>
 #include <utils/crypto.hpp>
+#include <utils/mapped_file.hpp>
 
 namespace caps_log::log {
 
 namespace {
+// smaller logs are read by `readMany`, mapping them costs more than the copy it saves
+constexpr std::uintmax_t kMinMappedLogSize = 64 * 1024;
+
 std::string readFileContent(const std::filesystem::path &path) {
-    std::ifstream ifs{path};
-    if (not ifs.is_open()) {
+    auto content = utils::readFile(path);
+    if (not content) {
         throw std::runtime_error{"Failed to open file: " + path.string()};
     }
-    std::stringstream buffer;
-    buffer << ifs.rdbuf();
-    return buffer.str();
+    return std::move(*content);
 }
 
 std::chrono::year_month_day lastWriteTime(const std::filesystem::path &filePath) {
@@ -36,8 +46,54 @@ std::chrono::year_month_day lastWriteTime(const std::filesystem::path &filePath)
     auto ymd = std::chrono::year_month_day{std::chrono::floor<std::chrono::days>(sctp)};
     return ymd;
 }
+
+/**
+ * Creates a file with an unused hidden name next to `path`, for the new content of `path`.
+ */
+std::pair<std::filesystem::path, std::ofstream>
+makeTemporaryFile(const std::filesystem::path &path) {
+    static constexpr auto kAttempts = 16;
+    std::random_device random;
+    for (auto attempt = 0; attempt < kAttempts; attempt++) {
+        auto tempPath = path.parent_path() /
+                        fmt::format(".{}.{:08x}{}", path.filename().string(), random(),
+                                    LocalLogRepository::kTemporaryFileExtension);
+        std::ofstream file{tempPath, std::ios::out | std::ios::noreplace};
+        if (file.is_open()) {
+            return {std::move(tempPath), std::move(file)};
+        }
+    }
+    throw std::runtime_error{"Failed to create a temporary file for: " + path.string()};
+}
 } // namespace
 
+std::optional<std::chrono::year_month_day>
+LocalFSLogFilePathProvider::parseDate(const std::filesystem::path &path) const {
+    std::tm dateTime = {};
+    std::istringstream iss{path.filename().string()};
+    if (!(iss >> std::get_time(&dateTime, m_logFilenameFormat.c_str()))) {
+        return std::nullopt;
+    }
+
+    std::string remaining;
+    std::getline(iss, remaining);
+    if (!remaining.empty()) {
+        return std::nullopt;
+    }
+    // The tm_year is years since 1900, so we need to add 1900 to it
+    static constexpr auto kTmYearOffset = 1900;
+    const auto date = std::chrono::year_month_day{
+        std::chrono::year{dateTime.tm_year + kTmYearOffset},
+        std::chrono::month{static_cast<unsigned int>(dateTime.tm_mon + 1)},
+        std::chrono::day{static_cast<unsigned int>(dateTime.tm_mday)}};
+    // without a year in the format the year is 1900, which has no 29th of February, so only the
+    // month and the day are checked here
+    if (not utils::date::monthDay(date).ok()) {
+        return std::nullopt;
+    }
+    return date;
+}
+
 LocalLogRepository::LocalLogRepository(LocalFSLogFilePathProvider pathProvider,
                                        std::string password)
     : m_pathProvider(std::move(pathProvider)), m_password{std::move(password)} {
@@ -60,23 +116,123 @@ LocalLogRepository::LocalLogRepository(LocalFSLogFilePathProvider pathProvider,
 }
 
 std::optional<LogFile> LocalLogRepository::read(const std::chrono::year_month_day &date) const {
-    std::ifstream ifs{m_pathProvider.path(date)};
-
-    if (not ifs.is_open()) {
-        return std::nullopt;
-    }
+    const auto path = m_pathProvider.path(date);
 
     if (not m_password.empty()) {
+        std::ifstream ifs{path};
+        if (not ifs.is_open()) {
+            return std::nullopt;
+        }
         return LogFile{date, utils::decrypt(m_password, ifs)};
     }
 
-    std::stringstream buffer;
-    buffer << ifs.rdbuf();
-    return LogFile{date, std::string{buffer.str()}};
+    if (auto content = utils::readFile(path)) {
+        return LogFile{date, std::move(*content)};
+    }
+    return std::nullopt;
+}
+
+void LocalLogRepository::readMany(std::span<const std::chrono::year_month_day> dates,
+                                  const OnLogRead &onLog) const {
+    std::vector<std::filesystem::path> paths;
+    paths.reserve(dates.size());
+    for (const auto &date : dates) {
+        paths.push_back(m_pathProvider.path(date));
+    }
+    // encrypted logs are decrypted into a string anyway, so only plain text logs are mapped
+    const auto maxReadSize =
+        m_password.empty() ? kMinMappedLogSize - 1 : std::numeric_limits<std::uintmax_t>::max();
+    const auto toMap = utils::readFiles(
+        paths,
+        [this, &dates, &onLog](std::size_t index, std::string content) {
+            if (not m_password.empty()) {
+                std::istringstream encrypted{std::move(content)};
+                content = utils::decrypt(m_password, encrypted);
+            }
+            onLog(LogFile{dates[index], std::move(content)});
+        },
+        maxReadSize);
+    for (const auto index : toMap) {
+        std::optional<LogFile> log;
+        try {
+            log.emplace(dates[index], std::make_shared<const utils::MappedFile>(paths[index]));
+        } catch (const std::runtime_error &) {
+            // e.g. removed in the meantime, read like any other log
+            if (auto content = utils::readFile(paths[index])) {
+                log.emplace(dates[index], std::move(*content));
+            }
+        }
+        if (log) {
+            onLog(std::move(*log));
+        }
+    }
+}
+
+utils::date::Dates LocalLogRepository::listLogDates(std::chrono::year year) const {
+    utils::date::Dates dates;
+    std::error_code error;
+    for (const auto &entry :
+         std::filesystem::directory_iterator{m_pathProvider.yearDirPath(year), error}) {
+        if (not entry.is_regular_file()) {
+            continue;
+        }
+        const auto parsed = m_pathProvider.parseDate(entry.path());
+        if (not parsed) {
+            continue;
+        }
+        // the year is taken from the directory, formats without a year still round trip
+        const auto date = std::chrono::year_month_day{year, parsed->month(), parsed->day()};
+        if (date.ok() && m_pathProvider.path(date).filename() == entry.path().filename()) {
+            dates.insert(utils::date::monthDay(date));
+        }
+    }
+    // a missing year directory just means there are no logs for that year
+    return dates;
+}
+
+std::vector<std::chrono::year> LocalLogRepository::listLogYears() const {
+    std::vector<std::chrono::year> years;
+    std::error_code error;
+    for (const auto &entry :
+         std::filesystem::directory_iterator{m_pathProvider.getLogDirPath(), error}) {
+        const auto name = entry.path().filename().string();
+        if (not entry.is_directory() || name.size() < 2 || name.front() != 'y') {
+            continue;
+        }
+        int year = 0;
+        const auto *const end = name.data() + name.size();
+        const auto [parsedEnd, parseError] = std::from_chars(name.data() + 1, end, year);
+        if (parseError == std::errc{} && parsedEnd == end &&
+            m_pathProvider.yearDirPath(std::chrono::year{year}).filename() == name) {
+            years.emplace_back(year);
+        }
+    }
+    std::ranges::sort(years);
+    return years;
+}
+
+std::optional<LogFileFingerprint>
+LocalLogRepository::fingerprint(const std::chrono::year_month_day &date) const {
+    const auto path = m_pathProvider.path(date);
+    std::error_code error;
+    const auto size = std::filesystem::file_size(path, error);
+    if (error) {
+        return std::nullopt;
+    }
+    const auto modificationTime = std::filesystem::last_write_time(path, error);
+    if (error) {
+        return std::nullopt;
+    }
+    return LogFileFingerprint{
+        .size = size,
+        .modificationTime = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                modificationTime.time_since_epoch())
+                                .count(),
+    };
 }
 
 void LocalLogRepository::write(const LogFile &log) {
-    const auto path = m_pathProvider.path(log.getDate());
+    auto path = m_pathProvider.path(log.getDate());
     if (not std::filesystem::exists(path.parent_path())) {
         std::error_code error;
         if (not std::filesystem::create_directories(path.parent_path(), error)) {
@@ -84,12 +240,36 @@ void LocalLogRepository::write(const LogFile &log) {
                                      error.message()};
         }
     }
+    // renaming over the link would replace it with a copy of the log
+    if (std::filesystem::is_symlink(path)) {
+        path = std::filesystem::weakly_canonical(path);
+    }
 
+    // written next to the log and renamed over it, so a mapped copy of the log (see `read`) keeps
+    // its content instead of being truncated under the reader
+    auto [tempPath, file] = makeTemporaryFile(path);
     if (not m_password.empty()) {
-        std::istringstream iss{log.getContent()};
-        std::ofstream{path} << utils::encrypt(m_password, iss);
+        std::istringstream iss{std::string{log.getContent()}};
+        file << utils::encrypt(m_password, iss);
     } else {
-        std::ofstream{path} << log.getContent();
+        file << log.getContent();
+    }
+    file.close();
+
+    std::error_code error;
+    std::error_code statusError;
+    if (const auto status = std::filesystem::status(path, statusError);
+        std::filesystem::exists(status)) {
+        std::filesystem::permissions(tempPath, status.permissions(), error);
+    }
+    if (not file || error) {
+        std::filesystem::remove(tempPath, error);
+        throw std::runtime_error{"Failed to write log file: " + path.string()};
+    }
+    std::filesystem::rename(tempPath, path, error);
+    if (error) {
+        std::filesystem::remove(tempPath, error);
+        throw std::runtime_error{"Failed to write log file: " + path.string()};
     }
 }
 
@@ -6,6 +6,7 @@
 #include <filesystem>
 #include <fmt/format.h>
 #include <optional>
+#include <string_view>
 
 namespace caps_log::log {
 
@@ -18,10 +19,21 @@ class LocalFSLogFilePathProvider {
         : m_logDirectory{logDir}, m_logFilenameFormat{std::move(logFilenameFormat)} {}
 
     [[nodiscard]] std::filesystem::path path(const std::chrono::year_month_day &date) const {
-        return {m_logDirectory / fmt::format("y{}", (int)date.year()) /
-                utils::date::formatToString(date, m_logFilenameFormat)};
+        return {yearDirPath(date.year()) / utils::date::formatToString(date, m_logFilenameFormat)};
     }
 
+    [[nodiscard]] std::filesystem::path yearDirPath(std::chrono::year year) const {
+        return m_logDirectory / fmt::format("y{}", (int)year);
+    }
+
+    /**
+     * Parses the date back from the filename of a log file, returns nullopt if the filename does
+     * not match the log filename format. Only the month and the day are validated: if the format
+     * has no year, the year is 1900 and the date is not `ok` for the 29th of February.
+     */
+    [[nodiscard]] std::optional<std::chrono::year_month_day>
+    parseDate(const std::filesystem::path &path) const;
+
     [[nodiscard]] std::filesystem::path getLogDirPath() const { return m_logDirectory; }
     [[nodiscard]] std::string getLogFilenameFormat() const { return m_logFilenameFormat; }
 };
@@ -44,11 +56,36 @@ class LocalLogRepository : public LogRepositoryBase {
     std::string m_password;
 
   public:
+    /**
+     * The extension of the temporary files `write` puts next to a log, they are hidden and should
+     * be ignored by anything syncing the log directory in case one is left behind by a crash.
+     */
+    static constexpr std::string_view kTemporaryFileExtension = ".caps-log-tmp";
+
     explicit LocalLogRepository(LocalFSLogFilePathProvider pathProvider, std::string password = "");
 
+    /**
+     * Reads the log file into a string of its size with a single read, the log can be kept for as
+     * long as needed.
+     */
     [[nodiscard]] std::optional<LogFile>
     read(const std::chrono::year_month_day &date) const override;
+    /**
+     * Reads the log files in batches through `utils::readFiles`, see there. Plain text logs of
+     * 64 KiB and more are memory mapped instead, so scans over the history do not copy them.
+     */
+    void readMany(std::span<const std::chrono::year_month_day> dates,
+                  const OnLogRead &onLog) const override;
+    [[nodiscard]] utils::date::Dates listLogDates(std::chrono::year year) const override;
+    [[nodiscard]] std::vector<std::chrono::year> listLogYears() const override;
+    [[nodiscard]] std::optional<LogFileFingerprint>
+    fingerprint(const std::chrono::year_month_day &date) const override;
     void remove(const std::chrono::year_month_day &date) override;
+    /**
+     * Replaces the log at once by renaming a temporary file over it, so the logs mapped by
+     * `readMany` are never truncated under their readers. A symlinked log is replaced at its
+     * target and keeps its permissions.
+     */
     void write(const LogFile &log) override;
 };
 
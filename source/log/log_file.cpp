@@ -1,39 +1,188 @@
 #include "log_file.hpp"
 
 #include "utils/string.hpp"
-#include <functional>
+#include <algorithm>
+#include <array>
+#include <cctype>
+#include <charconv>
+#include <cmath>
+#include <cstddef>
+#include <memory_resource>
+#include <numeric>
+#include <optional>
 #include <ranges>
-#include <regex>
-#include <sstream>
+#include <string_view>
+#include <utility>
+#include <vector>
 
 namespace caps_log::log {
 
 namespace {
 
+constexpr std::string_view kLineWhitespace = " \t\n";
+constexpr std::string_view kSectionTitleWhitespace = " \t\n\v\f\r";
+constexpr std::string_view kCodeBlockFence = "```";
+
+/**
+ * Matches a trimmed line against the section grammar `^# \s*(.*?)\s*$` and returns the view of
+ * the (possibly empty) title on success.
+ */
+std::optional<std::string_view> matchSectionTitle(std::string_view line) {
+    if (not line.starts_with("# ")) {
+        return std::nullopt;
+    }
+    const auto title = utils::trimView(line.substr(2), kSectionTitleWhitespace);
+    // `.` does not match line terminators so those are only allowed as surrounding whitespace
+    if (title.find_first_of("\r\n") != std::string_view::npos) {
+        return std::nullopt;
+    }
+    return title;
+}
+
+constexpr bool isTagTitleChar(char chr) {
+    return (chr >= 'a' && chr <= 'z') || (chr >= 'A' && chr <= 'Z') || (chr >= '0' && chr <= '9') ||
+           chr == ' ' || chr == '-';
+}
+
+struct TagSuffix {
+    std::string_view group;
+    std::string_view info;
+};
+
+/**
+ * Splits what follows a tag title into the content of its `(group)` and its `: info`, fails
+ * unless it is either nothing, a group, an info or a group followed by an info.
+ */
+std::optional<TagSuffix> splitTagSuffix(std::string_view suffix) {
+    if (suffix.empty()) {
+        return TagSuffix{};
+    }
+    if (suffix.find('\0') != std::string_view::npos) {
+        return std::nullopt;
+    }
+    if (suffix.front() == ':') {
+        return TagSuffix{.group = {}, .info = suffix.substr(1)};
+    }
+    if (suffix.front() != '(') {
+        return std::nullopt;
+    }
+    // the group has to contain at least one character and can only be followed by a `:` suffix
+    for (auto idx = suffix.size() - 1; idx >= 2; idx--) {
+        if (suffix[idx] == ')' && (idx + 1 == suffix.size() || suffix[idx + 1] == ':')) {
+            return TagSuffix{.group = suffix.substr(1, idx - 1),
+                             .info = suffix.substr(std::min(idx + 2, suffix.size()))};
+        }
+    }
+    return std::nullopt;
+}
+
 /**
- * A bunch of regexes and group indexes for matching sections and tags.
+ * Parses the number `text` starts with, e.g. `72.4` of ` 72.4 kg`. Text that does not start with
+ * a finite number, or where the number runs on like in `1,5`, `10.5.2024` or `5/10`, is not a
+ * value.
  */
-const auto kSectionTitleRegex = std::regex{"^# \\s*(.*?)\\s*$"};
-const auto kTagRegex =
-    std::regex{R"(^( +)?\*( +)([a-z A-Z 0-9 -]+)(\(.+\))?(:.*)?)", std::regex_constants::extended};
+std::optional<double> parseTagValue(std::string_view text) {
+    text = utils::trimView(text, " \t");
+    double value{};
+    const auto *const end = text.data() + text.size();
+    const auto [numberEnd, error] = std::from_chars(text.data(), end, value);
+    if (error != std::errc{} || not std::isfinite(value)) {
+        return std::nullopt;
+    }
+    if (numberEnd != end) {
+        const auto next = static_cast<unsigned char>(*numberEnd);
+        if (std::isspace(next) == 0 && std::isalpha(next) == 0 && next != '%') {
+            return std::nullopt;
+        }
+    }
+    return value;
+}
+
+struct MatchedTag {
+    std::string_view title;
+    TagSuffix suffix;
+
+    /**
+     * The number of the group, or of the info if the group has none.
+     */
+    [[nodiscard]] std::optional<double> value() const {
+        if (suffix.group.empty() && suffix.info.empty()) {
+            return std::nullopt;
+        }
+        if (const auto value = parseTagValue(suffix.group)) {
+            return value;
+        }
+        return parseTagValue(suffix.info);
+    }
+};
+
+/**
+ * Matches a trimmed line against the tag grammar `^\*( +)([a-z A-Z 0-9 -]+)(\(.+\))?(:.*)?` and
+ * returns the view of the trimmed title and what follows it on success.
+ */
+std::optional<MatchedTag> matchTag(std::string_view line) {
+    if (not line.starts_with("* ")) {
+        return std::nullopt;
+    }
+    const auto titleEnd = std::ranges::find_if_not(line.begin() + 1, line.end(), isTagTitleChar);
+    const auto titleRange = std::string_view{line.begin() + 1, titleEnd};
+    // needs at least one leading space and one title character
+    if (titleRange.size() < 2) {
+        return std::nullopt;
+    }
+    const auto suffix = splitTagSuffix(std::string_view{titleEnd, line.end()});
+    if (not suffix) {
+        return std::nullopt;
+    }
+    return MatchedTag{.title = utils::trimView(titleRange), .suffix = *suffix};
+}
+
+constexpr bool isTaskTagChar(char chr) {
+    return (chr >= 'a' && chr <= 'z') || (chr >= 'A' && chr <= 'Z') || (chr >= '0' && chr <= '9') ||
+           chr == '_' || chr == ':' || chr == '[';
+}
 
-const auto kTaskRegex =
-    std::regex{R"(^ *(- )?\[(.)] *(\(([[a-zA-Z0-9_:]*)\))? *([\sa-zA-Z0-9_-]*)( *):?( *)(.*))",
-               std::regex_constants::extended};
-const auto kTaskTitleMatch{5};
-const auto kTagTitleMatch{3};
-const auto kSectionTitleMatch{1};
+/**
+ * Matches a trimmed line against the task grammar
+ * `^(- )?\[(.)] *(\(([[a-zA-Z0-9_:]*)\))? *(.*)` and returns the task on success, the title is
+ * the trimmed rest of the line. Tasks without a title are not matched, those are usually an empty
+ * template.
+ */
+std::optional<LogTask> matchTask(std::string_view line) {
+    if (line.starts_with("- ")) {
+        line.remove_prefix(2);
+    }
+    if (line.size() < 3 || line[0] != '[' || line[2] != ']') {
+        return std::nullopt;
+    }
+    LogTask task{.mark = line[1], .tag = {}, .title = {}};
+    line = utils::trimView(line.substr(3), " ");
+    if (line.starts_with('(')) {
+        const auto tagEnd = std::ranges::find_if_not(line.begin() + 1, line.end(), isTaskTagChar);
+        if (tagEnd != line.end() && *tagEnd == ')') {
+            task.tag = std::string_view{line.begin() + 1, tagEnd};
+            line = utils::trimView(std::string_view{tagEnd + 1, line.end()}, " ");
+        }
+    }
+    task.title = utils::trimView(line, " \t");
+    if (task.title.empty()) {
+        return std::nullopt;
+    }
+    return task;
+}
 
 /**
- * A function that goes through a log file and calls a function for each line that is
+ * A function that goes through a log file and calls a function for each trimmed line that is
  * not inside a markdown code block.
  */
-void forEachLogLine(std::istream &input, const std::function<void(const std::string &)> &func) {
-    std::string line;
+template <typename Func> void forEachLogLine(std::string_view input, Func &&func) {
     bool isInsideCodeBlock = false;
-    while (getline(input, line)) {
-        line = utils::lowercase(utils::trim(line));
-        if (line.substr(0, 3) == "```") {
+    while (not input.empty()) {
+        const auto lineEnd = std::min(input.find('\n'), input.size());
+        const auto line = utils::trimView(input.substr(0, lineEnd), kLineWhitespace);
+        input.remove_prefix(std::min(lineEnd + 1, input.size()));
+
+        if (line.starts_with(kCodeBlockFence)) {
             isInsideCodeBlock = !isInsideCodeBlock;
         }
 
@@ -46,44 +195,172 @@ void forEachLogLine(std::istream &input, const std::function<void(const std::str
 
 } // namespace
 
+/**
+ * Everything a parse allocates comes from the arena, which starts in a buffer allocated together
+ * with it, so parsing a typical log allocates once.
+ */
+struct LogFile::ParsedLog {
+    static constexpr std::size_t kInitialArenaSize = 1024;
+
+    std::array<std::byte, kInitialArenaSize> initialBuffer;
+    std::pmr::monotonic_buffer_resource arena{initialBuffer.data(), initialBuffer.size()};
+    std::pmr::vector<std::string_view> tags{&arena};
+    std::pmr::vector<LogSection> sections{&arena};
+    std::pmr::vector<LogTagValue> values{&arena};
+    std::pmr::vector<LogTask> tasks{&arena};
+
+    ParsedLog() = default;
+    ParsedLog(const ParsedLog &) = delete;
+    ParsedLog(ParsedLog &&) = delete;
+    ParsedLog &operator=(const ParsedLog &) = delete;
+    ParsedLog &operator=(ParsedLog &&) = delete;
+    ~ParsedLog() = default;
+
+    /**
+     * Returns `title` itself if it is lowercase already, otherwise a lowercased copy in the arena.
+     */
+    std::string_view lowercase(std::string_view title) {
+        const auto isUpper = [](char chr) { return chr >= 'A' && chr <= 'Z'; };
+        if (std::ranges::none_of(title, isUpper)) {
+            return title;
+        }
+        auto *copy = static_cast<char *>(arena.allocate(title.size(), alignof(char)));
+        std::ranges::transform(title, copy, [](char chr) {
+            return static_cast<char>(std::tolower(static_cast<unsigned char>(chr)));
+        });
+        return {copy, title.size()};
+    }
+};
+
 LogFile &LogFile::parse(bool skipFirstLine) {
-    std::stringstream sstream{m_content};
+    auto parsed = std::make_shared<ParsedLog>();
+    auto &arena = parsed->arena;
 
-    std::string lastSection = kRootSectionKey.data();
+    // sections in the order they were found and the tags by the index of their section, a log has
+    // few sections so they are looked up linearly
+    std::pmr::vector<std::string_view> titles{&arena};
+    std::pmr::vector<std::pair<std::size_t, std::string_view>> tags{&arena};
+    std::pmr::vector<std::pair<std::size_t, LogTagValue>> values{&arena};
+    const auto sectionIndex = [&titles](std::string_view title) {
+        const auto found = std::ranges::find(titles, title);
+        if (found != titles.end()) {
+            return static_cast<std::size_t>(found - titles.begin());
+        }
+        titles.push_back(title);
+        return titles.size() - 1;
+    };
+    // the root section is only added once it has a tag
+    std::optional<std::size_t> lastSection;
 
-    forEachLogLine(sstream, [&](const auto &line) {
-        if (std::smatch smatch; std::regex_match(line, smatch, kSectionTitleRegex)) {
+    forEachLogLine(m_content, [&](std::string_view line) {
+        if (const auto section = matchSectionTitle(line)) {
             if (not skipFirstLine) {
-                lastSection = utils::trim(smatch[kSectionTitleMatch]);
-                m_tagsPerSection[lastSection] = {};
+                lastSection = sectionIndex(parsed->lowercase(*section));
+                // a repeated section starts over
+                const auto isInSection = [&](const auto &entry) {
+                    return entry.first == *lastSection;
+                };
+                std::erase_if(tags, isInSection);
+                std::erase_if(values, isInSection);
+            }
+        } else if (const auto tag = matchTag(line)) {
+            if (not lastSection) {
+                lastSection = sectionIndex(kRootSectionKey);
             }
-        } else if (std::smatch smatch; std::regex_match(line, smatch, kTagRegex)) {
-            m_tagsPerSection[lastSection].insert(utils::trim(smatch[kTagTitleMatch]));
+            const auto title = parsed->lowercase(tag->title);
+            tags.emplace_back(*lastSection, title);
+            if (const auto value = tag->value()) {
+                values.emplace_back(*lastSection, LogTagValue{.tag = title, .value = *value});
+            }
+        } else if (const auto task = matchTask(line)) {
+            parsed->tasks.push_back(*task);
         }
         skipFirstLine = false;
     });
 
+    std::pmr::vector<std::size_t> order{&arena};
+    order.resize(titles.size());
+    std::iota(order.begin(), order.end(), std::size_t{0});
+    std::ranges::sort(order, {}, [&titles](std::size_t index) { return titles[index]; });
+    std::ranges::sort(tags, {}, [&titles](const auto &tag) {
+        return std::pair{titles[tag.first], tag.second};
+    });
+    const auto duplicates = std::ranges::unique(tags);
+    tags.erase(duplicates.begin(), duplicates.end());
+
+    // the tags are sorted by section like the sections, each section takes the next run of them
+    parsed->tags.reserve(tags.size());
+    parsed->sections.reserve(titles.size());
+    auto tag = tags.begin();
+    for (const auto index : order) {
+        const auto first = parsed->tags.size();
+        for (; tag != tags.end() && tag->first == index; ++tag) {
+            parsed->tags.push_back(tag->second);
+        }
+        parsed->sections.push_back(LogSection{
+            .title = titles[index],
+            .tags = std::span{parsed->tags}.subspan(first, parsed->tags.size() - first),
+        });
+    }
+
+    // values are per tag regardless of the section, a repeated tag keeps the value found last
+    std::ranges::stable_sort(values, {}, [](const auto &entry) { return entry.second.tag; });
+    for (const auto &[section, value] : values) {
+        if (not parsed->values.empty() && parsed->values.back().tag == value.tag) {
+            parsed->values.back() = value;
+        } else {
+            parsed->values.push_back(value);
+        }
+    }
+
+    m_parsed = std::move(parsed);
     return *this;
 }
 
+std::span<const LogSection> LogFile::getSections() const {
+    if (not m_parsed) {
+        return {};
+    }
+    return m_parsed->sections;
+}
+
+std::span<const LogTagValue> LogFile::getTagValues() const {
+    if (not m_parsed) {
+        return {};
+    }
+    return m_parsed->values;
+}
+
+std::span<const LogTask> LogFile::getTasks() const {
+    if (not m_parsed) {
+        return {};
+    }
+    return m_parsed->tasks;
+}
+
 std::set<std::string> LogFile::getTagTitles() const {
     std::set<std::string> tags;
-    for (const auto &tagsPerSection : std::views::values(m_tagsPerSection)) {
-        tags.insert(tagsPerSection.begin(), tagsPerSection.end());
+    for (const auto &section : getSections()) {
+        tags.insert(section.tags.begin(), section.tags.end());
     }
     return tags;
 }
 
 std::set<std::string> LogFile::getSectionTitles() const {
     std::set<std::string> sections;
-    for (const auto &section : std::views::keys(m_tagsPerSection)) {
-        sections.insert(section);
+    for (const auto &section : getSections()) {
+        sections.emplace(section.title);
     }
     return sections;
 }
 
 std::map<std::string, std::set<std::string>> LogFile::getTagsPerSection() const {
-    return m_tagsPerSection;
+    std::map<std::string, std::set<std::string>> tagsPerSection;
+    for (const auto &section : getSections()) {
+        tagsPerSection.emplace(std::string{section.title},
+                               std::set<std::string>{section.tags.begin(), section.tags.end()});
+    }
+    return tagsPerSection;
 }
 
 } // namespace caps_log::log
@@ -1,31 +1,99 @@
 #pragma once
 
+#include "utils/mapped_file.hpp"
+
 #include <chrono>
 #include <map>
+#include <memory>
 #include <set>
+#include <span>
 #include <string>
+#include <string_view>
 
 namespace caps_log::log {
 
+/**
+ * A section of a parsed log with its tags, both lowercased and sorted. The views point into the
+ * log file that was parsed and stay valid as long as any copy of it is alive.
+ */
+struct LogSection {
+    std::string_view title;
+    std::span<const std::string_view> tags;
+};
+
+/**
+ * The number a tag is annotated with, e.g. `72.4` of `* weight (72.4)` or `7.5` of `* sleep: 7.5`.
+ * The tag is lowercased like the tags of `LogSection` and points into the log file the same way.
+ */
+struct LogTagValue {
+    std::string_view tag;
+    double value;
+};
+
+/**
+ * A `- [ ] (tag) title` task of a parsed log, the views point into the log file like the ones of
+ * `LogSection`. The mark is the character between the brackets, a space for an open task.
+ */
+struct LogTask {
+    char mark;
+    std::string_view tag;
+    std::string_view title;
+
+    [[nodiscard]] bool isOpen() const { return mark == ' '; }
+};
+
 /*
  * Represents a log file with a specific date and content.
- * The content is a string that contains the entire log file (in markdown format) and
- * the date is the date of the log file.
+ * The content is the entire log file (in markdown format) and the date is the date of the log
+ * file. The content is immutable and shared between the copies of a log file, it is either a heap
+ * string (e.g. a decrypted log) or a memory mapped file. A mapped log must not be held for long as
+ * the file can be truncated under its readers (see `MappedFile`).
  */
 class LogFile {
-    std::string m_content;
-    std::map<std::string, std::set<std::string>> m_tagsPerSection;
+    // declared first, it is initialized from the owner before the owner is moved in
+    std::string_view m_content;
+    std::shared_ptr<const void> m_contentOwner;
+    // kept in a single arena per parse, shared by the copies like the content
+    struct ParsedLog;
+    std::shared_ptr<const ParsedLog> m_parsed;
     std::chrono::year_month_day m_date;
 
   public:
     LogFile(const std::chrono::year_month_day &date, std::string content)
-        : m_date{date}, m_content{std::move(content)} {}
+        : LogFile{date, std::make_shared<const std::string>(std::move(content))} {}
+
+    LogFile(const std::chrono::year_month_day &date, std::shared_ptr<const std::string> content)
+        : m_content{*content}, m_contentOwner{std::move(content)}, m_date{date} {}
+
+    LogFile(const std::chrono::year_month_day &date, std::shared_ptr<const utils::MappedFile> file)
+        : m_content{file->data()}, m_contentOwner{std::move(file)}, m_date{date} {}
 
     LogFile &parse(bool skipFirstLine = true);
 
-    [[nodiscard]] std::string getContent() const { return m_content; }
+    /**
+     * Valid as long as any copy of this log file is alive.
+     */
+    [[nodiscard]] std::string_view getContent() const { return m_content; }
     [[nodiscard]] std::chrono::year_month_day getDate() const { return m_date; }
 
+    /**
+     * The sections found by `parse`, sorted by title. The tags before the first section are in a
+     * section titled `kRootSectionKey`.
+     */
+    [[nodiscard]] std::span<const LogSection> getSections() const;
+
+    /**
+     * The tag values found by `parse`, sorted by tag. A tag that has a value more than once keeps
+     * the last one, so a log can e.g. correct a weight further down.
+     */
+    [[nodiscard]] std::span<const LogTagValue> getTagValues() const;
+
+    /**
+     * The tasks found by `parse`, in the order they appear in the log.
+     */
+    [[nodiscard]] std::span<const LogTask> getTasks() const;
+
+    // owning copies of `getSections`
     [[nodiscard]] std::set<std::string> getSectionTitles() const;
     [[nodiscard]] std::set<std::string> getTagTitles() const;
     [[nodiscard]] std::map<std::string, std::set<std::string>> getTagsPerSection() const;
@@ -0,0 +1,181 @@
+#include "log_grep.hpp"
+
+#include <algorithm>
+#include <condition_variable>
+#include <exception>
+#include <mutex>
+#include <optional>
+#include <span>
+#include <string_view>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace caps_log::log {
+
+namespace {
+// consecutive logs read together by a worker
+constexpr std::size_t kLogsPerClaim = 16;
+
+std::vector<std::chrono::year_month_day> listDates(const LogRepositoryBase &repo,
+                                                   const GrepConfig &config) {
+    std::vector<std::chrono::year_month_day> dates;
+    for (const auto year : repo.listLogYears()) {
+        if ((config.firstYear && year < *config.firstYear) ||
+            (config.lastYear && year > *config.lastYear)) {
+            continue;
+        }
+        for (const auto &monthDay : repo.listLogDates(year)) {
+            if (const auto date = year / monthDay; date.ok()) {
+                dates.push_back(date);
+            }
+        }
+    }
+    return dates;
+}
+
+std::vector<std::string> matchingLines(const LogFile &log, const std::regex &pattern) {
+    std::vector<std::string> lines;
+    const auto &content = log.getContent();
+    std::size_t begin = 0;
+    while (begin < content.size()) {
+        const auto end = std::min(content.find('\n', begin), content.size());
+        const auto line = std::string_view{content}.substr(begin, end - begin);
+        if (std::regex_search(line.begin(), line.end(), pattern)) {
+            lines.emplace_back(line);
+        }
+        begin = end + 1;
+    }
+    return lines;
+}
+
+/**
+ * Logs are claimed in date order by the workers, a few consecutive logs at a time so they can be
+ * read together, and their results are put into a ring of `reorderWindow` slots. A worker waits
+ * before claiming a log that would overwrite a slot that was not reported yet.
+ */
+class ReorderBuffer {
+  public:
+    ReorderBuffer(std::size_t logs, std::size_t window) : m_logs{logs}, m_slots(window) {}
+
+    struct Claim {
+        std::size_t begin;
+        std::size_t end;
+    };
+
+    std::optional<Claim> claim(std::size_t maxLogs) {
+        std::unique_lock lock{m_mutex};
+        m_condition.wait(lock, [this] {
+            return m_stopped || m_claimed == m_logs || m_claimed < m_reported + m_slots.size();
+        });
+        if (m_stopped || m_claimed == m_logs) {
+            return std::nullopt;
+        }
+        const auto begin = m_claimed;
+        m_claimed = std::min({m_claimed + maxLogs, m_reported + m_slots.size(), m_logs});
+        return Claim{.begin = begin, .end = m_claimed};
+    }
+
+    void complete(std::size_t log, std::vector<std::string> lines, std::exception_ptr error) {
+        const std::unique_lock lock{m_mutex};
+        m_slots[log % m_slots.size()] =
+            Slot{.done = true, .lines = std::move(lines), .error = std::move(error)};
+        m_condition.notify_all();
+    }
+
+    std::vector<std::string> takeNext() {
+        std::unique_lock lock{m_mutex};
+        auto &slot = m_slots[m_reported % m_slots.size()];
+        m_condition.wait(lock, [&slot] { return slot.done; });
+        auto next = std::exchange(slot, Slot{});
+        m_reported++;
+        m_condition.notify_all();
+        if (next.error) {
+            std::rethrow_exception(next.error);
+        }
+        return std::move(next.lines);
+    }
+
+    void stop() {
+        const std::unique_lock lock{m_mutex};
+        m_stopped = true;
+        m_condition.notify_all();
+    }
+
+  private:
+    struct Slot {
+        bool done = false;
+        std::vector<std::string> lines;
+        std::exception_ptr error;
+    };
+
+    std::mutex m_mutex;
+    std::condition_variable m_condition;
+    std::size_t m_logs;
+    std::size_t m_claimed = 0;
+    std::size_t m_reported = 0;
+    bool m_stopped = false;
+    std::vector<Slot> m_slots;
+};
+} // namespace
+
+std::size_t grepLogs(const LogRepositoryBase &repo, const std::regex &pattern,
+                     const GrepConfig &config,
+                     const std::function<void(const GrepMatch &)> &onMatch) {
+    const auto dates = listDates(repo, config);
+    auto workers = config.workers == 0 ? std::max(1U, std::thread::hardware_concurrency())
+                                       : config.workers;
+    workers = std::min<unsigned>(workers, dates.size());
+
+    ReorderBuffer buffer{dates.size(), std::max<std::size_t>(1, config.reorderWindow)};
+    const auto work = [&]() {
+        while (const auto claim = buffer.claim(kLogsPerClaim)) {
+            const auto claimed = std::span{dates}.subspan(claim->begin, claim->end - claim->begin);
+            std::vector<bool> completed(claimed.size());
+            try {
+                repo.readMany(claimed, [&](const LogFile &log) {
+                    const auto offset = static_cast<std::size_t>(
+                        std::ranges::lower_bound(claimed, log.getDate()) - claimed.begin());
+                    buffer.complete(claim->begin + offset, matchingLines(log, pattern), nullptr);
+                    completed[offset] = true;
+                });
+            } catch (...) {
+                // reported at the first log of the claim that was not searched
+                const auto first = std::ranges::find(completed, false);
+                if (first != completed.end()) {
+                    buffer.complete(claim->begin + (first - completed.begin()), {},
+                                    std::current_exception());
+                    *first = true;
+                }
+            }
+            // logs that do not exist have no matching lines
+            for (std::size_t i = 0; i < completed.size(); i++) {
+                if (not completed[i]) {
+                    buffer.complete(claim->begin + i, {}, nullptr);
+                }
+            }
+        }
+    };
+    // declared after the buffer so the workers are joined before it is destroyed
+    std::vector<std::jthread> threads;
+    threads.reserve(workers);
+    for (unsigned worker = 0; worker < workers; worker++) {
+        threads.emplace_back(work);
+    }
+
+    std::size_t matches = 0;
+    try {
+        for (const auto &date : dates) {
+            for (auto &line : buffer.takeNext()) {
+                onMatch(GrepMatch{.date = date, .line = std::move(line)});
+                matches++;
+            }
+        }
+    } catch (...) {
+        buffer.stop();
+        throw;
+    }
+    return matches;
+}
+
+} // namespace caps_log::log
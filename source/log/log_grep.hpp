@@ -0,0 +1,41 @@
+#pragma once
+
+#include "log_repository_base.hpp"
+
+#include <chrono>
+#include <cstddef>
+#include <functional>
+#include <optional>
+#include <regex>
+#include <string>
+
+namespace caps_log::log {
+
+struct GrepMatch {
+    std::chrono::year_month_day date;
+    std::string line;
+};
+
+struct GrepConfig {
+    // inclusive bounds of the searched years, no value means unbounded
+    std::optional<std::chrono::year> firstYear;
+    std::optional<std::chrono::year> lastYear;
+    // number of threads reading logs, 0 means one per hardware thread
+    unsigned workers = 0;
+    // how many logs may be read ahead of the oldest one whose matches were not reported yet,
+    // bounds the memory used no matter how many logs there are
+    std::size_t reorderWindow = 64;
+};
+
+/**
+ * Calls `onMatch` on the calling thread for every line of the logs that matches the pattern, in
+ * date order. Logs are read in parallel and a log's matches are reported as soon as all earlier
+ * logs are done, so output starts before the whole repository is read. Exceptions from the
+ * repository or from `onMatch` stop the workers and are rethrown here.
+ * @return The number of matching lines.
+ */
+std::size_t grepLogs(const LogRepositoryBase &repo, const std::regex &pattern,
+                     const GrepConfig &config,
+                     const std::function<void(const GrepMatch &)> &onMatch);
+
+} // namespace caps_log::log
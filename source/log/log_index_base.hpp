@@ -0,0 +1,43 @@
+#pragma once
+
+#include "log_file.hpp"
+
+#include <chrono>
+#include <span>
+
+namespace caps_log::log {
+
+/**
+ * An in memory index of the logs of all years. It is filled and kept up to date by a
+ * `LogIndexer`, which reads and parses each log once for all of its indexes. Implementations
+ * have to be thread safe, they are written from the indexer's thread while being queried.
+ */
+class LogIndexBase {
+  public:
+    LogIndexBase() = default;
+    virtual ~LogIndexBase() = default;
+
+    LogIndexBase(const LogIndexBase &) = delete;
+    LogIndexBase(LogIndexBase &&) = delete;
+    LogIndexBase &operator=(const LogIndexBase &) = delete;
+    LogIndexBase &operator=(LogIndexBase &&) = delete;
+
+    /**
+     * Indexes the parsed log (see `LogFile::parse`), replacing what was indexed for its date
+     * before.
+     */
+    virtual void update(const LogFile &log) = 0;
+    /**
+     * Indexes a batch of parsed logs like `update` does one by one. Indexes that keep sorted
+     * arrays override it to merge a whole batch in at once.
+     */
+    virtual void updateMany(std::span<const LogFile> logs) {
+        for (const auto &log : logs) {
+            update(log);
+        }
+    }
+    virtual void remove(const std::chrono::year_month_day &date) = 0;
+    virtual void clear() = 0;
+};
+
+} // namespace caps_log::log
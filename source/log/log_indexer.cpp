@@ -0,0 +1,103 @@
+#include "log_indexer.hpp"
+
+#include <utility>
+
+namespace caps_log::log {
+
+LogIndexer::LogIndexer(std::vector<std::shared_ptr<LogIndexBase>> indexes, bool skipFirstLine)
+    : m_indexes{std::move(indexes)}, m_skipFirstLine{skipFirstLine} {}
+
+void LogIndexer::build(std::shared_ptr<const LogRepositoryBase> repo) {
+    // posted under the lock so a concurrent `clear` either cancels this build or comes after it
+    const std::unique_lock lock{m_mutex};
+    m_building = true;
+    m_builder.post([this, repo = std::move(repo)](const auto &token) {
+        try {
+            const auto years = repo->listLogYears();
+            for (auto year = years.rbegin(); year != years.rend(); ++year) {
+                if (token.isCancelled()) {
+                    return;
+                }
+                std::vector<std::chrono::year_month_day> dates;
+                for (const auto monthDay : repo->listLogDates(*year)) {
+                    if (const auto date = *year / monthDay; date.ok() && not contains(date)) {
+                        dates.push_back(date);
+                    }
+                }
+                // a year is read and indexed at once, so the indexes can merge it in as a batch
+                std::vector<LogFile> logs;
+                repo->readMany(dates, [this, &logs, &token](LogFile log) {
+                    if (not token.isCancelled()) {
+                        log.parse(m_skipFirstLine);
+                        logs.push_back(std::move(log));
+                    }
+                });
+
+                const std::unique_lock lock{m_mutex};
+                // checked under the lock so nothing is inserted after a `clear`, and logs written
+                // or removed since they were read are not overwritten
+                if (token.isCancelled()) {
+                    return;
+                }
+                std::erase_if(logs, [this](const LogFile &log) {
+                    return m_indexed.contains(log.getDate()) ||
+                           m_removedDuringBuild.contains(log.getDate());
+                });
+                insert(logs);
+            }
+        } catch (const std::exception &) {
+            // the logs that could not be read are indexed once they are written
+        }
+        const std::unique_lock lock{m_mutex};
+        if (not token.isCancelled()) {
+            m_building = false;
+            m_removedDuringBuild.clear();
+        }
+    });
+}
+
+void LogIndexer::waitForBuild() { m_builder.wait(); }
+
+void LogIndexer::update(LogFile log) {
+    log.parse(m_skipFirstLine);
+    const std::unique_lock lock{m_mutex};
+    insert(std::span{&log, 1});
+}
+
+void LogIndexer::remove(const std::chrono::year_month_day &date) {
+    const std::unique_lock lock{m_mutex};
+    for (const auto &index : m_indexes) {
+        index->remove(date);
+    }
+    m_indexed.erase(date);
+    if (m_building) {
+        m_removedDuringBuild.insert(date);
+    }
+}
+
+void LogIndexer::clear() {
+    const std::unique_lock lock{m_mutex};
+    m_builder.cancel();
+    for (const auto &index : m_indexes) {
+        index->clear();
+    }
+    m_indexed.clear();
+    m_building = false;
+    m_removedDuringBuild.clear();
+}
+
+bool LogIndexer::contains(const std::chrono::year_month_day &date) const {
+    const std::unique_lock lock{m_mutex};
+    return m_indexed.contains(date);
+}
+
+void LogIndexer::insert(std::span<const LogFile> logs) {
+    for (const auto &index : m_indexes) {
+        index->updateMany(logs);
+    }
+    for (const auto &log : logs) {
+        m_indexed.insert(log.getDate());
+    }
+}
+
+} // namespace caps_log::log
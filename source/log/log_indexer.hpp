@@ -0,0 +1,78 @@
+#pragma once
+
+#include "log_file.hpp"
+#include "log_index_base.hpp"
+#include "log_repository_base.hpp"
+#include "utils/task_executor.hpp"
+
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <span>
+#include <vector>
+
+namespace caps_log::log {
+
+/**
+ * Fills a set of `LogIndexBase`s with the logs of all years on a background thread and keeps them
+ * up to date with `update` and `remove`, which only touch the date of the given log. Each log is
+ * read and parsed once, however many indexes there are. All methods are thread safe.
+ */
+class LogIndexer {
+  public:
+    /**
+     * The logs are parsed with the given `skipFirstLine`, see `LogFile::parse`.
+     */
+    LogIndexer(std::vector<std::shared_ptr<LogIndexBase>> indexes, bool skipFirstLine);
+    ~LogIndexer() = default;
+
+    LogIndexer(const LogIndexer &) = delete;
+    LogIndexer(LogIndexer &&) = delete;
+    LogIndexer &operator=(const LogIndexer &) = delete;
+    LogIndexer &operator=(LogIndexer &&) = delete;
+
+    /**
+     * Indexes all the logs of the repository on a background thread, most recent years first.
+     * Logs indexed or removed in the meantime through `update` and `remove` are left as they are.
+     * A newer call (or `clear`) cancels the logs not indexed yet.
+     */
+    void build(std::shared_ptr<const LogRepositoryBase> repo);
+
+    /**
+     * Blocks until the builds requested so far are done.
+     */
+    void waitForBuild();
+
+    /**
+     * Parses the log and indexes it in all indexes, replacing what was indexed for its date
+     * before.
+     */
+    void update(LogFile log);
+    void remove(const std::chrono::year_month_day &date);
+    void clear();
+
+    [[nodiscard]] bool contains(const std::chrono::year_month_day &date) const;
+
+  private:
+    std::vector<std::shared_ptr<LogIndexBase>> m_indexes;
+    bool m_skipFirstLine;
+
+    // held while the indexes are written, so a build never overwrites a newer `update`
+    mutable std::mutex m_mutex;
+    std::set<std::chrono::year_month_day> m_indexed;
+    // logs removed while a build is running, so it does not put them back
+    std::set<std::chrono::year_month_day> m_removedDuringBuild;
+    // removals are only recorded while set, so they do not pile up between builds
+    bool m_building = false;
+
+    // declared last so the worker is joined before the indexer is destroyed
+    utils::CancellableTaskExecutor m_builder;
+
+    /**
+     * Expects `m_mutex` to be held.
+     */
+    void insert(std::span<const LogFile> logs);
+};
+
+} // namespace caps_log::log
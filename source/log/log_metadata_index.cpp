@@ -0,0 +1,381 @@
+#include "log_metadata_index.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <type_traits>
+#include <unordered_map>
+
+namespace caps_log::log {
+
+using detail::RawIndexEntry;
+using detail::RawIndexHeader;
+using detail::RawIndexPair;
+
+namespace {
+
+static_assert(std::is_trivially_copyable_v<RawIndexHeader> && sizeof(RawIndexHeader) == 40);
+static_assert(std::is_trivially_copyable_v<RawIndexEntry> && sizeof(RawIndexEntry) == 40);
+static_assert(std::is_trivially_copyable_v<RawIndexPair> && sizeof(RawIndexPair) == 16);
+
+constexpr std::uint32_t kSkipFirstLineFlag = 1U;
+
+std::pair<std::int32_t, std::uint32_t> makeKey(const std::chrono::year_month_day &date) {
+    return {static_cast<int>(date.year()),
+            static_cast<std::uint32_t>(utils::date::Dates::toIndex(utils::date::monthDay(date)))};
+}
+
+std::pair<std::int32_t, std::uint32_t> makeKey(const RawIndexEntry &entry) {
+    return {entry.year, entry.dayOfYear};
+}
+
+template <typename T> std::span<const T> viewAs(std::string_view data, std::size_t count) {
+    // the file is written from the same structs and mapped at a page aligned address
+    return {reinterpret_cast<const T *>(data.data()), count}; // NOLINT
+}
+
+template <typename T> void append(std::string &out, const T &value) {
+    out.append(reinterpret_cast<const char *>(&value), sizeof(T)); // NOLINT
+}
+
+/**
+ * Collects entries, pairs and deduplicated strings of a new index file.
+ */
+class IndexWriter {
+    std::vector<RawIndexEntry> m_entries;
+    std::vector<RawIndexPair> m_pairs;
+    std::string m_strings;
+    std::unordered_map<std::string_view, std::uint32_t> m_stringOffsets;
+
+    std::uint32_t intern(std::string_view str) {
+        if (const auto iter = m_stringOffsets.find(str); iter != m_stringOffsets.end()) {
+            return iter->second;
+        }
+        const auto offset = static_cast<std::uint32_t>(m_strings.size());
+        m_strings.append(str);
+        m_stringOffsets.emplace(str, offset);
+        return offset;
+    }
+
+  public:
+    void add(const RawIndexEntry &entry, std::span<const RawIndexPair> pairs,
+             std::string_view strings) {
+        auto &added = m_entries.emplace_back(entry);
+        added.firstPair = static_cast<std::uint32_t>(m_pairs.size());
+        added.pairCount = static_cast<std::uint32_t>(pairs.size());
+        for (const auto &pair : pairs) {
+            RawIndexPair newPair{};
+            newPair.sectionOffset = intern(strings.substr(pair.sectionOffset, pair.sectionSize));
+            newPair.sectionSize = pair.sectionSize;
+            newPair.tagOffset = pair.tagOffset == RawIndexPair::kNoTag
+                                    ? RawIndexPair::kNoTag
+                                    : intern(strings.substr(pair.tagOffset, pair.tagSize));
+            newPair.tagSize = pair.tagSize;
+            m_pairs.push_back(newPair);
+        }
+    }
+
+    [[nodiscard]] std::string finish(std::uint32_t flags) const {
+        RawIndexHeader header{};
+        header.magic = LogMetadataIndex::kMagic;
+        header.version = LogMetadataIndex::kVersion;
+        header.flags = flags;
+        header.entryCount = m_entries.size();
+        header.pairCount = m_pairs.size();
+        header.stringsSize = m_strings.size();
+
+        std::string out;
+        out.reserve(sizeof(header) + (m_entries.size() * sizeof(RawIndexEntry)) +
+                    (m_pairs.size() * sizeof(RawIndexPair)) + m_strings.size());
+        append(out, header);
+        for (const auto &entry : m_entries) {
+            append(out, entry);
+        }
+        for (const auto &pair : m_pairs) {
+            append(out, pair);
+        }
+        out.append(m_strings);
+        return out;
+    }
+};
+
+} // namespace
+
+LogMetadataIndex::LogMetadataIndex(std::filesystem::path path, bool skipFirstLine)
+    : m_path{std::move(path)}, m_skipFirstLine{skipFirstLine} {
+    load();
+}
+
+void LogMetadataIndex::load() {
+    m_file.reset();
+    m_entries = {};
+    m_pairs = {};
+    m_strings = {};
+
+    std::error_code error;
+    if (not std::filesystem::exists(m_path, error)) {
+        return;
+    }
+    try {
+        m_file = std::make_shared<const utils::MappedFile>(m_path);
+    } catch (const std::runtime_error &) {
+        // the index is only a cache, an unreadable one is rebuilt
+        return;
+    }
+
+    const auto data = m_file->data();
+    RawIndexHeader header{};
+    if (data.size() < sizeof(header)) {
+        m_file.reset();
+        return;
+    }
+    std::memcpy(&header, data.data(), sizeof(header));
+    const auto flags = m_skipFirstLine ? kSkipFirstLineFlag : 0U;
+    const auto maxCount = data.size();
+    if (header.magic != kMagic || header.version != kVersion || header.flags != flags ||
+        header.entryCount > maxCount || header.pairCount > maxCount ||
+        header.stringsSize > maxCount ||
+        data.size() != sizeof(header) + (header.entryCount * sizeof(RawIndexEntry)) +
+                           (header.pairCount * sizeof(RawIndexPair)) + header.stringsSize) {
+        m_file.reset();
+        return;
+    }
+
+    auto rest = data.substr(sizeof(header));
+    const auto entries = viewAs<RawIndexEntry>(rest, header.entryCount);
+    rest.remove_prefix(header.entryCount * sizeof(RawIndexEntry));
+    const auto pairs = viewAs<RawIndexPair>(rest, header.pairCount);
+    rest.remove_prefix(header.pairCount * sizeof(RawIndexPair));
+    const auto strings = rest;
+
+    const auto isValidString = [&strings](std::uint64_t offset, std::uint64_t size) {
+        return offset <= strings.size() && size <= strings.size() - offset;
+    };
+    const auto isValidEntry = [&](const RawIndexEntry &entry) {
+        return entry.dayOfYear < utils::date::Dates::kCapacity &&
+               std::uint64_t{entry.firstPair} + entry.pairCount <= pairs.size();
+    };
+    const auto isValidPair = [&](const RawIndexPair &pair) {
+        return isValidString(pair.sectionOffset, pair.sectionSize) &&
+               (pair.tagOffset == RawIndexPair::kNoTag ||
+                isValidString(pair.tagOffset, pair.tagSize));
+    };
+    const auto isSorted =
+        std::ranges::adjacent_find(entries, [](const auto &lhs, const auto &rhs) {
+            return makeKey(lhs) >= makeKey(rhs);
+        }) == entries.end();
+    if (not isSorted || not std::ranges::all_of(entries, isValidEntry) ||
+        not std::ranges::all_of(pairs, isValidPair)) {
+        m_file.reset();
+        return;
+    }
+
+    m_entries = entries;
+    m_pairs = pairs;
+    m_strings = strings;
+}
+
+const RawIndexEntry *LogMetadataIndex::findMapped(Key key) const {
+    const auto iter = std::ranges::lower_bound(m_entries, key, {}, [](const auto &entry) {
+        return makeKey(entry);
+    });
+    if (iter == m_entries.end() || makeKey(*iter) != key) {
+        return nullptr;
+    }
+    return &*iter;
+}
+
+std::optional<LogMetadataView>
+LogMetadataIndex::find(const std::chrono::year_month_day &date) const {
+    const std::scoped_lock lock{m_mutex};
+    const auto key = makeKey(date);
+    if (const auto iter = m_overlay.find(key); iter != m_overlay.end()) {
+        if (not iter->second) {
+            return std::nullopt;
+        }
+        const auto &owned = *iter->second;
+        return LogMetadataView{owned.entry, owned.pairs, owned.strings, iter->second};
+    }
+    if (const auto *entry = findMapped(key)) {
+        return LogMetadataView{*entry, m_pairs.subspan(entry->firstPair, entry->pairCount),
+                               m_strings, m_file};
+    }
+    return std::nullopt;
+}
+
+void LogMetadataIndex::update(const std::chrono::year_month_day &date,
+                              const LogFileFingerprint &fingerprint, std::uint64_t contentHash,
+                              const LogFile &log) {
+    updateSections(date, fingerprint, contentHash, log.getSections());
+}
+
+void LogMetadataIndex::update(const std::chrono::year_month_day &date,
+                              const LogFileFingerprint &fingerprint, std::uint64_t contentHash,
+                              const std::map<std::string, std::set<std::string>> &tagsPerSection) {
+    std::vector<std::string_view> tags;
+    for (const auto &[_, sectionTags] : tagsPerSection) {
+        tags.insert(tags.end(), sectionTags.begin(), sectionTags.end());
+    }
+    std::vector<LogSection> sections;
+    sections.reserve(tagsPerSection.size());
+    std::size_t first = 0;
+    for (const auto &[section, sectionTags] : tagsPerSection) {
+        sections.push_back(LogSection{.title = section,
+                                      .tags = std::span{tags}.subspan(first, sectionTags.size())});
+        first += sectionTags.size();
+    }
+    updateSections(date, fingerprint, contentHash, sections);
+}
+
+void LogMetadataIndex::updateSections(const std::chrono::year_month_day &date,
+                                      const LogFileFingerprint &fingerprint,
+                                      std::uint64_t contentHash,
+                                      std::span<const LogSection> sections) {
+    OwnedEntry owned;
+    const auto key = makeKey(date);
+    owned.entry.year = key.first;
+    owned.entry.dayOfYear = key.second;
+    owned.entry.size = fingerprint.size;
+    owned.entry.modificationTime = fingerprint.modificationTime;
+    owned.entry.contentHash = contentHash;
+
+    const auto addString = [&owned](std::string_view str) {
+        const auto offset = static_cast<std::uint32_t>(owned.strings.size());
+        owned.strings.append(str);
+        return offset;
+    };
+    for (const auto &[section, tags] : sections) {
+        const auto sectionOffset = addString(section);
+        const auto sectionSize = static_cast<std::uint32_t>(section.size());
+        if (tags.empty()) {
+            owned.pairs.push_back({sectionOffset, sectionSize, RawIndexPair::kNoTag, 0});
+        }
+        for (const auto &tag : tags) {
+            owned.pairs.push_back(
+                {sectionOffset, sectionSize, addString(tag), static_cast<std::uint32_t>(tag.size())});
+        }
+    }
+    owned.entry.pairCount = static_cast<std::uint32_t>(owned.pairs.size());
+
+    const std::scoped_lock lock{m_mutex};
+    m_overlay.insert_or_assign(key, std::make_shared<const OwnedEntry>(std::move(owned)));
+}
+
+void LogMetadataIndex::updateFingerprint(const std::chrono::year_month_day &date,
+                                         const LogFileFingerprint &fingerprint) {
+    const std::scoped_lock lock{m_mutex};
+    const auto key = makeKey(date);
+    OwnedEntry owned;
+    if (const auto iter = m_overlay.find(key); iter != m_overlay.end()) {
+        if (not iter->second) {
+            return;
+        }
+        owned = *iter->second;
+    } else {
+        const auto *mapped = findMapped(key);
+        if (mapped == nullptr) {
+            return;
+        }
+        // copy the mapped entry into the overlay
+        owned.entry = *mapped;
+        owned.entry.firstPair = 0;
+        for (auto pair : m_pairs.subspan(mapped->firstPair, mapped->pairCount)) {
+            const auto sectionOffset = static_cast<std::uint32_t>(owned.strings.size());
+            owned.strings.append(m_strings.substr(pair.sectionOffset, pair.sectionSize));
+            pair.sectionOffset = sectionOffset;
+            if (pair.tagOffset != RawIndexPair::kNoTag) {
+                const auto tagOffset = static_cast<std::uint32_t>(owned.strings.size());
+                owned.strings.append(m_strings.substr(pair.tagOffset, pair.tagSize));
+                pair.tagOffset = tagOffset;
+            }
+            owned.pairs.push_back(pair);
+        }
+    }
+    owned.entry.size = fingerprint.size;
+    owned.entry.modificationTime = fingerprint.modificationTime;
+    m_overlay.insert_or_assign(key, std::make_shared<const OwnedEntry>(std::move(owned)));
+}
+
+void LogMetadataIndex::erase(const std::chrono::year_month_day &date) {
+    const std::scoped_lock lock{m_mutex};
+    const auto key = makeKey(date);
+    if (findMapped(key) != nullptr) {
+        m_overlay.insert_or_assign(key, nullptr);
+    } else {
+        m_overlay.erase(key);
+    }
+}
+
+void LogMetadataIndex::retain(std::chrono::year year, const utils::date::Dates &dates) {
+    const std::scoped_lock lock{m_mutex};
+    const auto yearValue = static_cast<int>(year);
+    const auto isStale = [&dates](std::uint32_t dayOfYear) {
+        return not dates.contains(utils::date::Dates::fromIndex(dayOfYear));
+    };
+    for (const auto &entry : m_entries) {
+        if (entry.year == yearValue && isStale(entry.dayOfYear)) {
+            m_overlay.insert_or_assign(makeKey(entry), nullptr);
+        }
+    }
+    std::erase_if(m_overlay, [&](const auto &keyAndEntry) {
+        const auto &[key, entry] = keyAndEntry;
+        return entry && key.first == yearValue && isStale(key.second);
+    });
+}
+
+std::string LogMetadataIndex::serialize() const {
+    IndexWriter writer;
+    auto overlayIter = m_overlay.begin();
+    const auto addOverlayUntil = [&](std::optional<Key> key) {
+        for (; overlayIter != m_overlay.end() && (not key || overlayIter->first < *key);
+             ++overlayIter) {
+            if (const auto &owned = overlayIter->second) {
+                writer.add(owned->entry, owned->pairs, owned->strings);
+            }
+        }
+    };
+    for (const auto &entry : m_entries) {
+        const auto key = makeKey(entry);
+        addOverlayUntil(key);
+        if (overlayIter != m_overlay.end() && overlayIter->first == key) {
+            continue; // replaced or erased, added with the rest of the overlay
+        }
+        writer.add(entry, m_pairs.subspan(entry.firstPair, entry.pairCount), m_strings);
+    }
+    addOverlayUntil(std::nullopt);
+    return writer.finish(m_skipFirstLine ? kSkipFirstLineFlag : 0U);
+}
+
+void LogMetadataIndex::save() {
+    const std::scoped_lock lock{m_mutex};
+    if (m_overlay.empty()) {
+        return;
+    }
+
+    const auto content = serialize();
+    auto tmpPath = m_path;
+    tmpPath += ".tmp";
+    {
+        std::ofstream ofs{tmpPath, std::ios::binary | std::ios::trunc};
+        ofs.write(content.data(), static_cast<std::streamsize>(content.size()));
+        if (not ofs) {
+            throw std::runtime_error{"Failed to write metadata index: " + tmpPath.string()};
+        }
+    }
+
+    // on Windows a mapped file can not be replaced, so the old one is unmapped first. If a view
+    // still holds it the rename fails there and the overlay is written by the next save
+    m_file.reset();
+    std::error_code error;
+    std::filesystem::rename(tmpPath, m_path, error);
+    if (error) {
+        std::filesystem::remove(tmpPath, error);
+        load();
+        throw std::runtime_error{"Failed to replace metadata index: " + m_path.string()};
+    }
+    m_overlay.clear();
+    load();
+}
+
+} // namespace caps_log::log
@@ -0,0 +1,172 @@
+#pragma once
+
+#include "log_repository_base.hpp"
+#include "utils/date.hpp"
+#include "utils/mapped_file.hpp"
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <set>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace caps_log::log {
+
+namespace detail {
+/**
+ * Layout of the index file, all integers are stored in native byte order:
+ *   RawIndexHeader | RawIndexEntry[entryCount] | RawIndexPair[pairCount] | char[stringsSize]
+ * Entries are sorted by date, each entry owns a contiguous range of (section, tag) pairs and
+ * pairs point into a blob of deduplicated strings.
+ */
+struct RawIndexHeader {
+    std::array<char, 8> magic;
+    std::uint32_t version;
+    std::uint32_t flags;
+    std::uint64_t entryCount;
+    std::uint64_t pairCount;
+    std::uint64_t stringsSize;
+};
+
+struct RawIndexEntry {
+    std::int32_t year;
+    std::uint32_t dayOfYear;
+    std::uint64_t size;
+    std::int64_t modificationTime;
+    std::uint64_t contentHash;
+    std::uint32_t firstPair;
+    std::uint32_t pairCount;
+};
+
+struct RawIndexPair {
+    // a tag offset of `kNoTag` marks a section that has no tags
+    static constexpr std::uint32_t kNoTag = UINT32_MAX;
+    std::uint32_t sectionOffset;
+    std::uint32_t sectionSize;
+    std::uint32_t tagOffset;
+    std::uint32_t tagSize;
+};
+} // namespace detail
+
+/**
+ * View of the metadata of a single log stored in the index, keeps the storage it points into
+ * alive.
+ */
+class LogMetadataView {
+    const detail::RawIndexEntry *m_entry;
+    std::span<const detail::RawIndexPair> m_pairs;
+    std::string_view m_strings;
+    std::shared_ptr<const void> m_storage;
+
+  public:
+    LogMetadataView(const detail::RawIndexEntry &entry,
+                    std::span<const detail::RawIndexPair> pairs, std::string_view strings,
+                    std::shared_ptr<const void> storage)
+        : m_entry{&entry}, m_pairs{pairs}, m_strings{strings}, m_storage{std::move(storage)} {}
+
+    [[nodiscard]] LogFileFingerprint fingerprint() const {
+        return {.size = m_entry->size, .modificationTime = m_entry->modificationTime};
+    }
+    [[nodiscard]] std::uint64_t contentHash() const { return m_entry->contentHash; }
+
+    /**
+     * Calls `func(section, tag)` for every tag of the log and `func(section, std::nullopt)` for
+     * sections without tags.
+     */
+    template <typename Func> void forEachSectionTag(Func &&func) const {
+        for (const auto &pair : m_pairs) {
+            const auto section = m_strings.substr(pair.sectionOffset, pair.sectionSize);
+            if (pair.tagOffset == detail::RawIndexPair::kNoTag) {
+                func(section, std::optional<std::string_view>{});
+            } else {
+                func(section, std::optional{m_strings.substr(pair.tagOffset, pair.tagSize)});
+            }
+        }
+    }
+};
+
+/**
+ * A persistent index of the sections and tags of every log, together with a fingerprint of the
+ * file they were parsed from. The index file is memory mapped and queried in place, changes are
+ * kept in memory until `save` rewrites the file atomically.
+ * Lookups, updates and saves are thread safe, views returned by `find` are not affected by later
+ * changes to the index.
+ */
+class LogMetadataIndex {
+  public:
+    static constexpr std::array<char, 8> kMagic{'C', 'L', 'O', 'G', 'I', 'D', 'X', '\0'};
+    static constexpr std::uint32_t kVersion = 1;
+
+    /**
+     * Opens the index at `path`. A missing, corrupted or incompatible index file (e.g. created
+     * with a different `skipFirstLine` setting) is treated as an empty index.
+     */
+    LogMetadataIndex(std::filesystem::path path, bool skipFirstLine);
+
+    [[nodiscard]] std::optional<LogMetadataView>
+    find(const std::chrono::year_month_day &date) const;
+
+    /**
+     * Stores the sections and tags of a parsed log.
+     */
+    void update(const std::chrono::year_month_day &date, const LogFileFingerprint &fingerprint,
+                std::uint64_t contentHash, const LogFile &log);
+    void update(const std::chrono::year_month_day &date, const LogFileFingerprint &fingerprint,
+                std::uint64_t contentHash,
+                const std::map<std::string, std::set<std::string>> &tagsPerSection);
+    /**
+     * Replaces the fingerprint of an existing entry, used when a file changed on disk but its
+     * content did not.
+     */
+    void updateFingerprint(const std::chrono::year_month_day &date,
+                           const LogFileFingerprint &fingerprint);
+    void erase(const std::chrono::year_month_day &date);
+
+    /**
+     * Erases the entries of the given year that are not in `dates`.
+     */
+    void retain(std::chrono::year year, const utils::date::Dates &dates);
+
+    /**
+     * Writes the index to disk if it was changed, throws std::runtime_error on failure.
+     */
+    void save();
+
+    [[nodiscard]] const std::filesystem::path &getPath() const { return m_path; }
+
+  private:
+    struct OwnedEntry {
+        detail::RawIndexEntry entry{};
+        std::vector<detail::RawIndexPair> pairs;
+        std::string strings;
+    };
+    using Key = std::pair<std::int32_t, std::uint32_t>;
+
+    std::filesystem::path m_path;
+    bool m_skipFirstLine;
+    std::shared_ptr<const utils::MappedFile> m_file;
+    std::span<const detail::RawIndexEntry> m_entries;
+    std::span<const detail::RawIndexPair> m_pairs;
+    std::string_view m_strings;
+    // changes since the file was mapped, entries are never modified in place so views of them stay
+    // valid, nullptr marks an erased entry
+    std::map<Key, std::shared_ptr<const OwnedEntry>> m_overlay;
+    mutable std::mutex m_mutex;
+
+    void load();
+    [[nodiscard]] const detail::RawIndexEntry *findMapped(Key key) const;
+    [[nodiscard]] std::string serialize() const;
+    void updateSections(const std::chrono::year_month_day &date,
+                        const LogFileFingerprint &fingerprint, std::uint64_t contentHash,
+                        std::span<const LogSection> sections);
+};
+
+} // namespace caps_log::log
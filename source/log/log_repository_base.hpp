@@ -1,9 +1,13 @@
 #pragma once
 
 #include "log_file.hpp"
+#include "utils/date.hpp"
 
 #include <chrono>
+#include <cstdint>
+#include <functional>
 #include <optional>
+#include <span>
 #include <vector>
 
 namespace caps_log::log {
@@ -30,6 +34,17 @@ class ScratchpadRepositoryBase {
     virtual void rename(std::string oldName, std::string newName) = 0;
 };
 
+/**
+ * Cheap to obtain metadata of a stored log that changes whenever the log changes.
+ */
+struct LogFileFingerprint {
+    std::uint64_t size{};
+    std::int64_t modificationTime{};
+    bool operator==(const LogFileFingerprint &other) const = default;
+};
+
+using OnLogRead = std::function<void(LogFile)>;
+
 /*
  * Only class that actually interacts with physical files on the drive
  */
@@ -42,8 +57,82 @@ class LogRepositoryBase {
     LogRepositoryBase &operator=(LogRepositoryBase &&) = default;
     virtual ~LogRepositoryBase() = default;
 
+    /**
+     * Reads the log for the given date. The log owns its content and can be kept for as long as
+     * needed. Must be safe to call concurrently from multiple threads as long as no `write` or
+     * `remove` is running at the same time.
+     */
     [[nodiscard]] virtual std::optional<LogFile>
     read(const std::chrono::year_month_day &date) const = 0;
+
+    /**
+     * Reads the logs for the given dates and passes each one that exists to `onLog`, on the calling
+     * thread and in the order they are read rather than the order of `dates`. `onLog` must not
+     * `write` or `remove` logs. Unlike the ones of `read`, the logs may be memory mapped and are
+     * meant to be parsed or searched during the scan rather than kept. Like `read`, must be safe to
+     * call concurrently. Repositories that can read many logs at once should override it, by
+     * default the logs are read one by one.
+     */
+    virtual void readMany(std::span<const std::chrono::year_month_day> dates,
+                          const OnLogRead &onLog) const {
+        for (const auto &date : dates) {
+            if (auto log = read(date)) {
+                onLog(std::move(*log));
+            }
+        }
+    }
+
+    /**
+     * Reads all logs from `from` to `to`, both inclusive, with `readMany`.
+     */
+    void readRange(const std::chrono::year_month_day &from, const std::chrono::year_month_day &to,
+                   const OnLogRead &onLog) const {
+        std::vector<std::chrono::year_month_day> dates;
+        for (auto year = from.year(); year <= to.year(); year++) {
+            for (const auto &monthDay : listLogDates(year)) {
+                if (const auto date = year / monthDay; date.ok() && from <= date && date <= to) {
+                    dates.push_back(date);
+                }
+            }
+        }
+        readMany(dates, onLog);
+    }
+
+    /**
+     * Returns the dates in the given year for which a log exists, without reading the logs.
+     * Like `read`, must be safe to call concurrently.
+     */
+    [[nodiscard]] virtual utils::date::Dates listLogDates(std::chrono::year year) const = 0;
+
+    /**
+     * Returns the years that may have logs in ascending order, without reading the logs. Like
+     * `read`, must be safe to call concurrently.
+     */
+    [[nodiscard]] virtual std::vector<std::chrono::year> listLogYears() const = 0;
+
+    /**
+     * Returns the fingerprint of the log for the given date without reading it, nullopt if
+     * there is no such log or if the repository can not provide one.
+     */
+    [[nodiscard]] virtual std::optional<LogFileFingerprint>
+    fingerprint(const std::chrono::year_month_day & /*date*/) const {
+        return std::nullopt;
+    }
+
+    /**
+     * Hints that the logs for the given dates, in the given order, are likely to be read soon.
+     * Repositories that can load them ahead of time should do so without blocking the caller.
+     */
+    virtual void prefetch(const std::vector<std::chrono::year_month_day> & /*dates*/) {}
+
+    /**
+     * Tells the repository that the log for the given date (or any log) may have been changed
+     * behind its back, e.g. by an editor or a git pull. Repositories that keep logs in memory
+     * must not serve the old content afterwards.
+     */
+    virtual void invalidate(const std::chrono::year_month_day & /*date*/) {}
+    virtual void invalidateAll() {}
+
     virtual void write(const LogFile &log) = 0;
     virtual void remove(const std::chrono::year_month_day &date) = 0;
 };
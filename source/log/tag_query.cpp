@@ -0,0 +1,190 @@
+#include "tag_query.hpp"
+
+#include "utils/string.hpp"
+
+#include <algorithm>
+#include <utility>
+
+namespace caps_log::log {
+
+namespace {
+constexpr std::string_view kSectionPrefix = "section:";
+constexpr std::string_view kTagPrefix = "tag:";
+constexpr std::string_view kSpecialCharacters = "&|!()\"";
+constexpr std::string_view kWhitespace = " \t\n";
+} // namespace
+
+/**
+ * Recursive descent parser that emits the plan in postfix order:
+ *   or   := and ('|' and)*
+ *   and  := not ('&' not)*
+ *   not  := '!' not | '(' or ')' | term
+ *   term := ['section:' | 'tag:'] (title | '"' quoted title '"')
+ */
+class TagQuery::Compiler {
+  public:
+    explicit Compiler(std::string_view query) : m_query{query} {}
+
+    std::vector<Instruction> compile() {
+        parseOr();
+        skipWhitespace();
+        if (m_position != m_query.size()) {
+            throw TagQueryError{std::string{"Unexpected '"} + m_query[m_position] + "'",
+                                m_position};
+        }
+        return std::move(m_plan);
+    }
+
+  private:
+    std::string_view m_query;
+    std::size_t m_position = 0;
+    std::vector<Instruction> m_plan;
+
+    void skipWhitespace() {
+        m_position = std::min(m_query.find_first_not_of(kWhitespace, m_position), m_query.size());
+    }
+
+    bool accept(char character) {
+        skipWhitespace();
+        if (m_position < m_query.size() && m_query[m_position] == character) {
+            m_position++;
+            return true;
+        }
+        return false;
+    }
+
+    void parseOr() {
+        parseAnd();
+        while (accept('|')) {
+            parseAnd();
+            m_plan.push_back(
+                {.operation = Operation::Or, .section = std::nullopt, .tag = std::nullopt});
+        }
+    }
+
+    void parseAnd() {
+        parseNot();
+        while (accept('&')) {
+            parseNot();
+            m_plan.push_back(
+                {.operation = Operation::And, .section = std::nullopt, .tag = std::nullopt});
+        }
+    }
+
+    void parseNot() {
+        if (accept('!')) {
+            parseNot();
+            m_plan.push_back(
+                {.operation = Operation::Not, .section = std::nullopt, .tag = std::nullopt});
+        } else if (accept('(')) {
+            const auto opening = m_position - 1;
+            parseOr();
+            if (not accept(')')) {
+                throw TagQueryError{"Missing ')'", opening};
+            }
+        } else {
+            parseTerm();
+        }
+    }
+
+    void parseTerm() {
+        skipWhitespace();
+        const auto rest = m_query.substr(m_position);
+        const auto isSection = rest.starts_with(kSectionPrefix);
+        if (isSection) {
+            m_position += kSectionPrefix.size();
+        } else if (rest.starts_with(kTagPrefix)) {
+            m_position += kTagPrefix.size();
+        }
+
+        const auto title = parseTitle();
+        if (title.empty()) {
+            throw TagQueryError{"Expected a tag or a section", m_position};
+        }
+
+        const auto &symbols = utils::SymbolTable::global();
+        if (isSection) {
+            m_plan.push_back({.operation = Operation::Match,
+                              .section = symbols.find(title),
+                              .tag = AnnualLogData::anyOrNoTagId()});
+        } else {
+            m_plan.push_back({.operation = Operation::Match,
+                              .section = AnnualLogData::anySectionId(),
+                              .tag = symbols.find(title)});
+        }
+    }
+
+    std::string_view parseTitle() {
+        skipWhitespace();
+        if (m_position < m_query.size() && m_query[m_position] == '"') {
+            const auto closing = m_query.find('"', m_position + 1);
+            if (closing == std::string_view::npos) {
+                throw TagQueryError{"Missing closing '\"'", m_position};
+            }
+            const auto title = m_query.substr(m_position + 1, closing - m_position - 1);
+            m_position = closing + 1;
+            return title;
+        }
+        const auto end =
+            std::min(m_query.find_first_of(kSpecialCharacters, m_position), m_query.size());
+        const auto title = utils::trimView(m_query.substr(m_position, end - m_position));
+        m_position = end;
+        return title;
+    }
+};
+
+TagQuery TagQuery::compile(std::string_view query) {
+    // titles are stored lowercase, see LogFile::parse
+    const auto lowercaseQuery = utils::lowercase(std::string{query});
+
+    TagQuery compiled;
+    compiled.m_plan = Compiler{lowercaseQuery}.compile();
+
+    std::size_t depth = 0;
+    for (const auto &instruction : compiled.m_plan) {
+        if (instruction.operation == Operation::Match) {
+            depth++;
+        } else if (instruction.operation != Operation::Not) {
+            depth--;
+        }
+        compiled.m_stackDepth = std::max(compiled.m_stackDepth, depth);
+    }
+    return compiled;
+}
+
+utils::date::Dates TagQuery::evaluate(const AnnualLogData &data) const {
+    std::vector<utils::date::Dates> stack;
+    stack.reserve(m_stackDepth);
+    for (const auto &instruction : m_plan) {
+        switch (instruction.operation) {
+        case Operation::Match: {
+            const auto *dates = instruction.section && instruction.tag
+                                    ? data.findDates(*instruction.section, *instruction.tag)
+                                    : nullptr;
+            stack.push_back(dates != nullptr ? *dates : utils::date::Dates{});
+            break;
+        }
+        case Operation::Not: {
+            auto complement = data.datesWithLogs;
+            complement -= stack.back();
+            stack.back() = complement;
+            break;
+        }
+        case Operation::And: {
+            const auto rhs = stack.back();
+            stack.pop_back();
+            stack.back() &= rhs;
+            break;
+        }
+        case Operation::Or: {
+            const auto rhs = stack.back();
+            stack.pop_back();
+            stack.back() |= rhs;
+            break;
+        }
+        }
+    }
+    return stack.back();
+}
+
+} // namespace caps_log::log
@@ -0,0 +1,73 @@
+#pragma once
+
+#include "annual_log_data.hpp"
+#include "utils/date.hpp"
+#include "utils/symbol_table.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace caps_log::log {
+
+/**
+ * Thrown when a query can not be compiled, `getPosition` is the offset in the query where the
+ * problem was found.
+ */
+class TagQueryError : public std::runtime_error {
+  public:
+    TagQueryError(const std::string &message, std::size_t position)
+        : std::runtime_error{message}, m_position{position} {}
+
+    [[nodiscard]] std::size_t getPosition() const { return m_position; }
+
+  private:
+    std::size_t m_position;
+};
+
+/**
+ * A boolean expression over the tags and sections of logs, e.g.
+ * `work & !meeting | (section:health & run)`.
+ *  - `title` or `tag:title` matches the logs that have the tag in any section,
+ *  - `section:title` matches the logs that have the section,
+ *  - `!`, `&` and `|` are negation, conjunction and disjunction in decreasing precedence, negation
+ *    is relative to the days that have a log,
+ *  - titles are case insensitive and run until the next operator, they can be quoted to contain
+ *    operator characters.
+ * The query is compiled to a postfix plan of date set operations. Titles are resolved to symbol
+ * ids once, so evaluating the plan against the data of a year is a few word wide bit operations
+ * per term.
+ */
+class TagQuery {
+  public:
+    /**
+     * Throws TagQueryError if the query is not well formed.
+     */
+    [[nodiscard]] static TagQuery compile(std::string_view query);
+
+    /**
+     * Returns the days of the year of `data` whose logs match the query.
+     */
+    [[nodiscard]] utils::date::Dates evaluate(const AnnualLogData &data) const;
+
+  private:
+    enum class Operation : std::uint8_t { Match, Not, And, Or };
+
+    struct Instruction {
+        Operation operation;
+        // only for `Match`, no value means the title is not known and nothing matches
+        std::optional<utils::SymbolId> section;
+        std::optional<utils::SymbolId> tag;
+    };
+
+    class Compiler;
+
+    std::vector<Instruction> m_plan;
+    std::size_t m_stackDepth = 0;
+};
+
+} // namespace caps_log::log
@@ -0,0 +1,233 @@
+#include "tag_value_index.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <limits>
+#include <mutex>
+
+namespace caps_log::log {
+
+namespace {
+using Aggregation = TagValueIndex::Aggregation;
+using utils::date::toDay;
+
+/**
+ * Folds the values of a bucket into all the aggregations at once.
+ */
+struct Accumulator {
+    std::size_t count = 0;
+    double sum = 0;
+    double min = std::numeric_limits<double>::infinity();
+    double max = -std::numeric_limits<double>::infinity();
+
+    void add(double value) {
+        count++;
+        sum += value;
+        min = std::min(min, value);
+        max = std::max(max, value);
+    }
+
+    [[nodiscard]] std::optional<double> result(Aggregation aggregation) const {
+        if (aggregation == Aggregation::kCount) {
+            return static_cast<double>(count);
+        }
+        if (count == 0) {
+            return std::nullopt;
+        }
+        switch (aggregation) {
+        case Aggregation::kSum:
+            return sum;
+        case Aggregation::kAverage:
+            return sum / static_cast<double>(count);
+        case Aggregation::kMin:
+            return min;
+        case Aggregation::kMax:
+            return max;
+        case Aggregation::kCount:
+            break;
+        }
+        return std::nullopt;
+    }
+};
+
+/**
+ * Returns the first days of the buckets covering the years `from` to `to`, followed by the day
+ * after the last bucket.
+ */
+std::vector<std::chrono::sys_days> makeBucketBounds(TagValueIndex::Period period,
+                                                    std::chrono::year from, std::chrono::year to) {
+    using enum TagValueIndex::Period;
+
+    std::vector<std::chrono::sys_days> bounds;
+    const std::chrono::sys_days end{(to + std::chrono::years{1}) / std::chrono::January / 1};
+    if (period == kWeek) {
+        const std::chrono::sys_days first{from / std::chrono::January / 1};
+        // weeks start on monday, the first one on or before the first day of `from`
+        auto day = first - (std::chrono::weekday{first} - std::chrono::Monday);
+        for (; day < end; day += std::chrono::weeks{1}) {
+            bounds.push_back(day);
+        }
+        bounds.push_back(day);
+        return bounds;
+    }
+    for (auto year = from; year <= to; year++) {
+        if (period == kYear) {
+            bounds.emplace_back(year / std::chrono::January / 1);
+            continue;
+        }
+        for (unsigned month = 1; month <= 12; month++) {
+            bounds.emplace_back(year / std::chrono::month{month} / 1);
+        }
+    }
+    bounds.push_back(end);
+    return bounds;
+}
+} // namespace
+
+void TagValueIndex::update(const LogFile &log) {
+    const std::unique_lock lock{m_mutex};
+    erase(toDay(log.getDate()));
+    insert(log);
+}
+
+void TagValueIndex::remove(const std::chrono::year_month_day &date) {
+    const auto day = toDay(date);
+    const std::unique_lock lock{m_mutex};
+    erase(day);
+}
+
+void TagValueIndex::clear() {
+    const std::unique_lock lock{m_mutex};
+    m_series.clear();
+    m_tagsPerLog.clear();
+}
+
+utils::date::Dates TagValueIndex::datesWithValues(std::string_view tag,
+                                                  std::chrono::year year) const {
+    const std::shared_lock lock{m_mutex};
+    const auto series = m_series.find(tag);
+    if (series == m_series.end()) {
+        return {};
+    }
+    const auto column = series->second.find(year);
+    return column == series->second.end() ? utils::date::Dates{} : column->second.days;
+}
+
+std::vector<std::chrono::year> TagValueIndex::years(std::string_view tag) const {
+    std::vector<std::chrono::year> years;
+    const std::shared_lock lock{m_mutex};
+    if (const auto series = m_series.find(tag); series != m_series.end()) {
+        for (const auto &[year, column] : series->second) {
+            years.push_back(year);
+        }
+    }
+    return years;
+}
+
+std::vector<TagValueIndex::Bucket> TagValueIndex::aggregate(std::string_view tag,
+                                                            Aggregation aggregation,
+                                                            Period period, std::chrono::year from,
+                                                            std::chrono::year to) const {
+    const auto bounds = makeBucketBounds(period, from, to);
+    std::vector<Bucket> buckets;
+    buckets.reserve(bounds.size() - 1);
+
+    const std::shared_lock lock{m_mutex};
+    const auto series = m_series.find(tag);
+    for (std::size_t i = 0; i + 1 < bounds.size(); i++) {
+        Accumulator accumulator;
+        // a bucket is a run of slots of one column, or of two for a week at the turn of a year
+        for (auto begin = bounds[i]; series != m_series.end() && begin < bounds[i + 1];) {
+            const std::chrono::year_month_day date{begin};
+            const std::chrono::sys_days nextYear{(date.year() + std::chrono::years{1}) /
+                                                 std::chrono::January / 1};
+            const auto end = std::min(bounds[i + 1], nextYear);
+            if (const auto column = series->second.find(date.year());
+                column != series->second.end()) {
+                const auto first = utils::date::Dates::toIndex(utils::date::monthDay(date));
+                const auto last = utils::date::Dates::toIndex(
+                    utils::date::monthDay(std::chrono::year_month_day{end - std::chrono::days{1}}));
+                for (auto slot = first; slot <= last; slot++) {
+                    if (column->second.days.contains(utils::date::Dates::fromIndex(slot))) {
+                        accumulator.add(column->second.values.at(slot));
+                    }
+                }
+            }
+            begin = end;
+        }
+        buckets.push_back(Bucket{.begin = std::chrono::year_month_day{bounds[i]},
+                                 .value = accumulator.result(aggregation)});
+    }
+    return buckets;
+}
+
+bool TagValueIndex::contains(const std::chrono::year_month_day &date) const {
+    const std::shared_lock lock{m_mutex};
+    return m_tagsPerLog.contains(toDay(date));
+}
+
+std::string TagValueIndex::makeSparkline(std::span<const Bucket> buckets, double low,
+                                         double high) {
+    static constexpr std::array<std::string_view, 8> kBlocks{"▁", "▂", "▃", "▄",
+                                                             "▅", "▆", "▇", "█"};
+    std::string line;
+    for (const auto &bucket : buckets) {
+        if (not bucket.value) {
+            line += ' ';
+            continue;
+        }
+        // a flat series is drawn at half height
+        const auto scaled = high > low ? (*bucket.value - low) / (high - low) : 0.5;
+        const auto level = std::lround(std::clamp(scaled, 0.0, 1.0) * (kBlocks.size() - 1));
+        line += kBlocks.at(static_cast<std::size_t>(level));
+    }
+    return line;
+}
+
+void TagValueIndex::insert(const LogFile &log) {
+    // logs without values are not kept, so there is no entry for most logs
+    if (log.getTagValues().empty()) {
+        return;
+    }
+    const auto day = toDay(log.getDate());
+    const auto year = log.getDate().year();
+    const auto monthDay = utils::date::monthDay(log.getDate());
+    const auto slot = utils::date::Dates::toIndex(monthDay);
+
+    auto &entries = m_tagsPerLog[day];
+    entries.reserve(log.getTagValues().size());
+    for (const auto &value : log.getTagValues()) {
+        const auto series = m_series.try_emplace(std::string{value.tag}).first;
+        auto &column = series->second[year];
+        column.values.at(slot) = static_cast<float>(value.value);
+        column.days.insert(monthDay);
+        entries.push_back(series);
+    }
+}
+
+void TagValueIndex::erase(Day day) {
+    const auto log = m_tagsPerLog.find(day);
+    if (log == m_tagsPerLog.end()) {
+        return;
+    }
+    const auto date = utils::date::fromDay(day);
+    const auto monthDay = utils::date::monthDay(date);
+    for (const auto series : log->second) {
+        const auto column = series->second.find(date.year());
+        if (column == series->second.end()) {
+            continue;
+        }
+        column->second.values.at(utils::date::Dates::toIndex(monthDay)) = 0;
+        column->second.days.erase(monthDay);
+        if (column->second.days.empty()) {
+            series->second.erase(column);
+        }
+        if (series->second.empty()) {
+            m_series.erase(series);
+        }
+    }
+    m_tagsPerLog.erase(log);
+}
+
+} // namespace caps_log::log
@@ -0,0 +1,105 @@
+#pragma once
+
+#include "log_file.hpp"
+#include "log_index_base.hpp"
+#include "utils/date.hpp"
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <optional>
+#include <shared_mutex>
+#include <span>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace caps_log::log {
+
+/**
+ * In memory time series of the tag values of the logs of all years, see `LogFile::getTagValues`.
+ * Each tag has a column per year with a value per day, so aggregating a series never reads a log.
+ * All methods are thread safe.
+ */
+class TagValueIndex : public LogIndexBase {
+  public:
+    enum class Aggregation : std::uint8_t { kSum, kAverage, kMin, kMax, kCount };
+    enum class Period : std::uint8_t { kWeek, kMonth, kYear };
+
+    /**
+     * The aggregated values of a week (starting on monday), month or year. Buckets without values
+     * have no value, except for `kCount` which counts them as 0.
+     */
+    struct Bucket {
+        std::chrono::year_month_day begin;
+        std::optional<double> value;
+
+        bool operator==(const Bucket &) const = default;
+    };
+
+    void update(const LogFile &log) override;
+    void remove(const std::chrono::year_month_day &date) override;
+    void clear() override;
+
+    /**
+     * Returns the days of the year that have a value for the tag.
+     */
+    [[nodiscard]] utils::date::Dates datesWithValues(std::string_view tag,
+                                                     std::chrono::year year) const;
+
+    /**
+     * Returns the years that have values for the tag in ascending order.
+     */
+    [[nodiscard]] std::vector<std::chrono::year> years(std::string_view tag) const;
+
+    /**
+     * Aggregates the values of the tag per period over the years `from` to `to`, the buckets are
+     * in ascending order. The first and the last week may start or end in the neighbouring years,
+     * their values are included.
+     */
+    [[nodiscard]] std::vector<Bucket> aggregate(std::string_view tag, Aggregation aggregation,
+                                                Period period, std::chrono::year from,
+                                                std::chrono::year to) const;
+
+    /**
+     * Whether the log of the date has any tag values indexed.
+     */
+    [[nodiscard]] bool contains(const std::chrono::year_month_day &date) const;
+
+    /**
+     * Draws the values of the buckets as a line of block characters scaled between `low` and
+     * `high`, buckets without a value are left blank.
+     */
+    [[nodiscard]] static std::string makeSparkline(std::span<const Bucket> buckets, double low,
+                                                   double high);
+
+  private:
+    // logs are identified by their day since the epoch
+    using Day = utils::date::Day;
+
+    /**
+     * The values of a tag in a year, a slot per day of a leap year like `utils::date::Dates`.
+     * Stored as floats, habit values do not need more precision and the column stays at 1.5 KiB.
+     */
+    struct Column {
+        std::array<float, utils::date::Dates::kCapacity> values{};
+        utils::date::Dates days;
+    };
+    using Series = std::map<std::chrono::year, Column>;
+    using SeriesPerTag = std::map<std::string, Series, std::less<>>;
+
+    mutable std::shared_mutex m_mutex;
+    SeriesPerTag m_series;
+    // series each log has a value in, a series is erased with its last value
+    std::unordered_map<Day, std::vector<SeriesPerTag::iterator>> m_tagsPerLog;
+
+    /**
+     * Expects `m_mutex` to be held exclusively.
+     */
+    void insert(const LogFile &log);
+    void erase(Day day);
+};
+
+} // namespace caps_log::log
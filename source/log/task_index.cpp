@@ -0,0 +1,64 @@
+#include "task_index.hpp"
+
+#include <mutex>
+#include <utility>
+
+namespace caps_log::log {
+
+using utils::date::fromDay;
+using utils::date::toDay;
+
+void TaskIndex::update(const LogFile &log) {
+    const auto day = toDay(log.getDate());
+    auto tasks = openTasksOf(log);
+    const std::unique_lock lock{m_mutex};
+    if (tasks.empty()) {
+        m_openTasks.erase(day);
+    } else {
+        m_openTasks.insert_or_assign(day, std::move(tasks));
+    }
+}
+
+void TaskIndex::remove(const std::chrono::year_month_day &date) {
+    const std::unique_lock lock{m_mutex};
+    m_openTasks.erase(toDay(date));
+}
+
+void TaskIndex::clear() {
+    const std::unique_lock lock{m_mutex};
+    m_openTasks.clear();
+}
+
+utils::date::Dates TaskIndex::datesWithOpenTasks(std::chrono::year year) const {
+    utils::date::Dates dates;
+    const std::shared_lock lock{m_mutex};
+    const auto end = m_openTasks.lower_bound(toDay((year + std::chrono::years{1}) / 1 / 1));
+    for (auto log = m_openTasks.lower_bound(toDay(year / 1 / 1)); log != end; ++log) {
+        dates.insert(utils::date::monthDay(fromDay(log->first)));
+    }
+    return dates;
+}
+
+std::vector<OpenTask> TaskIndex::openTasks() const {
+    std::vector<OpenTask> tasks;
+    const std::shared_lock lock{m_mutex};
+    for (auto log = m_openTasks.rbegin(); log != m_openTasks.rend(); ++log) {
+        const auto date = fromDay(log->first);
+        for (const auto &task : log->second) {
+            tasks.push_back(OpenTask{.date = date, .tag = task.tag, .title = task.title});
+        }
+    }
+    return tasks;
+}
+
+std::vector<TaskIndex::Task> TaskIndex::openTasksOf(const LogFile &log) {
+    std::vector<Task> tasks;
+    for (const auto &task : log.getTasks()) {
+        if (task.isOpen()) {
+            tasks.push_back(Task{.tag = std::string{task.tag}, .title = std::string{task.title}});
+        }
+    }
+    return tasks;
+}
+
+} // namespace caps_log::log
@@ -0,0 +1,63 @@
+#pragma once
+
+#include "log_file.hpp"
+#include "log_index_base.hpp"
+#include "utils/date.hpp"
+
+#include <chrono>
+#include <map>
+#include <shared_mutex>
+#include <string>
+#include <vector>
+
+namespace caps_log::log {
+
+/**
+ * An open task of a log, an owning copy of `LogTask`.
+ */
+struct OpenTask {
+    std::chrono::year_month_day date;
+    std::string tag;
+    std::string title;
+
+    bool operator==(const OpenTask &) const = default;
+};
+
+/**
+ * In memory index of the open tasks of the logs of all years, see `LogFile::getTasks`. All methods
+ * are thread safe.
+ */
+class TaskIndex : public LogIndexBase {
+  public:
+    void update(const LogFile &log) override;
+    void remove(const std::chrono::year_month_day &date) override;
+    void clear() override;
+
+    /**
+     * Returns the days of the year that have a log with at least one open task.
+     */
+    [[nodiscard]] utils::date::Dates datesWithOpenTasks(std::chrono::year year) const;
+
+    /**
+     * Returns the open tasks of all logs, most recent logs first and the tasks of a log in the
+     * order they appear in it.
+     */
+    [[nodiscard]] std::vector<OpenTask> openTasks() const;
+
+  private:
+    // logs are identified by their day since the epoch
+    using Day = utils::date::Day;
+
+    struct Task {
+        std::string tag;
+        std::string title;
+    };
+
+    mutable std::shared_mutex m_mutex;
+    // logs that have open tasks
+    std::map<Day, std::vector<Task>> m_openTasks;
+
+    [[nodiscard]] static std::vector<Task> openTasksOf(const LogFile &log);
+};
+
+} // namespace caps_log::log
@@ -0,0 +1,208 @@
+#include "text_search_index.hpp"
+
+#include <algorithm>
+#include <cctype>
+#include <iterator>
+#include <mutex>
+
+namespace caps_log::log {
+
+using utils::date::fromDay;
+using utils::date::toDay;
+
+namespace {
+bool isWordCharacter(char character) {
+    const auto byte = static_cast<unsigned char>(character);
+    // bytes of multi byte UTF-8 sequences are treated as letters
+    static constexpr unsigned char kFirstNonAscii = 0x80;
+    return byte >= kFirstNonAscii || std::isalnum(byte) != 0;
+}
+
+bool isContinuationByte(char character) {
+    static constexpr unsigned char kContinuationMask = 0xC0;
+    static constexpr unsigned char kContinuation = 0x80;
+    return (static_cast<unsigned char>(character) & kContinuationMask) == kContinuation;
+}
+
+char toLower(char character) {
+    return static_cast<char>(std::tolower(static_cast<unsigned char>(character)));
+}
+
+std::vector<std::string> uniqueWords(std::string_view text) {
+    auto words = TextSearchIndex::tokenize(text);
+    std::ranges::sort(words);
+    const auto duplicates = std::ranges::unique(words);
+    words.erase(duplicates.begin(), duplicates.end());
+    return words;
+}
+} // namespace
+
+void TextSearchIndex::update(const LogFile &log) { updateMany(std::span{&log, 1}); }
+
+void TextSearchIndex::updateMany(std::span<const LogFile> logs) {
+    WordsPerDay wordsPerDay;
+    for (const auto &log : logs) {
+        wordsPerDay.insert_or_assign(toDay(log.getDate()), uniqueWords(log.getContent()));
+    }
+    const std::unique_lock lock{m_mutex};
+    for (const auto &[day, _] : wordsPerDay) {
+        erase(day);
+    }
+    insert(wordsPerDay);
+}
+
+void TextSearchIndex::remove(const std::chrono::year_month_day &date) {
+    const auto day = toDay(date);
+    const std::unique_lock lock{m_mutex};
+    erase(day);
+}
+
+void TextSearchIndex::clear() {
+    const std::unique_lock lock{m_mutex};
+    m_postings.clear();
+    m_wordsPerLog.clear();
+}
+
+std::vector<std::chrono::year_month_day> TextSearchIndex::search(std::string_view query) const {
+    const auto words = tokenize(query);
+    if (words.empty()) {
+        return {};
+    }
+    const auto lastIsPrefix = isWordCharacter(query.back());
+
+    const std::shared_lock lock{m_mutex};
+    std::vector<Day> days;
+    for (std::size_t i = 0; i < words.size(); i++) {
+        std::vector<Day> matches;
+        if (i + 1 == words.size() && lastIsPrefix) {
+            for (auto entry = m_postings.lower_bound(words[i]);
+                 entry != m_postings.end() && entry->first.starts_with(words[i]); ++entry) {
+                matches.insert(matches.end(), entry->second.begin(), entry->second.end());
+            }
+            std::ranges::sort(matches);
+            const auto duplicates = std::ranges::unique(matches);
+            matches.erase(duplicates.begin(), duplicates.end());
+        } else if (const auto entry = m_postings.find(words[i]); entry != m_postings.end()) {
+            matches = entry->second;
+        }
+
+        if (i == 0) {
+            days = std::move(matches);
+        } else {
+            std::vector<Day> intersection;
+            std::ranges::set_intersection(days, matches, std::back_inserter(intersection));
+            days = std::move(intersection);
+        }
+        if (days.empty()) {
+            return {};
+        }
+    }
+
+    std::vector<std::chrono::year_month_day> dates;
+    dates.reserve(days.size());
+    std::ranges::transform(days, std::back_inserter(dates), fromDay);
+    return dates;
+}
+
+bool TextSearchIndex::contains(const std::chrono::year_month_day &date) const {
+    const std::shared_lock lock{m_mutex};
+    return m_wordsPerLog.contains(toDay(date));
+}
+
+std::size_t TextSearchIndex::size() const {
+    const std::shared_lock lock{m_mutex};
+    return m_wordsPerLog.size();
+}
+
+std::vector<std::string> TextSearchIndex::tokenize(std::string_view text) {
+    std::vector<std::string> words;
+    std::size_t position = 0;
+    while (position < text.size()) {
+        const auto begin = std::find_if(text.begin() + static_cast<std::ptrdiff_t>(position),
+                                        text.end(), isWordCharacter);
+        const auto end = std::find_if_not(begin, text.end(), isWordCharacter);
+        if (begin == end) {
+            break;
+        }
+        auto &word = words.emplace_back(begin, end);
+        std::ranges::transform(word, word.begin(), toLower);
+        position = static_cast<std::size_t>(end - text.begin());
+    }
+    return words;
+}
+
+std::string TextSearchIndex::makeSnippet(std::string_view content, std::string_view query,
+                                         std::size_t width) {
+    std::string lowercaseContent{content};
+    std::ranges::transform(lowercaseContent, lowercaseContent.begin(), toLower);
+    auto match = std::string_view::npos;
+    for (const auto &word : tokenize(query)) {
+        match = std::min(match, lowercaseContent.find(word));
+    }
+
+    // some context before the match, without splitting multi byte characters
+    auto begin = match == std::string_view::npos || match < width / 3 ? 0 : match - (width / 3);
+    while (begin < content.size() && isContinuationByte(content[begin])) {
+        begin++;
+    }
+    auto end = std::min(content.size(), begin + width);
+    while (end < content.size() && end > begin && isContinuationByte(content[end])) {
+        end--;
+    }
+
+    std::string line;
+    for (const auto character : content.substr(begin, end - begin)) {
+        const auto isSpace = character == '\n' || character == '\t' || character == '\r';
+        const auto printed = isSpace ? ' ' : character;
+        if (printed != ' ' || (not line.empty() && line.back() != ' ')) {
+            line.push_back(printed);
+        }
+    }
+    if (not line.empty() && line.back() == ' ') {
+        line.pop_back();
+    }
+    return (begin > 0 ? "..." : "") + line + (end < content.size() ? "..." : "");
+}
+
+void TextSearchIndex::insert(const WordsPerDay &wordsPerDay) {
+    // the batch is appended in ascending order after the days each list already had, so a list
+    // is merged at most once per batch however the batches and the logs within them are ordered
+    std::unordered_map<std::string_view, std::size_t> sortedSizes;
+    for (const auto &[day, words] : wordsPerDay) {
+        auto &entries = m_wordsPerLog[day];
+        entries.reserve(words.size());
+        for (const auto &word : words) {
+            const auto entry = m_postings.try_emplace(word).first;
+            sortedSizes.try_emplace(entry->first, entry->second.size());
+            entry->second.push_back(day);
+            entries.push_back(entry);
+        }
+    }
+    for (const auto &[word, sortedSize] : sortedSizes) {
+        auto &days = m_postings.find(word)->second;
+        const auto appended = days.begin() + static_cast<std::ptrdiff_t>(sortedSize);
+        if (appended != days.begin() && *std::prev(appended) > *appended) {
+            std::inplace_merge(days.begin(), appended, days.end());
+        }
+    }
+}
+
+void TextSearchIndex::erase(Day day) {
+    const auto log = m_wordsPerLog.find(day);
+    if (log == m_wordsPerLog.end()) {
+        return;
+    }
+    for (const auto entry : log->second) {
+        auto &days = entry->second;
+        if (const auto position = std::ranges::lower_bound(days, day);
+            position != days.end() && *position == day) {
+            days.erase(position);
+        }
+        if (days.empty()) {
+            m_postings.erase(entry);
+        }
+    }
+    m_wordsPerLog.erase(log);
+}
+
+} // namespace caps_log::log
@@ -0,0 +1,73 @@
+#pragma once
+
+#include "log_file.hpp"
+#include "log_index_base.hpp"
+#include "utils/date.hpp"
+
+#include <chrono>
+#include <cstddef>
+#include <map>
+#include <shared_mutex>
+#include <span>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace caps_log::log {
+
+/**
+ * In memory inverted index from the words of the logs to the dates of the logs that contain them.
+ * Words are runs of letters and digits (any non ASCII byte counts as a letter), compared case
+ * insensitively. The index only lives in memory, so it is also safe to use for encrypted logs.
+ * Only the content of the logs is indexed, they do not have to be parsed. All methods are thread
+ * safe.
+ */
+class TextSearchIndex : public LogIndexBase {
+  public:
+    void update(const LogFile &log) override;
+    void updateMany(std::span<const LogFile> logs) override;
+    void remove(const std::chrono::year_month_day &date) override;
+    void clear() override;
+
+    /**
+     * Returns the dates of the logs that contain all the words of the query in ascending order.
+     * Unless the query ends with whitespace, its last word also matches words it is a prefix of,
+     * so results can be shown while the query is typed.
+     */
+    [[nodiscard]] std::vector<std::chrono::year_month_day> search(std::string_view query) const;
+
+    [[nodiscard]] bool contains(const std::chrono::year_month_day &date) const;
+    [[nodiscard]] std::size_t size() const;
+
+    /**
+     * Splits the text into lowercase words.
+     */
+    [[nodiscard]] static std::vector<std::string> tokenize(std::string_view text);
+
+    /**
+     * Returns a single line of about `width` characters around the first occurrence of a word of
+     * the query in the content, or its beginning if there is none.
+     */
+    [[nodiscard]] static std::string makeSnippet(std::string_view content, std::string_view query,
+                                                 std::size_t width);
+
+  private:
+    // logs are identified by their day since the epoch, postings are sorted
+    using Day = utils::date::Day;
+    using Postings = std::map<std::string, std::vector<Day>, std::less<>>;
+    using WordsPerDay = std::map<Day, std::vector<std::string>>;
+
+    mutable std::shared_mutex m_mutex;
+    Postings m_postings;
+    // entries of `m_postings` each log was added to, an entry is erased with its last log
+    std::unordered_map<Day, std::vector<Postings::iterator>> m_wordsPerLog;
+
+    /**
+     * Expects `m_mutex` to be held exclusively.
+     */
+    void insert(const WordsPerDay &wordsPerDay);
+    void erase(Day day);
+};
+
+} // namespace caps_log::log
@@ -25,6 +25,10 @@ int main(int argc, const char **argv) try {
     } else if (task.type == CapsLog::Task::Type::kApplyCrypto) {
         std::cout << "Applying crypto...\n";
         task.action();
+    } else if (task.type == CapsLog::Task::Type::kGrep) {
+        task.action();
+    } else if (task.type == CapsLog::Task::Type::kProfileStartup) {
+        task.action();
     } else {
         std::cerr << "Invalid command line arguments provided.\n";
         return 1;
@@ -0,0 +1,261 @@
+#include "batch_file_reader.hpp"
+
+#include <cstdint>
+#include <fstream>
+#include <limits>
+#include <optional>
+#include <stdexcept>
+#include <system_error>
+#include <utility>
+#include <vector>
+
+#ifdef CAPS_LOG_HAS_IO_URING
+#include <algorithm>
+#include <cerrno>
+#include <fcntl.h>
+#include <liburing.h>
+#include <sys/stat.h>
+#include <tuple>
+#include <unistd.h>
+#endif
+
+namespace caps_log::utils {
+
+namespace {
+std::vector<std::size_t> readFilesOneByOne(std::span<const std::filesystem::path> paths,
+                                           const OnFileRead &onFile, std::uintmax_t maxSize) {
+    std::vector<std::size_t> tooLarge;
+    for (std::size_t i = 0; i < paths.size(); i++) {
+        // only stat-ed when there is a limit, `readFile` stats the file again
+        if (maxSize != std::numeric_limits<std::uintmax_t>::max()) {
+            std::error_code error;
+            if (const auto size = std::filesystem::file_size(paths[i], error);
+                not error && size > maxSize) {
+                tooLarge.push_back(i);
+                continue;
+            }
+        }
+        if (auto content = readFile(paths[i])) {
+            onFile(i, std::move(*content));
+        }
+    }
+    return tooLarge;
+}
+
+#ifdef CAPS_LOG_HAS_IO_URING
+
+// the files of a batch are opened, stat-ed and read at the same time
+constexpr std::size_t kBatchSize = 64;
+
+class Ring {
+  public:
+    Ring() {
+        // an opened and a stat-ed file per file of the batch
+        if (io_uring_queue_init(2 * kBatchSize, &m_ring, 0) != 0) {
+            return;
+        }
+        m_initialized = true;
+        // opening and stat-ing files through io_uring needs linux 5.6
+        auto *probe = io_uring_get_probe_ring(&m_ring);
+        m_available = probe != nullptr && io_uring_opcode_supported(probe, IORING_OP_OPENAT) &&
+                      io_uring_opcode_supported(probe, IORING_OP_STATX) &&
+                      io_uring_opcode_supported(probe, IORING_OP_READ);
+        if (probe != nullptr) {
+            io_uring_free_probe(probe);
+        }
+    }
+    ~Ring() {
+        if (m_initialized) {
+            io_uring_queue_exit(&m_ring);
+        }
+    }
+
+    Ring(const Ring &) = delete;
+    Ring(Ring &&) = delete;
+    Ring &operator=(const Ring &) = delete;
+    Ring &operator=(Ring &&) = delete;
+
+    [[nodiscard]] bool isAvailable() const { return m_available; }
+
+    /**
+     * Never returns nullptr as long as no more than 2 * kBatchSize requests are in flight.
+     */
+    io_uring_sqe *nextRequest() { return io_uring_get_sqe(&m_ring); }
+
+    /**
+     * Submits the requests made so far and waits for the next completion, returns its user data
+     * and result.
+     */
+    std::pair<std::uint64_t, int> submitAndWait() {
+        io_uring_cqe *completion = nullptr;
+        int error = 0;
+        do {
+            error = io_uring_submit_and_wait(&m_ring, 1);
+            if (error >= 0) {
+                error = io_uring_peek_cqe(&m_ring, &completion);
+            }
+        } while (error == -EINTR || error == -EAGAIN);
+        if (error < 0) {
+            throw std::runtime_error{"Failed to wait for io_uring completion!"};
+        }
+        const auto result = std::make_pair(io_uring_cqe_get_data64(completion), completion->res);
+        io_uring_cqe_seen(&m_ring, completion);
+        return result;
+    }
+
+  private:
+    io_uring m_ring{};
+    bool m_initialized = false;
+    bool m_available = false;
+};
+
+struct PendingFile {
+    int fd = -1;
+    struct statx stat{};
+    int statResult = 0;
+    std::string content;
+    std::size_t bytesRead = 0;
+
+    PendingFile() = default;
+    PendingFile(const PendingFile &) = delete;
+    PendingFile(PendingFile &&) = delete;
+    PendingFile &operator=(const PendingFile &) = delete;
+    PendingFile &operator=(PendingFile &&) = delete;
+    ~PendingFile() { close(); }
+
+    void close() {
+        if (fd >= 0) {
+            ::close(fd);
+            fd = -1;
+        }
+    }
+};
+
+void readBatch(Ring &ring, std::span<const std::filesystem::path> paths, std::size_t firstIndex,
+               const OnFileRead &onFile, std::uintmax_t maxSize,
+               std::vector<std::size_t> &tooLarge) {
+    // never moved, the kernel writes into the stat buffers and strings of the files
+    std::vector<PendingFile> files(paths.size());
+
+    // the user data of a request is the index of its file, doubled plus one for the stat
+    for (std::size_t i = 0; i < paths.size(); i++) {
+        auto *open = ring.nextRequest();
+        io_uring_prep_openat(open, AT_FDCWD, paths[i].c_str(), O_RDONLY | O_CLOEXEC, 0);
+        io_uring_sqe_set_data64(open, 2 * i);
+        auto *stat = ring.nextRequest();
+        io_uring_prep_statx(stat, AT_FDCWD, paths[i].c_str(), 0, STATX_TYPE | STATX_SIZE,
+                            &files[i].stat);
+        io_uring_sqe_set_data64(stat, (2 * i) + 1);
+    }
+    for (std::size_t completed = 0; completed < 2 * paths.size(); completed++) {
+        const auto [request, result] = ring.submitAndWait();
+        auto &file = files[request / 2];
+        if (request % 2 == 0) {
+            file.fd = result;
+        } else {
+            file.statResult = result;
+        }
+    }
+
+    std::size_t readsInFlight = 0;
+    const auto readRest = [&ring, &files, &readsInFlight](std::size_t i) {
+        auto &file = files[i];
+        auto *read = ring.nextRequest();
+        io_uring_prep_read(read, file.fd, file.content.data() + file.bytesRead,
+                           file.content.size() - file.bytesRead, file.bytesRead);
+        io_uring_sqe_set_data64(read, i);
+        readsInFlight++;
+    };
+
+    try {
+        for (std::size_t i = 0; i < paths.size(); i++) {
+            auto &file = files[i];
+            // like with `readFile`, files that can not be opened are skipped
+            if (file.fd < 0) {
+                continue;
+            }
+            if (file.statResult < 0) {
+                throw std::runtime_error{"Failed to stat file: " + paths[i].string()};
+            }
+            // like `readFile`, directories are skipped
+            if (not S_ISREG(file.stat.stx_mode)) {
+                continue;
+            }
+            if (file.stat.stx_size > maxSize) {
+                file.close();
+                tooLarge.push_back(firstIndex + i);
+                continue;
+            }
+            file.content.resize(file.stat.stx_size);
+            if (file.content.empty()) {
+                file.close();
+                onFile(firstIndex + i, std::string{});
+            } else {
+                readRest(i);
+            }
+        }
+        while (readsInFlight > 0) {
+            const auto [i, result] = ring.submitAndWait();
+            readsInFlight--;
+            auto &file = files[i];
+            if (result == -EINTR || result == -EAGAIN) {
+                readRest(i);
+                continue;
+            }
+            if (result < 0) {
+                throw std::runtime_error{"Failed to read file: " + paths[i].string()};
+            }
+            file.bytesRead += static_cast<std::size_t>(result);
+            // a file that shrank since it was stat-ed ends early
+            if (result == 0 || file.bytesRead == file.content.size()) {
+                file.content.resize(file.bytesRead);
+                file.close();
+                onFile(firstIndex + i, std::move(file.content));
+            } else {
+                readRest(i);
+            }
+        }
+    } catch (...) {
+        // the buffers of the reads in flight must outlive them
+        while (readsInFlight > 0) {
+            std::ignore = ring.submitAndWait();
+            readsInFlight--;
+        }
+        throw;
+    }
+}
+
+#endif
+} // namespace
+
+std::optional<std::string> readFile(const std::filesystem::path &path) {
+    std::error_code error;
+    // fails for directories, which can be opened but not read
+    const auto size = std::filesystem::file_size(path, error);
+    std::ifstream ifs{path, std::ios::binary};
+    if (error || not ifs.is_open()) {
+        return std::nullopt;
+    }
+    std::string content(size, '\0');
+    ifs.read(content.data(), static_cast<std::streamsize>(content.size()));
+    // a file that shrank since it was opened ends early
+    content.resize(static_cast<std::size_t>(ifs.gcount()));
+    return content;
+}
+
+std::vector<std::size_t> readFiles(std::span<const std::filesystem::path> paths,
+                                   const OnFileRead &onFile, std::uintmax_t maxSize) {
+#ifdef CAPS_LOG_HAS_IO_URING
+    if (Ring ring; ring.isAvailable()) {
+        std::vector<std::size_t> tooLarge;
+        for (std::size_t begin = 0; begin < paths.size(); begin += kBatchSize) {
+            const auto size = std::min(kBatchSize, paths.size() - begin);
+            readBatch(ring, paths.subspan(begin, size), begin, onFile, maxSize, tooLarge);
+        }
+        return tooLarge;
+    }
+#endif
+    return readFilesOneByOne(paths, onFile, maxSize);
+}
+
+} // namespace caps_log::utils
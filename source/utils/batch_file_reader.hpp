@@ -0,0 +1,39 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <functional>
+#include <limits>
+#include <optional>
+#include <span>
+#include <string>
+#include <vector>
+
+namespace caps_log::utils {
+
+/**
+ * Reads the whole content of the file at `path` into a string of its size with a single read,
+ * returns nullopt if it can not be opened.
+ */
+[[nodiscard]] std::optional<std::string> readFile(const std::filesystem::path &path);
+
+using OnFileRead = std::function<void(std::size_t index, std::string content)>;
+
+/**
+ * Reads the whole content of the files at `paths` and passes each one to `onFile` together with
+ * its index in `paths`, on the calling thread and in the order the reads complete. Files that can
+ * not be opened are skipped, a file that fails to read after it was opened throws
+ * std::runtime_error. Files of more than `maxSize` bytes are not read either, their indices are
+ * returned in ascending order so the caller can e.g. map them instead.
+ *
+ * When built with liburing (CAPS_LOG_HAS_IO_URING) the opens and reads of a batch of files are
+ * submitted to io_uring together, so the drive sees them all at once rather than one blocking read
+ * after another. Without it, or when the kernel does not allow io_uring, the files are read one by
+ * one.
+ */
+std::vector<std::size_t>
+readFiles(std::span<const std::filesystem::path> paths, const OnFileRead &onFile,
+          std::uintmax_t maxSize = std::numeric_limits<std::uintmax_t>::max());
+
+} // namespace caps_log::utils
@@ -1,11 +1,17 @@
 #pragma once
 
+#include <algorithm>
 #include <array>
+#include <bit>
 #include <cassert>
 #include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
 #include <iomanip>
-#include <set>
+#include <iterator>
 #include <sstream>
+#include <stdexcept>
 #include <string>
 
 namespace caps_log::utils::date {
@@ -33,6 +39,21 @@ inline std::chrono::month_day monthDay(std::chrono::year_month_day date) {
     return std::chrono::month_day{date.month(), date.day()};
 }
 
+/**
+ * A date as its day since the epoch, a compact key that orders the dates of all years.
+ */
+using Day = std::int32_t;
+
+[[nodiscard]]
+inline Day toDay(const std::chrono::year_month_day &date) {
+    return static_cast<Day>(std::chrono::sys_days{date}.time_since_epoch().count());
+}
+
+[[nodiscard]]
+inline std::chrono::year_month_day fromDay(Day day) {
+    return std::chrono::year_month_day{std::chrono::sys_days{std::chrono::days{day}}};
+}
+
 [[nodiscard]]
 inline std::string formatToString(const std::chrono::year_month_day &date,
                                   const std::string &format = "%d. %m. %y.") {
@@ -96,6 +117,195 @@ inline std::string getStringNameForMonth(std::chrono::month month) {
     return kMonthNames.at(index);
 }
 
-using Dates = std::set<std::chrono::month_day>;
+/**
+ * A set of days of a year stored as a fixed size bitset with one bit per day of a leap year.
+ * Membership, insertion and removal are O(1), the set operations work a machine word at a time
+ * and iteration visits the days in calendar order by skipping to the next set bit.
+ */
+class Dates {
+  public:
+    static constexpr std::size_t kCapacity = 366;
+
+  private:
+    using Word = std::uint64_t;
+    static constexpr std::size_t kWordBits = 64;
+    static constexpr std::size_t kWordCount = (kCapacity + kWordBits - 1) / kWordBits;
+
+    std::array<Word, kWordCount> m_words{};
+
+    static constexpr std::array<unsigned, 13> kDaysBeforeMonth{
+        0, 0, 31, 60, 91, 121, 152, 182, 213, 244, 274, 305, 335,
+    };
+
+  public:
+    // the days and indices are validated by `toIndex` and `fromIndex` (or `contains` and `erase`
+    // before them) or bounded by `kWordCount`, so the hot paths skip the bounds checks of `at`
+    // NOLINTBEGIN(cppcoreguidelines-pro-bounds-constant-array-index)
+    class Iterator {
+        const Dates *m_dates = nullptr;
+        std::size_t m_index = kCapacity;
+
+      public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = std::chrono::month_day;
+        using difference_type = std::ptrdiff_t;
+        using pointer = void;
+        using reference = std::chrono::month_day;
+
+        Iterator() = default;
+        Iterator(const Dates *dates, std::size_t index)
+            : m_dates{dates}, m_index{dates->findNext(index)} {}
+
+        [[nodiscard]] std::chrono::month_day operator*() const { return fromIndex(m_index); }
+        Iterator &operator++() {
+            m_index = m_dates->findNext(m_index + 1);
+            return *this;
+        }
+        Iterator operator++(int) {
+            auto copy = *this;
+            ++*this;
+            return copy;
+        }
+        [[nodiscard]] bool operator==(const Iterator &other) const {
+            return m_index == other.m_index;
+        }
+    };
+
+    using value_type = std::chrono::month_day;
+    using const_iterator = Iterator;
+    using iterator = Iterator;
+
+    Dates() = default;
+    Dates(std::initializer_list<std::chrono::month_day> dates) {
+        for (const auto &date : dates) {
+            insert(date);
+        }
+    }
+
+    /**
+     * Maps a day to its position in a leap year, 29th of February is always included. Throws
+     * std::out_of_range for a day that is not in a leap year, e.g. month 13.
+     */
+    [[nodiscard]] static constexpr std::size_t toIndex(std::chrono::month_day date) {
+        if (not date.ok()) {
+            throw std::out_of_range{"Not a day of the year!"};
+        }
+        return kDaysBeforeMonth[static_cast<unsigned>(date.month())] +
+               static_cast<unsigned>(date.day()) - 1;
+    }
+
+    /**
+     * The inverse of `toIndex`, throws std::out_of_range for an index of `kCapacity` or more.
+     */
+    [[nodiscard]] static constexpr std::chrono::month_day fromIndex(std::size_t index) {
+        if (index >= kCapacity) {
+            throw std::out_of_range{"Not a day of the year!"};
+        }
+        unsigned month = kDaysBeforeMonth.size() - 1;
+        while (kDaysBeforeMonth[month] > index) {
+            month--;
+        }
+        return std::chrono::month{month} /
+               std::chrono::day{static_cast<unsigned>(index - kDaysBeforeMonth[month]) + 1};
+    }
+
+    /**
+     * Throws std::out_of_range for a day that is not in a leap year, see `toIndex`.
+     */
+    void insert(std::chrono::month_day date) {
+        const auto index = toIndex(date);
+        m_words[index / kWordBits] |= Word{1} << (index % kWordBits);
+    }
+
+    /**
+     * Removes the date from the set, returns the number of removed elements like `std::set`.
+     */
+    std::size_t erase(std::chrono::month_day date) {
+        // like `contains`, a day that is not in a leap year is never in the set
+        if (not date.ok()) {
+            return 0;
+        }
+        const auto index = toIndex(date);
+        auto &word = m_words[index / kWordBits];
+        const auto mask = Word{1} << (index % kWordBits);
+        const auto wasSet = (word & mask) != 0;
+        word &= ~mask;
+        return wasSet ? 1 : 0;
+    }
+
+    /**
+     * False for a day that is not in a leap year, which `insert` throws for.
+     */
+    [[nodiscard]] bool contains(std::chrono::month_day date) const {
+        if (not date.ok()) {
+            return false;
+        }
+        const auto index = toIndex(date);
+        return ((m_words[index / kWordBits] >> (index % kWordBits)) & 1U) != 0;
+    }
+
+    [[nodiscard]] std::size_t size() const {
+        std::size_t count = 0;
+        for (const auto word : m_words) {
+            count += std::popcount(word);
+        }
+        return count;
+    }
+
+    [[nodiscard]] bool empty() const {
+        return std::ranges::all_of(m_words, [](auto word) { return word == 0; });
+    }
+
+    void clear() { m_words.fill(0); }
+
+    [[nodiscard]] Iterator begin() const { return Iterator{this, 0}; }
+    [[nodiscard]] Iterator end() const { return Iterator{this, kCapacity}; }
+
+    Dates &operator|=(const Dates &other) {
+        for (std::size_t i = 0; i < kWordCount; i++) {
+            m_words[i] |= other.m_words[i];
+        }
+        return *this;
+    }
+
+    Dates &operator&=(const Dates &other) {
+        for (std::size_t i = 0; i < kWordCount; i++) {
+            m_words[i] &= other.m_words[i];
+        }
+        return *this;
+    }
+
+    Dates &operator-=(const Dates &other) {
+        for (std::size_t i = 0; i < kWordCount; i++) {
+            m_words[i] &= ~other.m_words[i];
+        }
+        return *this;
+    }
+
+    [[nodiscard]] friend Dates operator|(Dates lhs, const Dates &rhs) { return lhs |= rhs; }
+    [[nodiscard]] friend Dates operator&(Dates lhs, const Dates &rhs) { return lhs &= rhs; }
+    [[nodiscard]] friend Dates operator-(Dates lhs, const Dates &rhs) { return lhs -= rhs; }
+    [[nodiscard]] bool operator==(const Dates &other) const = default;
+
+  private:
+    /**
+     * Returns the index of the first set bit at or after `index`, or `kCapacity` if there is none.
+     */
+    [[nodiscard]] std::size_t findNext(std::size_t index) const {
+        if (index >= kCapacity) {
+            return kCapacity;
+        }
+        auto wordIndex = index / kWordBits;
+        auto word = m_words[wordIndex] & (~Word{0} << (index % kWordBits));
+        while (word == 0) {
+            if (++wordIndex == kWordCount) {
+                return kCapacity;
+            }
+            word = m_words[wordIndex];
+        }
+        return (wordIndex * kWordBits) + std::countr_zero(word);
+    }
+    // NOLINTEND(cppcoreguidelines-pro-bounds-constant-array-index)
+};
 
 } // namespace caps_log::utils::date
@@ -0,0 +1,83 @@
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <utility>
+
+namespace caps_log::utils {
+
+/**
+ * Runs the most recently scheduled task on its own thread once no other task was scheduled for
+ * `delay`. Scheduling a task replaces the one that is still waiting, so a burst of tasks runs
+ * only the last of them. A task that is already running is not interrupted.
+ */
+class Debouncer {
+  public:
+    explicit Debouncer(std::chrono::milliseconds delay)
+        : m_delay{delay}, m_worker(&Debouncer::worker, this) {}
+    ~Debouncer() {
+        {
+            const std::unique_lock lock{m_mutex};
+            m_done = true;
+        }
+        m_condition.notify_one();
+        m_worker.join();
+    }
+
+    Debouncer(Debouncer &&) = delete;
+    Debouncer &operator=(Debouncer &&) = delete;
+    Debouncer(const Debouncer &) = delete;
+    Debouncer &operator=(const Debouncer &) = delete;
+
+    void schedule(std::function<void()> task) {
+        {
+            const std::unique_lock lock{m_mutex};
+            m_task = std::move(task);
+            m_deadline = std::chrono::steady_clock::now() + m_delay;
+        }
+        m_condition.notify_one();
+    }
+
+    /**
+     * Drops the waiting task, if any.
+     */
+    void cancel() {
+        const std::unique_lock lock{m_mutex};
+        m_task = nullptr;
+    }
+
+  private:
+    std::chrono::milliseconds m_delay;
+    std::function<void()> m_task;
+    std::chrono::steady_clock::time_point m_deadline;
+    std::mutex m_mutex;
+    std::condition_variable m_condition;
+    bool m_done{};
+    // declared last so the worker starts only after the members it uses are constructed
+    std::thread m_worker;
+
+    void worker() {
+        std::unique_lock lock{m_mutex};
+        while (true) {
+            m_condition.wait(lock, [this] { return m_done || m_task; });
+            if (m_done) {
+                break;
+            }
+            // a task scheduled while waiting moves the deadline, the wait is then repeated
+            if (std::chrono::steady_clock::now() < m_deadline) {
+                m_condition.wait_until(lock, m_deadline);
+                continue;
+            }
+            auto task = std::exchange(m_task, nullptr);
+            lock.unlock();
+            // it is the responsibility of the `task` to handle its own exceptions
+            task();
+            lock.lock();
+        }
+    }
+};
+
+} // namespace caps_log::utils
@@ -0,0 +1,119 @@
+#include "fuzzy_filter.hpp"
+
+#include "string.hpp"
+
+#include <algorithm>
+#include <cctype>
+
+namespace caps_log::utils {
+
+namespace {
+constexpr int kMatchScore = 1;
+constexpr int kConsecutiveBonus = 4;
+constexpr int kWordStartBonus = 6;
+constexpr int kGapPenalty = 1;
+constexpr int kMaxLeadingPenalty = 3;
+
+bool isWordStart(std::string_view text, std::size_t position) {
+    return position == 0 || std::isalnum(static_cast<unsigned char>(text[position - 1])) == 0;
+}
+} // namespace
+
+FuzzyFilter::FuzzyFilter(const std::vector<std::string> &entries) {
+    m_entries.reserve(entries.size());
+    m_matches.reserve(entries.size());
+    for (std::size_t i = 0; i < entries.size(); i++) {
+        auto text = lowercase(entries[i]);
+        const auto characters = characterMask(text);
+        m_entries.push_back(Entry{.text = std::move(text), .characters = characters});
+        m_matches.push_back(Match{.index = i, .score = 0});
+    }
+}
+
+void FuzzyFilter::setPattern(std::string_view pattern) {
+    auto newPattern = lowercase(std::string{pattern});
+    const auto patternCharacters = characterMask(newPattern);
+
+    const auto check = [this, &newPattern, patternCharacters](std::size_t index,
+                                                               std::vector<Match> &matches) {
+        const auto &entry = m_entries[index];
+        if ((entry.characters & patternCharacters) != patternCharacters) {
+            return;
+        }
+        if (const auto entryScore = score(entry.text, newPattern)) {
+            matches.push_back(Match{.index = index, .score = *entryScore});
+        }
+    };
+
+    // whatever matches the longer pattern also matched the shorter one
+    std::vector<Match> matches;
+    if (newPattern.starts_with(m_pattern)) {
+        matches.reserve(m_matches.size());
+        for (const auto &match : m_matches) {
+            check(match.index, matches);
+        }
+    } else {
+        matches.reserve(m_entries.size());
+        for (std::size_t i = 0; i < m_entries.size(); i++) {
+            check(i, matches);
+        }
+    }
+    m_matches = std::move(matches);
+    m_pattern = std::move(newPattern);
+}
+
+std::vector<std::size_t> FuzzyFilter::top(std::size_t count) const {
+    // only the shown matches are sorted, the rest stay where they are
+    auto matches = m_matches;
+    const auto shown = std::min(count, matches.size());
+    std::ranges::partial_sort(matches, matches.begin() + static_cast<std::ptrdiff_t>(shown),
+                              [](const Match &left, const Match &right) {
+                                  return left.score != right.score ? left.score > right.score
+                                                                   : left.index < right.index;
+                              });
+
+    std::vector<std::size_t> indices;
+    indices.reserve(shown);
+    for (std::size_t i = 0; i < shown; i++) {
+        indices.push_back(matches[i].index);
+    }
+    return indices;
+}
+
+std::optional<int> FuzzyFilter::score(std::string_view entry, std::string_view pattern) {
+    int total = 0;
+    std::size_t position = 0;
+    std::optional<std::size_t> previous;
+    for (const auto character : pattern) {
+        const auto found = entry.find(character, position);
+        if (found == std::string_view::npos) {
+            return std::nullopt;
+        }
+        total += kMatchScore;
+        if (previous && found == *previous + 1) {
+            total += kConsecutiveBonus;
+        } else if (previous) {
+            total -= kGapPenalty * static_cast<int>(std::min<std::size_t>(found - *previous, 8));
+        } else {
+            total -= std::min(static_cast<int>(found), kMaxLeadingPenalty);
+        }
+        if (isWordStart(entry, found)) {
+            total += kWordStartBonus;
+        }
+        previous = found;
+        position = found + 1;
+    }
+    return total;
+}
+
+std::uint64_t FuzzyFilter::characterMask(std::string_view text) {
+    // characters that share a bit only let more entries through to `score`
+    static constexpr unsigned kBits = 64;
+    std::uint64_t mask = 0;
+    for (const auto character : text) {
+        mask |= std::uint64_t{1} << (static_cast<unsigned char>(character) % kBits);
+    }
+    return mask;
+}
+
+} // namespace caps_log::utils
@@ -0,0 +1,58 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace caps_log::utils {
+
+/**
+ * Case insensitive fuzzy matching of a pattern typed character by character against a fixed list
+ * of entries. An entry matches if it contains the characters of the pattern in order, matches at
+ * word starts and runs of consecutive characters score higher.
+ * Each entry keeps a bit mask of the characters it contains, so most entries that can not match
+ * are rejected without looking at their text. When the pattern grows, only the entries that
+ * matched the shorter pattern are checked again.
+ */
+class FuzzyFilter {
+  public:
+    FuzzyFilter() = default;
+    explicit FuzzyFilter(const std::vector<std::string> &entries);
+
+    void setPattern(std::string_view pattern);
+    [[nodiscard]] const std::string &getPattern() const { return m_pattern; }
+
+    [[nodiscard]] std::size_t matchCount() const { return m_matches.size(); }
+
+    /**
+     * Indices of the `count` best matching entries, best first. Equally scored entries keep
+     * their order in the list, with an empty pattern this is the first `count` entries.
+     */
+    [[nodiscard]] std::vector<std::size_t> top(std::size_t count) const;
+
+    /**
+     * Score of `entry` for `pattern`, both expected in lowercase, no value if it does not match.
+     */
+    [[nodiscard]] static std::optional<int> score(std::string_view entry, std::string_view pattern);
+
+  private:
+    struct Entry {
+        std::string text;
+        std::uint64_t characters;
+    };
+    struct Match {
+        std::size_t index;
+        int score;
+    };
+
+    std::vector<Entry> m_entries;
+    std::string m_pattern;
+    std::vector<Match> m_matches;
+
+    [[nodiscard]] static std::uint64_t characterMask(std::string_view text);
+};
+
+} // namespace caps_log::utils
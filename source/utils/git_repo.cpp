@@ -93,6 +93,10 @@ GitRepo::GitRepo(GitRepoConfig config)
     }
     git_libgit2_init();
     CHECK_GIT_ERROR(git_repository_open(&m_repo, config.root.c_str()));
+    // kept in memory for the lifetime of the repository, the repository files are not changed
+    for (const auto &pattern : config.ignoredPatterns) {
+        CHECK_GIT_ERROR(git_ignore_add_rule(m_repo, pattern.c_str()));
+    }
 }
 
 GitRepo::GitRepo(GitRepo &&other) noexcept
@@ -2,6 +2,8 @@
 
 #include <filesystem>
 #include <git2.h>
+#include <string>
+#include <vector>
 
 namespace caps_log::utils {
 
@@ -11,6 +13,8 @@ struct GitRepoConfig {
     std::filesystem::path sshPubKeyPath;
     std::string mainBranchName = "master";
     std::string remoteName = "origin";
+    // never committed, on top of the .gitignore files of the repository
+    std::vector<std::string> ignoredPatterns;
 };
 
 /**
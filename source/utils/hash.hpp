@@ -0,0 +1,22 @@
+#pragma once
+
+#include <cstdint>
+#include <string_view>
+
+namespace caps_log::utils {
+
+/**
+ * 64 bit FNV-1a hash, stable across runs and platforms so it can be persisted.
+ */
+[[nodiscard]] constexpr std::uint64_t fnv1a(std::string_view data) {
+    constexpr std::uint64_t kOffsetBasis = 14695981039346656037ULL;
+    constexpr std::uint64_t kPrime = 1099511628211ULL;
+    std::uint64_t hash = kOffsetBasis;
+    for (const auto chr : data) {
+        hash ^= static_cast<unsigned char>(chr);
+        hash *= kPrime;
+    }
+    return hash;
+}
+
+} // namespace caps_log::utils
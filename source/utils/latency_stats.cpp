@@ -0,0 +1,91 @@
+#include "latency_stats.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <fmt/format.h>
+
+namespace caps_log::utils {
+
+namespace {
+constexpr auto kNameColumnWidth = 28;
+
+std::string formatLatency(std::chrono::nanoseconds latency) {
+    static constexpr auto kNanosPerMicro = 1000.0;
+    static constexpr auto kMicrosPerMilli = 1000.0;
+    const auto micros = static_cast<double>(latency.count()) / kNanosPerMicro;
+    if (micros < kMicrosPerMilli) {
+        return fmt::format("{:.0f}us", micros);
+    }
+    return fmt::format("{:.1f}ms", micros / kMicrosPerMilli);
+}
+} // namespace
+
+void LatencyHistogram::record(std::chrono::nanoseconds latency) {
+    const auto nanos = static_cast<std::uint64_t>(std::max(latency.count(), std::int64_t{0}));
+    m_buckets.at(bucketOf(nanos))++;
+    m_count++;
+    m_max = std::max(m_max, std::chrono::nanoseconds{nanos});
+}
+
+std::chrono::nanoseconds LatencyHistogram::percentile(double fraction) const {
+    if (m_count == 0) {
+        return std::chrono::nanoseconds{0};
+    }
+    const auto rank = std::max<std::uint64_t>(
+        1, static_cast<std::uint64_t>(std::ceil(std::clamp(fraction, 0.0, 1.0) *
+                                                static_cast<double>(m_count))));
+    std::uint64_t seen = 0;
+    for (std::size_t bucket = 0; bucket < kBuckets; bucket++) {
+        seen += m_buckets.at(bucket);
+        if (seen >= rank) {
+            // the recorded maximum is exact and tighter than the bound of the last bucket
+            return std::min(std::chrono::nanoseconds{bucketUpperBound(bucket)}, m_max);
+        }
+    }
+    return m_max;
+}
+
+std::size_t LatencyHistogram::bucketOf(std::uint64_t nanos) {
+    // values below the first power of two with all sub buckets get a bucket each
+    if (nanos < kSubBuckets) {
+        return nanos;
+    }
+    const auto exponent = static_cast<std::size_t>(std::bit_width(nanos)) - 1;
+    const auto subBucket = (nanos >> (exponent - 2)) & (kSubBuckets - 1);
+    return (exponent * kSubBuckets) + subBucket;
+}
+
+std::uint64_t LatencyHistogram::bucketUpperBound(std::size_t bucket) {
+    if (bucket < kSubBuckets) {
+        return bucket;
+    }
+    const auto exponent = bucket / kSubBuckets;
+    const auto subBucket = bucket % kSubBuckets;
+    // wraps to the largest value for the very last bucket
+    return ((kSubBuckets + subBucket + 1) << (exponent - 2)) - 1;
+}
+
+void LatencyStats::record(std::string_view name, std::chrono::nanoseconds latency) {
+    auto histogram = m_histograms.find(name);
+    if (histogram == m_histograms.end()) {
+        histogram = m_histograms.emplace(std::string{name}, LatencyHistogram{}).first;
+    }
+    histogram->second.record(latency);
+}
+
+std::string LatencyStats::format() const {
+    static constexpr auto kMedian = 0.5;
+    static constexpr auto kTail = 0.99;
+    auto table = fmt::format("{:<{}} {:>8} {:>8} {:>8} {:>8}\n", "name", kNameColumnWidth,
+                             "count", "p50", "p99", "max");
+    for (const auto &[name, histogram] : m_histograms) {
+        table += fmt::format("{:<{}} {:>8} {:>8} {:>8} {:>8}\n", name, kNameColumnWidth,
+                             histogram.count(), formatLatency(histogram.percentile(kMedian)),
+                             formatLatency(histogram.percentile(kTail)),
+                             formatLatency(histogram.max()));
+    }
+    return table;
+}
+
+} // namespace caps_log::utils
@@ -0,0 +1,84 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <string>
+#include <string_view>
+
+namespace caps_log::utils {
+
+/**
+ * Distribution of durations in logarithmic buckets, four per power of two, so recording is a
+ * couple of bit operations and the memory is fixed. Percentiles are reported as the upper bound
+ * of their bucket, which is at most 25% above the recorded value.
+ */
+class LatencyHistogram {
+  public:
+    void record(std::chrono::nanoseconds latency);
+
+    [[nodiscard]] std::uint64_t count() const { return m_count; }
+    [[nodiscard]] std::chrono::nanoseconds max() const { return m_max; }
+    /**
+     * Duration `fraction` (0 to 1) of the recorded durations do not exceed, zero if none were
+     * recorded.
+     */
+    [[nodiscard]] std::chrono::nanoseconds percentile(double fraction) const;
+
+  private:
+    static constexpr std::size_t kSubBuckets = 4;
+    static constexpr std::size_t kBuckets = 64 * kSubBuckets;
+
+    std::array<std::uint64_t, kBuckets> m_buckets{};
+    std::uint64_t m_count = 0;
+    std::chrono::nanoseconds m_max{0};
+
+    [[nodiscard]] static std::size_t bucketOf(std::uint64_t nanos);
+    [[nodiscard]] static std::uint64_t bucketUpperBound(std::size_t bucket);
+};
+
+/**
+ * Latency histograms by name. Not thread safe, meant to be filled from the UI thread.
+ */
+class LatencyStats {
+  public:
+    void record(std::string_view name, std::chrono::nanoseconds latency);
+
+    [[nodiscard]] const std::map<std::string, LatencyHistogram, std::less<>> &
+    histograms() const {
+        return m_histograms;
+    }
+
+    /**
+     * A table with a row of count, p50, p99 and max for each name, sorted by name.
+     */
+    [[nodiscard]] std::string format() const;
+
+  private:
+    std::map<std::string, LatencyHistogram, std::less<>> m_histograms;
+};
+
+/**
+ * Records the time from its construction to its destruction under `name`.
+ */
+class ScopedLatency {
+  public:
+    ScopedLatency(LatencyStats &stats, std::string_view name)
+        : m_stats{stats}, m_name{name}, m_start{std::chrono::steady_clock::now()} {}
+    ~ScopedLatency() { m_stats.record(m_name, std::chrono::steady_clock::now() - m_start); }
+
+    ScopedLatency(ScopedLatency &&) = delete;
+    ScopedLatency &operator=(ScopedLatency &&) = delete;
+    ScopedLatency(const ScopedLatency &) = delete;
+    ScopedLatency &operator=(const ScopedLatency &) = delete;
+
+  private:
+    LatencyStats &m_stats;
+    std::string_view m_name;
+    std::chrono::steady_clock::time_point m_start;
+};
+
+} // namespace caps_log::utils
@@ -0,0 +1,127 @@
+#include "mapped_file.hpp"
+
+#include <stdexcept>
+#include <utility>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace caps_log::utils {
+
+#ifdef _WIN32
+
+MappedFile::MappedFile(const std::filesystem::path &path) {
+    HANDLE file = CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_DELETE,
+                              nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE) { // NOLINT(performance-no-int-to-ptr)
+        throw std::runtime_error{"Failed to open file for mapping: " + path.string()};
+    }
+    LARGE_INTEGER size{};
+    if (GetFileSizeEx(file, &size) == 0) {
+        CloseHandle(file);
+        throw std::runtime_error{"Failed to get size of file: " + path.string()};
+    }
+    m_size = static_cast<std::size_t>(size.QuadPart);
+    if (m_size == 0) {
+        // empty files can not be mapped, an empty view is returned instead
+        CloseHandle(file);
+        return;
+    }
+    m_mappingHandle = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    CloseHandle(file);
+    if (m_mappingHandle == nullptr) {
+        throw std::runtime_error{"Failed to map file: " + path.string()};
+    }
+    m_data = static_cast<const char *>(MapViewOfFile(m_mappingHandle, FILE_MAP_READ, 0, 0, 0));
+    if (m_data == nullptr) {
+        CloseHandle(m_mappingHandle);
+        throw std::runtime_error{"Failed to map file: " + path.string()};
+    }
+}
+
+void MappedFile::unmap() noexcept {
+    if (m_data != nullptr) {
+        UnmapViewOfFile(m_data);
+    }
+    if (m_mappingHandle != nullptr) {
+        CloseHandle(m_mappingHandle);
+    }
+    m_data = nullptr;
+    m_mappingHandle = nullptr;
+    m_size = 0;
+}
+
+MappedFile::MappedFile(MappedFile &&other) noexcept
+    : m_data{std::exchange(other.m_data, nullptr)}, m_size{std::exchange(other.m_size, 0)},
+      m_mappingHandle{std::exchange(other.m_mappingHandle, nullptr)} {}
+
+MappedFile &MappedFile::operator=(MappedFile &&other) noexcept {
+    if (this != &other) {
+        unmap();
+        m_data = std::exchange(other.m_data, nullptr);
+        m_size = std::exchange(other.m_size, 0);
+        m_mappingHandle = std::exchange(other.m_mappingHandle, nullptr);
+    }
+    return *this;
+}
+
+#else
+
+MappedFile::MappedFile(const std::filesystem::path &path) {
+    const int fileDescriptor = ::open(path.c_str(), O_RDONLY | O_CLOEXEC); // NOLINT
+    if (fileDescriptor < 0) {
+        throw std::runtime_error{"Failed to open file for mapping: " + path.string()};
+    }
+    struct stat fileStat {};
+    if (::fstat(fileDescriptor, &fileStat) != 0) {
+        ::close(fileDescriptor);
+        throw std::runtime_error{"Failed to get size of file: " + path.string()};
+    }
+    m_size = static_cast<std::size_t>(fileStat.st_size);
+    if (m_size == 0) {
+        // empty files can not be mapped, an empty view is returned instead
+        ::close(fileDescriptor);
+        return;
+    }
+    void *mapping = ::mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, fileDescriptor, 0);
+    // the mapping keeps its own reference to the file
+    ::close(fileDescriptor);
+    if (mapping == MAP_FAILED) { // NOLINT(cppcoreguidelines-pro-type-cstyle-cast)
+        m_size = 0;
+        throw std::runtime_error{"Failed to map file: " + path.string()};
+    }
+    m_data = static_cast<const char *>(mapping);
+}
+
+void MappedFile::unmap() noexcept {
+    if (m_data != nullptr) {
+        ::munmap(const_cast<char *>(m_data), m_size); // NOLINT(cppcoreguidelines-pro-type-const-cast)
+    }
+    m_data = nullptr;
+    m_size = 0;
+}
+
+MappedFile::MappedFile(MappedFile &&other) noexcept
+    : m_data{std::exchange(other.m_data, nullptr)}, m_size{std::exchange(other.m_size, 0)} {}
+
+MappedFile &MappedFile::operator=(MappedFile &&other) noexcept {
+    if (this != &other) {
+        unmap();
+        m_data = std::exchange(other.m_data, nullptr);
+        m_size = std::exchange(other.m_size, 0);
+    }
+    return *this;
+}
+
+#endif
+
+MappedFile::~MappedFile() { unmap(); }
+
+} // namespace caps_log::utils
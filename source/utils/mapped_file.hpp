@@ -0,0 +1,38 @@
+#pragma once
+
+#include <filesystem>
+#include <string_view>
+
+namespace caps_log::utils {
+
+/**
+ * A read only memory mapping of a whole file. The mapping stays valid until the object is
+ * destroyed, the file must not be truncated while it is mapped: reading the pages past the new end
+ * raises SIGBUS. Replace the file by renaming a new one over it instead.
+ */
+class MappedFile {
+  public:
+    /**
+     * Maps the file at `path`, throws std::runtime_error if it can not be opened or mapped.
+     */
+    explicit MappedFile(const std::filesystem::path &path);
+    ~MappedFile();
+
+    MappedFile(const MappedFile &) = delete;
+    MappedFile &operator=(const MappedFile &) = delete;
+    MappedFile(MappedFile &&other) noexcept;
+    MappedFile &operator=(MappedFile &&other) noexcept;
+
+    [[nodiscard]] std::string_view data() const { return {m_data, m_size}; }
+
+  private:
+    const char *m_data = nullptr;
+    std::size_t m_size = 0;
+#ifdef _WIN32
+    void *m_mappingHandle = nullptr;
+#endif
+
+    void unmap() noexcept;
+};
+
+} // namespace caps_log::utils
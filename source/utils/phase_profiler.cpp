@@ -0,0 +1,101 @@
+#include "phase_profiler.hpp"
+
+#include <ctime>
+#include <fmt/format.h>
+#include <fstream>
+
+namespace caps_log::utils {
+
+namespace {
+constexpr auto kNameColumnWidth = 28;
+
+std::string formatTime(std::chrono::nanoseconds time) {
+    return fmt::format("{:.1f}ms", std::chrono::duration<double, std::milli>{time}.count());
+}
+
+std::string formatCount(const std::optional<std::uint64_t> &count) {
+    return count ? std::to_string(*count) : "-";
+}
+
+std::string formatBytes(const std::optional<std::uint64_t> &bytes) {
+    static constexpr auto kKibibyte = 1024.0;
+    if (not bytes) {
+        return "-";
+    }
+    return fmt::format("{:.1f}KiB", static_cast<double>(*bytes) / kKibibyte);
+}
+
+std::string formatRow(const PhaseProfiler::Phase &phase) {
+    return fmt::format("{:<{}} {:>10} {:>10} {:>8} {:>12}\n", phase.name, kNameColumnWidth,
+                       formatTime(phase.wallTime), formatTime(phase.cpuTime),
+                       formatCount(phase.readCalls), formatBytes(phase.readBytes));
+}
+
+std::optional<std::uint64_t> difference(const std::optional<std::uint64_t> &start,
+                                        const std::optional<std::uint64_t> &end) {
+    if (not start || not end) {
+        return std::nullopt;
+    }
+    return *end - *start;
+}
+
+std::optional<std::uint64_t> sum(const std::optional<std::uint64_t> &lhs,
+                                 const std::optional<std::uint64_t> &rhs) {
+    if (not lhs || not rhs) {
+        return std::nullopt;
+    }
+    return *lhs + *rhs;
+}
+} // namespace
+
+PhaseProfiler::Sample PhaseProfiler::Sample::take() {
+    Sample sample{
+        .wallTime = std::chrono::steady_clock::now(),
+        .cpuTime = std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::duration<double>{static_cast<double>(std::clock()) / CLOCKS_PER_SEC}),
+        .readCalls = std::nullopt,
+        .readBytes = std::nullopt,
+    };
+    // lines of `key: value`, only present on linux
+    std::ifstream io{"/proc/self/io"};
+    std::string key;
+    std::uint64_t value = 0;
+    while (io >> key >> value) {
+        if (key == "rchar:") {
+            sample.readBytes = value;
+        } else if (key == "syscr:") {
+            sample.readCalls = value;
+        }
+    }
+    return sample;
+}
+
+void PhaseProfiler::record(std::string name, const Sample &start, const Sample &end) {
+    m_phases.push_back(Phase{
+        .name = std::move(name),
+        .wallTime = end.wallTime - start.wallTime,
+        .cpuTime = end.cpuTime - start.cpuTime,
+        .readCalls = difference(start.readCalls, end.readCalls),
+        .readBytes = difference(start.readBytes, end.readBytes),
+    });
+}
+
+std::string PhaseProfiler::format() const {
+    auto table = fmt::format("{:<{}} {:>10} {:>10} {:>8} {:>12}\n", "phase", kNameColumnWidth,
+                             "wall", "cpu", "reads", "read bytes");
+    Phase total{.name = "total",
+                .wallTime = std::chrono::nanoseconds{0},
+                .cpuTime = std::chrono::nanoseconds{0},
+                .readCalls = 0,
+                .readBytes = 0};
+    for (const auto &phase : m_phases) {
+        table += formatRow(phase);
+        total.wallTime += phase.wallTime;
+        total.cpuTime += phase.cpuTime;
+        total.readCalls = sum(total.readCalls, phase.readCalls);
+        total.readBytes = sum(total.readBytes, phase.readBytes);
+    }
+    return table + formatRow(total);
+}
+
+} // namespace caps_log::utils
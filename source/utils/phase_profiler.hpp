@@ -0,0 +1,87 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace caps_log::utils {
+
+/**
+ * Measures consecutive phases of work, like the steps of the application startup, by their wall
+ * time, the CPU time of the whole process and the reads it made. The read counters come from
+ * `/proc/self/io` and are not available on other platforms, they include the couple of reads of
+ * the counters themselves.
+ */
+class PhaseProfiler {
+  public:
+    struct Phase {
+        std::string name;
+        std::chrono::nanoseconds wallTime{0};
+        std::chrono::nanoseconds cpuTime{0};
+        std::optional<std::uint64_t> readCalls;
+        std::optional<std::uint64_t> readBytes;
+    };
+
+    /**
+     * A disabled profiler only runs the measured functions, it records and reads nothing.
+     */
+    explicit PhaseProfiler(bool enabled = true) : m_enabled{enabled} {}
+
+    /**
+     * Runs `func` as a phase named `name` and returns what it returns. The phase is recorded even
+     * if `func` throws.
+     */
+    template <typename Func> decltype(auto) measure(std::string name, Func &&func) {
+        if (not m_enabled) {
+            return std::forward<Func>(func)();
+        }
+        const PhaseGuard guard{*this, std::move(name)};
+        return std::forward<Func>(func)();
+    }
+
+    [[nodiscard]] bool isEnabled() const { return m_enabled; }
+
+    [[nodiscard]] const std::vector<Phase> &getPhases() const { return m_phases; }
+
+    /**
+     * A table with a row per phase in the order they were measured, followed by their total.
+     */
+    [[nodiscard]] std::string format() const;
+
+  private:
+    struct Sample {
+        std::chrono::steady_clock::time_point wallTime;
+        std::chrono::nanoseconds cpuTime{0};
+        std::optional<std::uint64_t> readCalls;
+        std::optional<std::uint64_t> readBytes;
+
+        [[nodiscard]] static Sample take();
+    };
+
+    class PhaseGuard {
+      public:
+        PhaseGuard(PhaseProfiler &profiler, std::string name)
+            : m_profiler{profiler}, m_name{std::move(name)}, m_start{Sample::take()} {}
+        ~PhaseGuard() { m_profiler.record(std::move(m_name), m_start, Sample::take()); }
+
+        PhaseGuard(PhaseGuard &&) = delete;
+        PhaseGuard &operator=(PhaseGuard &&) = delete;
+        PhaseGuard(const PhaseGuard &) = delete;
+        PhaseGuard &operator=(const PhaseGuard &) = delete;
+
+      private:
+        PhaseProfiler &m_profiler;
+        std::string m_name;
+        Sample m_start;
+    };
+
+    bool m_enabled;
+    std::vector<Phase> m_phases;
+
+    void record(std::string name, const Sample &start, const Sample &end);
+};
+
+} // namespace caps_log::utils
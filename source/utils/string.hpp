@@ -2,6 +2,7 @@
 
 #include <algorithm>
 #include <string>
+#include <string_view>
 
 namespace caps_log::utils {
 
@@ -18,6 +19,20 @@ namespace caps_log::utils {
     return str.substr(strBegin, strRange);
 }
 
+/**
+ * Non allocating variant of `trim` that returns a view into the passed string.
+ */
+[[nodiscard]] inline std::string_view trimView(std::string_view str,
+                                               std::string_view whitespace = " \t\n") {
+    const auto strBegin = str.find_first_not_of(whitespace);
+    if (strBegin == std::string_view::npos) {
+        return {}; // no content
+    }
+
+    const auto strEnd = str.find_last_not_of(whitespace);
+    return str.substr(strBegin, strEnd - strBegin + 1);
+}
+
 [[nodiscard]] inline std::string lowercase(std::string data) {
     std::ranges::transform(data, data.begin(), [](char letter) { return std::tolower(letter); });
     return data;
@@ -0,0 +1,47 @@
+#include "symbol_table.hpp"
+
+#include <mutex>
+
+namespace caps_log::utils {
+
+SymbolTable &SymbolTable::global() {
+    static SymbolTable table;
+    return table;
+}
+
+SymbolId SymbolTable::intern(std::string_view name) {
+    {
+        const std::shared_lock lock{m_mutex};
+        if (const auto iter = m_ids.find(name); iter != m_ids.end()) {
+            return iter->second;
+        }
+    }
+
+    const std::unique_lock lock{m_mutex};
+    if (const auto iter = m_ids.find(name); iter != m_ids.end()) {
+        return iter->second;
+    }
+    const auto id = static_cast<SymbolId>(m_names.size());
+    m_ids.emplace(m_names.emplace_back(name), id);
+    return id;
+}
+
+std::optional<SymbolId> SymbolTable::find(std::string_view name) const {
+    const std::shared_lock lock{m_mutex};
+    if (const auto iter = m_ids.find(name); iter != m_ids.end()) {
+        return iter->second;
+    }
+    return std::nullopt;
+}
+
+std::string_view SymbolTable::name(SymbolId id) const {
+    const std::shared_lock lock{m_mutex};
+    return m_names.at(id);
+}
+
+std::size_t SymbolTable::size() const {
+    const std::shared_lock lock{m_mutex};
+    return m_names.size();
+}
+
+} // namespace caps_log::utils
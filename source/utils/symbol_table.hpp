@@ -0,0 +1,49 @@
+#pragma once
+
+#include <cstdint>
+#include <deque>
+#include <optional>
+#include <shared_mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+namespace caps_log::utils {
+
+using SymbolId = std::uint32_t;
+
+/**
+ * Interns strings (section and tag titles) into dense integer ids. Ids are handed out in the
+ * order the strings are first seen and stay valid for the lifetime of the table, as do the views
+ * returned by `name`. Thread safe.
+ */
+class SymbolTable {
+  public:
+    SymbolTable() = default;
+    SymbolTable(const SymbolTable &) = delete;
+    SymbolTable(SymbolTable &&) = delete;
+    SymbolTable &operator=(const SymbolTable &) = delete;
+    SymbolTable &operator=(SymbolTable &&) = delete;
+    ~SymbolTable() = default;
+
+    /**
+     * The table shared by all the log data of the application.
+     */
+    [[nodiscard]] static SymbolTable &global();
+
+    [[nodiscard]] SymbolId intern(std::string_view name);
+    /**
+     * Looks the name up without interning it.
+     */
+    [[nodiscard]] std::optional<SymbolId> find(std::string_view name) const;
+    [[nodiscard]] std::string_view name(SymbolId id) const;
+    [[nodiscard]] std::size_t size() const;
+
+  private:
+    mutable std::shared_mutex m_mutex;
+    // a deque never moves its elements, so the ids map can refer to the strings by view
+    std::deque<std::string> m_names;
+    std::unordered_map<std::string_view, SymbolId> m_ids;
+};
+
+} // namespace caps_log::utils
@@ -1,7 +1,10 @@
 #pragma once
 
+#include <atomic>
 #include <condition_variable>
+#include <cstdint>
 #include <functional>
+#include <future>
 #include <mutex>
 #include <queue>
 #include <thread>
@@ -36,11 +39,12 @@ class ThreadedTaskExecutor {
     }
 
   private:
-    std::thread m_worker;
     std::queue<std::function<void()>> m_tasks;
     std::mutex m_mutex;
     std::condition_variable m_condition;
     bool m_done{};
+    // declared last so the worker starts only after the members it uses are constructed
+    std::thread m_worker;
 
     void worker() {
         while (true) {
@@ -60,4 +64,56 @@ class ThreadedTaskExecutor {
     }
 };
 
+/**
+ * Runs background jobs one at a time, where posting a job cancels the jobs posted before it.
+ * Cancellation is cooperative: a job checks the `Token` it is given between units of work and
+ * returns early once a newer job was posted or `cancel` was called. Destroying the executor
+ * cancels the pending jobs and joins the worker, so declaring it as the last member of its owner
+ * keeps the rest of the owner alive while the jobs wind down.
+ */
+class CancellableTaskExecutor {
+  public:
+    class Token {
+      public:
+        [[nodiscard]] bool isCancelled() const { return *m_current != m_generation; }
+
+      private:
+        friend class CancellableTaskExecutor;
+        Token(const std::atomic<std::uint64_t> &current, std::uint64_t generation)
+            : m_current{&current}, m_generation{generation} {}
+
+        const std::atomic<std::uint64_t> *m_current;
+        std::uint64_t m_generation;
+    };
+
+    CancellableTaskExecutor() = default;
+    ~CancellableTaskExecutor() { cancel(); }
+
+    CancellableTaskExecutor(CancellableTaskExecutor &&) = delete;
+    CancellableTaskExecutor &operator=(CancellableTaskExecutor &&) = delete;
+    CancellableTaskExecutor(const CancellableTaskExecutor &) = delete;
+    CancellableTaskExecutor &operator=(const CancellableTaskExecutor &) = delete;
+
+    void post(std::function<void(const Token &)> job) {
+        const Token token{m_generation, ++m_generation};
+        m_executor.post([job = std::move(job), token]() { job(token); });
+    }
+
+    void cancel() { ++m_generation; }
+
+    /**
+     * Blocks until the jobs posted so far are done or have returned early.
+     */
+    void wait() {
+        std::promise<void> done;
+        auto future = done.get_future();
+        m_executor.post([&done]() { done.set_value(); });
+        future.wait();
+    }
+
+  private:
+    std::atomic<std::uint64_t> m_generation{};
+    ThreadedTaskExecutor m_executor;
+};
+
 } // namespace caps_log::utils
@@ -12,6 +12,7 @@
 #include <algorithm>
 #include <chrono>
 #include <string>
+#include <utility>
 
 #include <ftxui/screen/terminal.hpp>
 
@@ -24,6 +25,15 @@ int daysDifference(std::chrono::year_month_day from_ymd, std::chrono::year_month
     std::chrono::sys_days toSys{to_ymd};
     return static_cast<int>((toSys - fromSys).count());
 }
+
+enum DayFlag : std::uint8_t {
+    kToday = 1U << 0U,
+    kHighlighted = 1U << 1U,
+    kWeekend = 1U << 2U,
+    kHasLog = 1U << 3U,
+    kHasNoLog = 1U << 4U,
+    kEvent = 1U << 5U,
+};
 } // namespace
 
 using namespace ftxui;
@@ -34,9 +44,10 @@ AnnualViewLayout::AnnualViewLayout(InputHandlerBase *handler,
                                    AnnualViewConfig config)
     : m_handler{handler}, m_screenSizeProvider{std::move(screenSizeProvider)}, m_today{today},
       m_config{std::move(config)},
-      m_calendarButtons{Calendar::make(m_screenSizeProvider, today, makeCalendarOptions(today))},
+      m_calendarButtons{Calendar::make(m_screenSizeProvider, today, makeCalendarOptions())},
       m_tagsMenu{makeTagsMenu()}, m_sectionsMenu{makeSectionsMenu()},
-      m_eventsList{makeEventsList()}, m_rootComponent{makeFullUIComponent()} {}
+      m_eventsList{makeEventsList()}, m_queryInput{makeQueryInput()},
+      m_rootComponent{makeFullUIComponent()} {}
 
 void AnnualViewLayout::showCalendarForYear(std::chrono::year year) {
     m_calendarButtons->displayYear(year);
@@ -57,6 +68,7 @@ std::shared_ptr<ComponentBase> AnnualViewLayout::makeFullUIComponent() {
     const auto dateStr = utils::date::formatToString(m_today, "%d. %m. %Y.");
     const auto wholeUiRenderer = Renderer(logContainer, [this, logContainer, dateStr,
                                                          firstRender = true]() mutable {
+        updateDayFlags();
         // preview window can sometimes be wider than the menus & calendar, it's simpler to keep
         // them centered while the preview window changes and stretches this vbox container than
         // to keep the preview window size fixed
@@ -86,9 +98,17 @@ std::shared_ptr<ComponentBase> AnnualViewLayout::makeFullUIComponent() {
         mainSectionElements.push_back(m_calendarButtons->Render());
         const auto mainSection = hbox(mainSectionElements);
 
+        auto queryLine = emptyElement();
+        if (m_isQueryOpen || not m_query.empty()) {
+            queryLine = hbox(text(m_isTextSearch ? "? " : "/ "),
+                             m_isQueryOpen ? m_queryInput->Render() : text(m_query),
+                             text(" " + m_queryStatus) | dim);
+        }
+
         static const auto kHelpString =
-            std::string{"hjkl/arrow keys - navigation | d - delete log | s - see scratchpads | tab "
-                        "- move focus between menus and calendar"};
+            std::string{"hjkl/arrow keys - navigation | d - delete log | s - see scratchpads | / - "
+                        "tag query | ? - text search | f - filter menu | tab - move focus between "
+                        "menus and calendar"};
         if (firstRender) {
             firstRender = false;
             m_handler->handleInputEvent(UIEvent{UiStarted{}});
@@ -98,6 +118,8 @@ std::shared_ptr<ComponentBase> AnnualViewLayout::makeFullUIComponent() {
         return vbox(
             text(titleText) 
                 | bold | underlined | center, 
+            queryLine
+                | center,
             mainSection 
                 | center,
             m_preview->Render()    
@@ -109,6 +131,24 @@ std::shared_ptr<ComponentBase> AnnualViewLayout::makeFullUIComponent() {
     });
 
     const auto eventHandler = CatchEvent(wholeUiRenderer, [&](const ftxui::Event &event) {
+        if (m_isQueryOpen) {
+            return handleQueryEvent(event);
+        }
+        // the menu being filtered gets every key
+        if (m_tagsMenu->isFiltering() || m_sectionsMenu->isFiltering()) {
+            return false;
+        }
+        if (event == Event::Character('/') || event == Event::Character('?')) {
+            openQuery(event == Event::Character('?'));
+            return true;
+        }
+        if (event == Event::Escape) {
+            for (const auto &menu : {m_tagsMenu, m_sectionsMenu}) {
+                if (menu->Focused() && menu->clearFilter()) {
+                    return true;
+                }
+            }
+        }
         // controller does not care about mouse events
         if (not event.is_mouse()) {
             return m_handler->handleInputEvent(UIEvent{UnhandledRootEvent{event.input()}});
@@ -119,17 +159,66 @@ std::shared_ptr<ComponentBase> AnnualViewLayout::makeFullUIComponent() {
     return eventHandler;
 }
 
-CalendarOption AnnualViewLayout::makeCalendarOptions(const std::chrono::year_month_day &today) {
+Component AnnualViewLayout::makeQueryInput() {
+    return Input(&m_query, &m_queryPlaceholder,
+                 {
+                     .multiline = false,
+                     .on_change = [this] { notifyQueryChange(); },
+                 });
+}
+
+void AnnualViewLayout::openQuery(bool isTextSearch) {
+    if (isTextSearch != m_isTextSearch && not m_query.empty()) {
+        // switching between a tag query and a text search drops the applied one
+        m_query.clear();
+        notifyQueryChange();
+    }
+    m_isTextSearch = isTextSearch;
+    m_queryPlaceholder = isTextSearch ? "words the logs contain, e.g. dentist appointment"
+                                      : "e.g. work & !meeting | (section:health & run)";
+    m_isQueryOpen = true;
+}
+
+void AnnualViewLayout::notifyQueryChange() {
+    if (m_isTextSearch) {
+        m_handler->handleInputEvent(UIEvent{SearchChange{m_query}});
+    } else {
+        m_handler->handleInputEvent(UIEvent{QueryChange{m_query}});
+    }
+}
+
+bool AnnualViewLayout::handleQueryEvent(const ftxui::Event &event) {
+    if (event == Event::Escape) {
+        // dropping the query brings back the highlights of the menus
+        m_isQueryOpen = false;
+        m_query.clear();
+        notifyQueryChange();
+        return true;
+    }
+    if (event == Event::Return) {
+        // the query stays applied, '/' or '?' opens it again
+        m_isQueryOpen = false;
+        return true;
+    }
+    if (event.is_mouse()) {
+        return false;
+    }
+    // while typing, keys must not reach the shortcuts of the controller or the menus
+    m_queryInput->OnEvent(event);
+    return true;
+}
+
+CalendarOption AnnualViewLayout::makeCalendarOptions() {
     CalendarOption option;
-    option.transform = [this, today](const auto &date, const auto &state) {
+    option.transform = [this](const auto &date, const auto &state) {
+        const auto flags = m_dayFlags.at(utils::date::Dates::toIndex(utils::date::monthDay(date)));
         auto element = text(state.label);
 
-        if (today == date) {
+        if ((flags & kToday) != 0) {
             element = element | m_config.theme.todaysDateDecorator;
-        } else if (m_highlightedDates &&
-                   m_highlightedDates->contains(utils::date::monthDay(date))) {
+        } else if ((flags & kHighlighted) != 0) {
             element = element | m_config.theme.highlightedDateDecorator;
-        } else if (utils::date::isWeekend(date)) {
+        } else if ((flags & kWeekend) != 0) {
             element = element | m_config.theme.weekendDateDecorator;
         }
 
@@ -137,28 +226,29 @@ CalendarOption AnnualViewLayout::makeCalendarOptions(const std::chrono::year_mon
             element = element | inverted;
         }
 
-        if (m_datesWithLogs) {
-            if (m_datesWithLogs->contains(utils::date::monthDay(date))) {
-                element = element | m_config.theme.logDateDecorator;
-            } else {
-                element = element | m_config.theme.emptyDateDecorator;
-            }
+        if ((flags & kHasLog) != 0) {
+            element = element | m_config.theme.logDateDecorator;
+        } else if ((flags & kHasNoLog) != 0) {
+            element = element | m_config.theme.emptyDateDecorator;
         }
 
-        if (m_eventDates) {
-            for (const auto &[_, events] : *m_eventDates) {
-                const auto isEvent = std::ranges::any_of(events, [date](const auto &event) {
-                    return event.date == utils::date::monthDay(date);
-                });
-                if (isEvent) {
-                    element = element | m_config.theme.eventDateDecorator;
-                    break;
-                }
-            }
+        if ((flags & kEvent) != 0) {
+            element = element | m_config.theme.eventDateDecorator;
         }
 
         return element | center;
     };
+    option.monthState = [this](std::chrono::month month) {
+        using utils::date::Dates;
+        const auto begin = Dates::toIndex(month / 1);
+        const auto end = month == std::chrono::December
+                             ? Dates::kCapacity
+                             : Dates::toIndex((month + std::chrono::months{1}) / 1);
+        CalendarOption::MonthState state{};
+        std::copy(m_dayFlags.begin() + static_cast<std::ptrdiff_t>(begin),
+                  m_dayFlags.begin() + static_cast<std::ptrdiff_t>(end), state.begin());
+        return state;
+    };
     option.focusChange = [this](const auto &date) {
         m_preview->resetScroll();
         m_handler->handleInputEvent(UIEvent{FocusedDateChange{}});
@@ -172,6 +262,51 @@ CalendarOption AnnualViewLayout::makeCalendarOptions(const std::chrono::year_mon
     return option;
 }
 
+void AnnualViewLayout::updateDayFlags() {
+    using utils::date::Dates;
+    const auto year = m_calendarButtons->getFocusedDate().year();
+    const auto copyOf = [](const Dates *dates) {
+        return dates != nullptr ? std::optional{*dates} : std::nullopt;
+    };
+    auto key = DayFlagsKey{
+        .year = year,
+        .highlightedDates = copyOf(m_highlightedDates),
+        .datesWithLogs = copyOf(m_datesWithLogs),
+    };
+    if (key == m_dayFlagsKey) {
+        return;
+    }
+    m_dayFlagsKey = std::move(key);
+
+    for (std::size_t index = 0; index < Dates::kCapacity; index++) {
+        const auto monthDay = Dates::fromIndex(index);
+        const auto date = year / monthDay;
+        std::uint8_t flags = 0;
+        if (date == m_today) {
+            flags |= kToday;
+        }
+        if (m_highlightedDates != nullptr && m_highlightedDates->contains(monthDay)) {
+            flags |= kHighlighted;
+        }
+        if (date.ok() && utils::date::isWeekend(date)) {
+            flags |= kWeekend;
+        }
+        if (m_datesWithLogs != nullptr) {
+            flags |= m_datesWithLogs->contains(monthDay) ? kHasLog : kHasNoLog;
+        }
+        m_dayFlags.at(index) = flags;
+    }
+    if (m_eventDates != nullptr) {
+        for (const auto &[_, events] : *m_eventDates) {
+            for (const auto &event : events) {
+                if (event.date.ok()) {
+                    m_dayFlags.at(Dates::toIndex(event.date)) |= kEvent;
+                }
+            }
+        }
+    }
+}
+
 Component AnnualViewLayout::makeEventsList() {
     MenuOption menuOption;
     menuOption.entries = &m_recentAndUpcomingEventsList;
@@ -209,10 +344,12 @@ std::shared_ptr<WindowedMenu> AnnualViewLayout::makeTagsMenu() {
     WindowedMenuOption option{
         .title = "Tags",
         .entries = &m_tagMenuItems.getDisplayTexts(),
+        .entriesVersion = &m_tagMenuItems.getVersion(),
         .onChange = [this] { m_handler->handleInputEvent(UIEvent{FocusedTagChange{}}); },
         .border = m_config.theme.tagsMenuConfig.border,
         .entryDecorator = m_config.theme.tagsMenuConfig.entryDecorator,
         .selectedEntryDecorator = m_config.theme.tagsMenuConfig.selectedEntryDecorator,
+        .filterable = true,
     };
     return WindowedMenu::make(option);
 }
@@ -221,10 +358,12 @@ std::shared_ptr<WindowedMenu> AnnualViewLayout::makeSectionsMenu() {
     WindowedMenuOption option = {
         .title = "Sections",
         .entries = &m_sectionMenuItems.getDisplayTexts(),
+        .entriesVersion = &m_sectionMenuItems.getVersion(),
         .onChange = [this] { m_handler->handleInputEvent(UIEvent{FocusedSectionChange{}}); },
         .border = m_config.theme.sectionsMenuConfig.border,
         .entryDecorator = m_config.theme.sectionsMenuConfig.entryDecorator,
         .selectedEntryDecorator = m_config.theme.sectionsMenuConfig.selectedEntryDecorator,
+        .filterable = true,
     };
     return WindowedMenu::make(option);
 }
@@ -233,13 +372,15 @@ void AnnualViewLayout::setPreviewString(const std::string &title, const std::str
     m_preview->setContent(title, string);
 }
 
+void AnnualViewLayout::setQueryStatus(const std::string &status) { m_queryStatus = status; }
+
 void AnnualViewLayout::setSelectedTag(std::string tag) {
     const auto tagInMenu =
         std::find(m_tagMenuItems.getKeys().begin(), m_tagMenuItems.getKeys().end(), tag);
     const auto newSelected = tagInMenu != m_tagMenuItems.getKeys().end()
                                  ? std::distance(m_tagMenuItems.getKeys().begin(), tagInMenu)
                                  : 0;
-    m_tagsMenu->selected() = static_cast<int>(newSelected);
+    m_tagsMenu->select(static_cast<int>(newSelected));
 }
 
 void AnnualViewLayout::setSelectedSection(std::string section) {
@@ -249,7 +390,7 @@ void AnnualViewLayout::setSelectedSection(std::string section) {
         sectionInMenu != m_sectionMenuItems.getKeys().end()
             ? std::distance(m_sectionMenuItems.getKeys().begin(), sectionInMenu)
             : 0;
-    m_sectionsMenu->selected() = static_cast<int>(newSelected);
+    m_sectionsMenu->select(static_cast<int>(newSelected));
 }
 
 const std::string &AnnualViewLayout::getSelectedTag() const {
@@ -267,6 +408,7 @@ std::chrono::year_month_day AnnualViewLayout::getFocusedDate() const {
 // NOLINTNEXTLINE(readability-function-cognitive-complexity)
 void AnnualViewLayout::setEventDates(const CalendarEvents *events) {
     m_eventDates = events;
+    m_dayFlagsKey.reset();
     const auto [eventItems, groupItemIndex, todaysEventStr] = [this] {
         std::vector<std::string> eventItems;
         std::vector<std::size_t> groupItemIndex;
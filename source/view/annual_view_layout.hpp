@@ -8,12 +8,15 @@
 #include "utils/date.hpp"
 #include "windowed_menu.hpp"
 
+#include <array>
 #include <chrono>
+#include <cstdint>
 #include <ftxui/component/captured_mouse.hpp>
 #include <ftxui/component/component.hpp>
 #include <ftxui/component/screen_interactive.hpp>
 #include <ftxui/component/task.hpp>
 #include <ftxui/dom/elements.hpp>
+#include <optional>
 
 namespace caps_log::view {
 
@@ -56,6 +59,18 @@ class AnnualViewLayout : public AnnualViewLayoutBase {
     const utils::date::Dates *m_highlightedDates = nullptr;
     const utils::date::Dates *m_datesWithLogs = nullptr;
     const CalendarEvents *m_eventDates = nullptr;
+    // how each day of the displayed year is decorated, indexed by `Dates::toIndex`, so rendering a
+    // day is a lookup. Rebuilt from the maps above only when they or the displayed year change
+    std::array<std::uint8_t, utils::date::Dates::kCapacity> m_dayFlags{};
+    // what `m_dayFlags` was built from. The dates are compared by value as the app modifies them
+    // in place, `setEventDates` resets the key instead
+    struct DayFlagsKey {
+        std::chrono::year year;
+        std::optional<utils::date::Dates> highlightedDates;
+        std::optional<utils::date::Dates> datesWithLogs;
+        bool operator==(const DayFlagsKey &) const = default;
+    };
+    std::optional<DayFlagsKey> m_dayFlagsKey;
 
     // Menu items for m_tagsMenu & m_sectionsMenu
     MenuItems m_tagMenuItems, m_sectionMenuItems;
@@ -65,6 +80,15 @@ class AnnualViewLayout : public AnnualViewLayoutBase {
     std::vector<std::size_t> m_recentAndUpcomingEventsGroupItemIndex;
     std::string m_todaysEventString;
 
+    // Tag query opened with '/' or text search opened with '?', only one of them is applied at a
+    // time and it is evaluated by the input handler as it is typed
+    std::string m_query;
+    std::string m_queryStatus;
+    std::string m_queryPlaceholder;
+    bool m_isQueryOpen = false;
+    bool m_isTextSearch = false;
+    ftxui::Component m_queryInput;
+
     std::shared_ptr<ftxui::ComponentBase> m_rootComponent;
 
   public:
@@ -79,6 +103,7 @@ class AnnualViewLayout : public AnnualViewLayoutBase {
     void setEventDates(const CalendarEvents *events) override;
 
     void setPreviewString(const std::string &title, const std::string &string) override;
+    void setQueryStatus(const std::string &status) override;
 
     [[nodiscard]] std::chrono::year_month_day getFocusedDate() const override;
 
@@ -100,7 +125,12 @@ class AnnualViewLayout : public AnnualViewLayoutBase {
     std::shared_ptr<WindowedMenu> makeTagsMenu();
     std::shared_ptr<WindowedMenu> makeSectionsMenu();
     ftxui::Component makeEventsList();
-    CalendarOption makeCalendarOptions(const std::chrono::year_month_day &today);
+    ftxui::Component makeQueryInput();
+    bool handleQueryEvent(const ftxui::Event &event);
+    void openQuery(bool isTextSearch);
+    void notifyQueryChange();
+    CalendarOption makeCalendarOptions();
+    void updateDayFlags();
 };
 
 } // namespace caps_log::view
@@ -3,9 +3,12 @@
 #include "utils/date.hpp"
 #include "view/view_layout_base.hpp"
 
+#include <atomic>
 #include <chrono>
+#include <cstdint>
 #include <ftxui/component/task.hpp>
 #include <map>
+#include <set>
 #include <string>
 #include <vector>
 
@@ -26,7 +29,8 @@ class MenuItems {
     MenuItems() = default;
 
     MenuItems(std::vector<std::string> displayTexts, std::vector<std::string> keys)
-        : m_displayTexts{std::move(displayTexts)}, m_keys{std::move(keys)} {
+        : m_displayTexts{std::move(displayTexts)}, m_keys{std::move(keys)},
+          m_version{nextVersion()} {
         if (m_displayTexts.size() != m_keys.size()) {
             throw std::invalid_argument(
                 "MenuItems: displayTexts and keys must have the same size.");
@@ -38,9 +42,21 @@ class MenuItems {
     [[nodiscard]] const std::vector<std::string> &getDisplayTexts() const { return m_displayTexts; }
     [[nodiscard]] const std::vector<std::string> &getKeys() const { return m_keys; }
 
+    /**
+     * Items are immutable and every constructed set of items gets a new version that is kept by
+     * its copies, so two items with the same version have the same entries.
+     */
+    [[nodiscard]] const std::uint64_t &getVersion() const { return m_version; }
+
   private:
     std::vector<std::string> m_displayTexts;
     std::vector<std::string> m_keys;
+    std::uint64_t m_version = 0;
+
+    static std::uint64_t nextVersion() {
+        static std::atomic<std::uint64_t> lastVersion{};
+        return ++lastVersion;
+    }
 };
 
 struct CalendarEvent {
@@ -62,6 +78,8 @@ class AnnualViewLayoutBase : public ViewLayoutBase {
     virtual void setHighlightedDates(const utils::date::Dates *map) = 0;
     virtual void setEventDates(const CalendarEvents *map) {};
     virtual void setPreviewString(const std::string &title, const std::string &string) = 0;
+    // shown next to the tag query, e.g. the number of matches or why the query is not valid
+    virtual void setQueryStatus(const std::string & /*status*/) {};
 
     virtual void setSelectedTag(std::string tag) = 0;
     virtual void setSelectedSection(std::string section) = 0;
@@ -8,6 +8,8 @@
 #include <ftxui/screen/screen.hpp>
 #include <ftxui/screen/terminal.hpp>
 #include <memory>
+#include <optional>
+#include <utility>
 
 namespace caps_log::view {
 using namespace ftxui;
@@ -81,7 +83,8 @@ Calendar::Calendar(std::function<ftxui::Dimensions()> screenSizeProvider,
       // TODO: SetActiveChild does nothing, this is the only
       // way to focus a specific date on startup. Investigate.
       m_selectedMonthComponentIdx{(static_cast<int>(static_cast<unsigned>(today.month()))) - 1},
-      m_root{createYear(m_today.year())}, m_displayedYear{m_today.year()} {
+      m_displayedYear{m_today.year()} {
+    m_root = yearComponent(m_displayedYear);
     Add(m_root);
     // the rest will selfcorrect
     m_selectedDayButtonIdxMap.at(m_selectedMonthComponentIdx) =
@@ -91,7 +94,7 @@ Calendar::Calendar(std::function<ftxui::Dimensions()> screenSizeProvider,
 void Calendar::displayYear(std::chrono::year year) {
     m_displayedYear = year;
     m_root->Detach();
-    m_root = createYear(year);
+    m_root = yearComponent(year);
     Add(m_root);
 }
 
@@ -100,6 +103,9 @@ bool Calendar::OnEvent(ftxui::Event event) {
     // ftxui containers as for ftxui menus, this is a workaround to
     // check for selection change and trigger a callback
     static auto lastSelectedDate = getFocusedDate();
+    if (event.is_mouse()) {
+        m_mousePosition = {event.mouse().x, event.mouse().y};
+    }
     const auto result = ftxui::ComponentBase::OnEvent(event);
     const auto newDate = getFocusedDate();
     if (m_option.focusChange && lastSelectedDate != newDate) {
@@ -123,14 +129,22 @@ std::chrono::year_month_day Calendar::getFocusedDate() const {
         day{(unsigned)m_selectedDayButtonIdxMap.at(m_selectedMonthComponentIdx) + 1});
 }
 
-Component Calendar::createYear(std::chrono::year year) {
+Component Calendar::yearComponent(std::chrono::year year) {
+    auto &component = m_yearComponents.at(year.is_leap() ? 1 : 0);
+    if (component == nullptr) {
+        component = createYear(year.is_leap());
+    }
+    return component;
+}
+
+Component Calendar::createYear(bool isLeap) {
     Components monthComponents;
 
     // NOTE: std:: ++ operator for months loops over valid months in circle forever
     constexpr unsigned kJan = 1U;
     constexpr unsigned kDecPlusOne = 13U;
     for (auto month = kJan; month < kDecPlusOne; month++) {
-        monthComponents.push_back(createMonth({year, std::chrono::month{month}}));
+        monthComponents.push_back(createMonth(std::chrono::month{month}, isLeap));
     }
     const auto container = ftxui_ext::AnyDir(monthComponents, &m_selectedMonthComponentIdx);
 
@@ -140,7 +154,7 @@ Component Calendar::createYear(std::chrono::year year) {
     });
 }
 
-Component Calendar::createMonth(std::chrono::year_month year_month) {
+Component Calendar::createMonth(std::chrono::month month, bool isLeap) {
     static const auto kMonthWeekdayHeaderElement = [](const std::string &txt) {
         return center(text(txt)) | size(WIDTH, EQUAL, 3) | size(HEIGHT, EQUAL, 1);
     };
@@ -154,30 +168,55 @@ Component Calendar::createMonth(std::chrono::year_month year_month) {
         return elements | underlined;
     };
 
+    // any year with the same number of days in february has the same days
     const auto numOfDays =
-        std::chrono::year_month_day_last{year_month.year(),
-                                         std::chrono::month_day_last{year_month.month()}}
+        std::chrono::year_month_day_last{std::chrono::year{isLeap ? 2000 : 2001},
+                                         std::chrono::month_day_last{month}}
             .day();
 
     Components buttons;
     for (auto day = std::chrono::day{1}; day <= numOfDays; day++) {
-        buttons.push_back(
-            createDay(std::chrono::year_month_day{year_month.year(), year_month.month(), day}));
+        buttons.push_back(createDay(month / day));
     }
     static constexpr auto kDaysPerWeek = 7;
-    const auto container = ftxui_ext::Grid(
-        kDaysPerWeek, buttons,
-        &m_selectedDayButtonIdxMap.at(static_cast<unsigned>(year_month.month()) - 1));
+    const auto monthIndex = static_cast<unsigned>(month) - 1;
+    const auto container =
+        ftxui_ext::Grid(kDaysPerWeek, buttons, &m_selectedDayButtonIdxMap.at(monthIndex));
 
-    return Renderer(container, [&displayedYear = m_displayedYear, yearMonth = year_month,
+    // the key of the last rendered element, a month is built again only if it changed
+    struct RenderKey {
+        CalendarOption::MonthState state;
+        int year;
+        int selectedDay;
+        bool focused;
+        // only set while the mouse is over the month
+        std::optional<std::pair<int, int>> hovered;
+        bool operator==(const RenderKey &) const = default;
+    };
+    return Renderer(container, [&displayedYear = m_displayedYear, month,
                                 sundayStart = (m_option.sundayStart ? 1 : 0),
-                                buttons = std::move(buttons), this]() {
+                                buttons = std::move(buttons), monthIndex,
+                                lastKey = std::optional<RenderKey>{},
+                                lastElement = Element{}, this]() mutable {
+        std::optional<RenderKey> key;
+        if (m_option.monthState) {
+            key = RenderKey{
+                .state = m_option.monthState(month),
+                .year = static_cast<int>(displayedYear),
+                .selectedDay = m_selectedDayButtonIdxMap.at(monthIndex),
+                .focused = Focused() && std::cmp_equal(m_selectedMonthComponentIdx, monthIndex),
+                .hovered = hoveredPosition(monthIndex),
+            };
+            if (key == lastKey) {
+                return lastElement;
+            }
+        }
+
         const auto header =
             sundayStart == 1 ? kMonthHeaderElement("SMTWTFS") : kMonthHeaderElement("MTWTFSS");
         std::vector<Elements> renderData = {header, {}};
         const auto startingWeekday =
-            utils::date::getStartingWeekdayForMonth({displayedYear, yearMonth.month()}) +
-            sundayStart;
+            utils::date::getStartingWeekdayForMonth({displayedYear, month}) + sundayStart;
         unsigned currentWeekday = startingWeekday - 1;
         unsigned calendarDay = 1;
         for (int i = 1; i < startingWeekday; i++) {
@@ -191,24 +230,35 @@ Component Calendar::createMonth(std::chrono::year_month year_month) {
             calendarDay++;
             currentWeekday++;
         }
-        return window(text(utils::date::getStringNameForMonth(yearMonth.month())),
-                      gridbox(renderData), m_option.monthBorder);
+        lastKey = key;
+        lastElement = window(text(utils::date::getStringNameForMonth(month)),
+                             gridbox(renderData), m_option.monthBorder) |
+                      reflect(m_monthBoxes.at(monthIndex));
+        return lastElement;
     });
 }
 
-Component Calendar::createDay(const std::chrono::year_month_day &date) {
+std::optional<std::pair<int, int>> Calendar::hoveredPosition(unsigned monthIndex) const {
+    if (m_mousePosition &&
+        m_monthBoxes.at(monthIndex).Contain(m_mousePosition->first, m_mousePosition->second)) {
+        return m_mousePosition;
+    }
+    return std::nullopt;
+}
 
+Component Calendar::createDay(std::chrono::month_day monthDay) {
+    // the same button is used for this day of every displayed year
     ButtonOption opts{};
     if (m_option.transform) {
-        opts.transform = [this, date](const auto &state) {
-            return m_option.transform(date, state);
+        opts.transform = [this, monthDay](const auto &state) {
+            return m_option.transform(m_displayedYear / monthDay, state);
         };
     }
     return Button(
-        std::to_string(static_cast<unsigned>(date.day())),
-        [this, date]() {
+        std::to_string(static_cast<unsigned>(monthDay.day())),
+        [this, monthDay]() {
             if (m_option.enter) {
-                m_option.enter(date);
+                m_option.enter(m_displayedYear / monthDay);
             }
         },
         opts);
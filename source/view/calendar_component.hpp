@@ -1,17 +1,28 @@
 #pragma once
 
+#include <array>
 #include <chrono>
+#include <cstdint>
+#include <optional>
+#include <utility>
 #include <ftxui/component/component.hpp>
 #include <ftxui/component/component_options.hpp>
+#include <ftxui/screen/box.hpp>
 #include <ftxui/screen/screen.hpp>
 
 namespace caps_log::view {
 
 struct CalendarOption {
+    // what `transform` renders each day of a month from, unused days are 0
+    using MonthState = std::array<std::uint8_t, 31>;
+
     std::function<ftxui::Element(const std::chrono::year_month_day &, const ftxui::EntryState &)>
         transform = nullptr;
     std::function<void(const std::chrono::year_month_day &)> focusChange = nullptr;
     std::function<void(const std::chrono::year_month_day &)> enter = nullptr;
+    // if set, a month is rendered again only when its state, the year or the focused day change,
+    // or when the mouse moves over it
+    std::function<MonthState(std::chrono::month)> monthState = nullptr;
     bool sundayStart = false;
     ftxui::BorderStyle calendarBorder;
     ftxui::BorderStyle monthBorder;
@@ -22,11 +33,17 @@ class Calendar : public ftxui::ComponentBase {
     CalendarOption m_option;
     std::chrono::year_month_day m_today;
     ftxui::Component m_root;
+    // component trees for common and leap years, built once and reused for every displayed year
+    std::array<ftxui::Component, 2> m_yearComponents;
     int m_selectedMonthComponentIdx;
     std::array<int, static_cast<unsigned>(std::chrono::December)> m_selectedDayButtonIdxMap{
         0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
     };
     std::chrono::year m_displayedYear;
+    // where each month was last drawn and the last known mouse position, a month is rendered again
+    // on mouse events only while the mouse is over it as hovering changes how a day is rendered
+    std::array<ftxui::Box, static_cast<unsigned>(std::chrono::December)> m_monthBoxes{};
+    std::optional<std::pair<int, int>> m_mousePosition;
 
   public:
     Calendar(std::function<ftxui::Dimensions()> screenSizeProvider,
@@ -49,9 +66,11 @@ class Calendar : public ftxui::ComponentBase {
     }
 
   private:
-    ftxui::Component createYear(std::chrono::year);
-    ftxui::Component createMonth(std::chrono::year_month);
-    ftxui::Component createDay(const std::chrono::year_month_day &date);
+    ftxui::Component yearComponent(std::chrono::year year);
+    ftxui::Component createYear(bool isLeap);
+    ftxui::Component createMonth(std::chrono::month month, bool isLeap);
+    ftxui::Component createDay(std::chrono::month_day monthDay);
+    [[nodiscard]] std::optional<std::pair<int, int>> hoveredPosition(unsigned monthIndex) const;
 };
 
 } // namespace caps_log::view
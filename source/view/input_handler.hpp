@@ -1,7 +1,9 @@
 #pragma once
 
+#include <array>
 #include <chrono>
 #include <string>
+#include <string_view>
 #include <variant>
 
 namespace caps_log::view {
@@ -26,6 +28,12 @@ struct DeleteScratchpad {
 struct RenameScratchpad {
     std::string name;
 };
+struct QueryChange {
+    std::string query;
+};
+struct SearchChange {
+    std::string text;
+};
 struct UnhandledRootEvent {
     std::string input;
 };
@@ -36,7 +44,30 @@ struct UnhandledRootEvent {
  */
 using UIEvent = std::variant<UiStarted, DisplayedYearChange, OpenLogFile, FocusedSectionChange,
                              FocusedTagChange, FocusedDateChange, UnhandledRootEvent,
-                             OpenScratchpad, DeleteScratchpad, RenameScratchpad>;
+                             OpenScratchpad, DeleteScratchpad, RenameScratchpad, QueryChange,
+                             SearchChange>;
+
+/**
+ * Name of the type of the event, used to tell apart the event latencies.
+ */
+[[nodiscard]] inline std::string_view uiEventName(const UIEvent &event) {
+    static constexpr auto kNames = std::to_array<std::string_view>({
+        "event:UiStarted",
+        "event:DisplayedYearChange",
+        "event:OpenLogFile",
+        "event:FocusedSectionChange",
+        "event:FocusedTagChange",
+        "event:FocusedDateChange",
+        "event:UnhandledRootEvent",
+        "event:OpenScratchpad",
+        "event:DeleteScratchpad",
+        "event:RenameScratchpad",
+        "event:QueryChange",
+        "event:SearchChange",
+    });
+    static_assert(kNames.size() == std::variant_size_v<UIEvent>);
+    return kNames.at(event.index());
+}
 
 /**
  * @brief A base class for handling input events in the application.
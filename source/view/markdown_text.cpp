@@ -2,6 +2,7 @@
 
 #include <algorithm>
 #include <ftxui/dom/elements.hpp>
+#include <ftxui/screen/string.hpp>
 #include <string>
 #include <string_view>
 #include <vector>
@@ -292,13 +293,8 @@ inline ftxui::Element renderInline(std::string_view lineView, const MarkdownThem
 }
 
 // ---------- Block parsing (preserves raw prefixes/fences) ----------
-struct ParseState {
-    bool inFence = false;
-    char fenceChar = '`';
-};
-
 // NOLINTNEXTLINE(readability-function-cognitive-complexity)
-inline ftxui::Element decorateLine(std::string_view lineView, ParseState &parseState,
+inline ftxui::Element decorateLine(std::string_view lineView, MarkdownParseState &parseState,
                                    const MarkdownTheme &theme) {
     using namespace ftxui;
 
@@ -414,7 +410,7 @@ ftxui::Elements markdown(std::string_view documentView, const MarkdownTheme &the
     Elements elementList;
     elementList.reserve(static_cast<std::size_t>(std::ranges::count(documentView, '\n')) + 1);
 
-    ParseState parseState{};
+    MarkdownParseState parseState{};
     std::size_t scanPosition = 0;
 
     while (scanPosition <= documentView.size()) {
@@ -435,4 +431,42 @@ ftxui::Elements markdown(std::string_view documentView, const MarkdownTheme &the
     return elementList;
 }
 
+MarkdownDocument::MarkdownDocument(std::string content, const MarkdownTheme &theme)
+    : m_content{std::move(content)}, m_theme{theme} {
+    m_lineBegins.push_back(0);
+    for (std::size_t i = 0; i < m_content.size(); i++) {
+        if (m_content[i] == '\n') {
+            m_lineBegins.push_back(i + 1);
+        }
+    }
+
+    // markdown keeps every character of a line, so its width is the width of the raw line
+    m_widthFrom.resize(m_lineBegins.size() + 1, 0);
+    for (auto i = m_lineBegins.size(); i-- > 0;) {
+        auto view = lineView(i);
+        if (!view.empty() && view.back() == '\r') {
+            view.remove_suffix(1);
+        }
+        m_widthFrom[i] = std::max(m_widthFrom[i + 1], ftxui::string_width(std::string{view}));
+    }
+}
+
+const ftxui::Element &MarkdownDocument::line(std::size_t index) {
+    while (m_lines.size() <= index) {
+        m_lines.push_back(decorateLine(lineView(m_lines.size()), m_parseState, m_theme));
+    }
+    return m_lines[index];
+}
+
+int MarkdownDocument::widthFrom(std::size_t index) const {
+    return m_widthFrom.at(std::min(index, m_lineBegins.size()));
+}
+
+std::string_view MarkdownDocument::lineView(std::size_t index) const {
+    const auto begin = m_lineBegins.at(index);
+    const auto end =
+        index + 1 < m_lineBegins.size() ? m_lineBegins[index + 1] - 1 : m_content.size();
+    return std::string_view{m_content}.substr(begin, end - begin);
+}
+
 } // namespace caps_log::view
@@ -3,7 +3,9 @@
 #include <algorithm>
 #include <array>
 #include <ftxui/dom/elements.hpp>
+#include <string>
 #include <string_view>
+#include <vector>
 
 namespace caps_log::view {
 
@@ -23,6 +25,42 @@ struct MarkdownTheme {
 
 const MarkdownTheme &getDefaultMarkdownTheme();
 
+// state carried from one line to the next while parsing
+struct MarkdownParseState {
+    bool inFence = false;
+    char fenceChar = '`';
+};
+
+/**
+ * Markdown document whose lines are turned into elements the first time they are asked for, so
+ * only the part of a long document that is ever shown is parsed. Lines are parsed in order since
+ * a line can be styled by the ones before it (code fences).
+ */
+class MarkdownDocument {
+  public:
+    MarkdownDocument(std::string content, const MarkdownTheme &theme);
+
+    [[nodiscard]] const std::string &getContent() const { return m_content; }
+    [[nodiscard]] std::size_t lineCount() const { return m_lineBegins.size(); }
+    [[nodiscard]] const ftxui::Element &line(std::size_t index);
+
+    /**
+     * Width in columns of the widest line from `index` to the end, the width the elements of
+     * those lines would require without parsing them.
+     */
+    [[nodiscard]] int widthFrom(std::size_t index) const;
+
+  private:
+    std::string m_content;
+    MarkdownTheme m_theme;
+    std::vector<std::size_t> m_lineBegins;
+    std::vector<int> m_widthFrom;
+    ftxui::Elements m_lines;
+    MarkdownParseState m_parseState;
+
+    [[nodiscard]] std::string_view lineView(std::size_t index) const;
+};
+
 ftxui::Elements markdown(std::string_view documentView,
                          const MarkdownTheme &theme = getDefaultMarkdownTheme());
 
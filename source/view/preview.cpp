@@ -1,12 +1,22 @@
 #include "preview.hpp"
 
 #include "markdown_text.hpp"
+#include "utils/hash.hpp"
 
+#include <algorithm>
 #include <ftxui/component/event.hpp>
 
 namespace caps_log::view {
 using namespace ftxui;
 
+namespace {
+constexpr std::size_t kCachedDocuments = 32;
+// used until the preview is rendered and its height is known
+constexpr int kDefaultVisibleLines = 64;
+// lines rendered past the bottom, so a preview that grew since the last render is still filled
+constexpr int kOverscanLines = 2;
+} // namespace
+
 Decorator decoratorForBorderSytle(BorderStyle style) {
     using namespace ftxui;
     switch (style) {
@@ -34,17 +44,30 @@ Preview::Preview(const PreviewOption &option)
 Element Preview::OnRender() {
     Elements visibleLines;
     visibleLines.push_back(m_title);
-    for (int i = m_topLineIndex; i < m_lines.size(); i++) {
-        if (not Active()) {
-            visibleLines.push_back(m_lines[i] | dim);
-        } else {
-            visibleLines.push_back(m_lines[i]);
+    if (m_document != nullptr) {
+        // the title takes the first row
+        const auto visibleCount = m_box.y_max > m_box.y_min ? m_box.y_max - m_box.y_min
+                                                            : kDefaultVisibleLines;
+        const auto last = std::min(m_document->lineCount(),
+                                   static_cast<std::size_t>(m_topLineIndex + visibleCount +
+                                                            kOverscanLines));
+        for (auto i = static_cast<std::size_t>(m_topLineIndex); i < last; i++) {
+            if (not Active()) {
+                visibleLines.push_back(m_document->line(i) | dim);
+            } else {
+                visibleLines.push_back(m_document->line(i));
+            }
+        }
+        // lines that are not rendered still widen the preview like they would if they were
+        if (last < m_document->lineCount()) {
+            visibleLines.push_back(emptyElement() |
+                                   size(WIDTH, EQUAL, m_document->widthFrom(last)));
         }
     }
 
     // Not using a `window` because of https://github.com/ArthurSonzogni/FTXUI/issues/1016
     // Note: dont use `center` it makes the width not expanded to the full width of the screen
-    auto element = vbox(visibleLines) | m_borderDecorator;
+    auto element = vbox(visibleLines) | reflect(m_box) | m_borderDecorator;
 
     return (Focused() ? element : element | dim);
 }
@@ -57,7 +80,8 @@ bool Preview::OnEvent(Event event) {
     }
 
     if (event == Event::ArrowDown || event == Event::Character('j')) {
-        if (m_topLineIndex + 1 < m_lines.size() - 1) {
+        if (m_document != nullptr &&
+            static_cast<std::size_t>(m_topLineIndex) + 2 < m_document->lineCount()) {
             m_topLineIndex++;
         }
         return true;
@@ -76,7 +100,21 @@ void Preview::resetScroll() { m_topLineIndex = 0; }
 
 void Preview::setContent(const std::string &title, const std::string &str) {
     m_title = text(title) | underlined | center | bold;
-    m_lines = markdown(str, m_markdownTheme);
+
+    const auto contentHash = utils::fnv1a(str);
+    const auto cached = std::ranges::find_if(m_documents, [&](const CachedDocument &entry) {
+        return entry.contentHash == contentHash && entry.document.getContent() == str;
+    });
+    if (cached != m_documents.end()) {
+        m_documents.splice(m_documents.begin(), m_documents, cached);
+    } else {
+        m_documents.push_front(CachedDocument{.contentHash = contentHash,
+                                              .document = MarkdownDocument{str, m_markdownTheme}});
+        if (m_documents.size() > kCachedDocuments) {
+            m_documents.pop_back();
+        }
+    }
+    m_document = &m_documents.front().document;
 }
 
 } // namespace caps_log::view
@@ -2,7 +2,10 @@
 
 #include "markdown_text.hpp"
 
+#include <cstdint>
 #include <ftxui/component/component.hpp>
+#include <ftxui/screen/box.hpp>
+#include <list>
 
 namespace caps_log::view {
 
@@ -15,8 +18,17 @@ class Preview : public ftxui::ComponentBase {
     ftxui::Decorator m_borderDecorator;
     MarkdownTheme m_markdownTheme;
     int m_topLineIndex = 0;
-    ftxui::Elements m_lines;
     ftxui::Element m_title = ftxui::text("log preview");
+    // box of the lines on the last render, used to render only as many lines as fit
+    ftxui::Box m_box;
+
+    struct CachedDocument {
+        std::uint64_t contentHash;
+        MarkdownDocument document;
+    };
+    // most recently shown first, so going back to a day or scratchpad does not parse it again
+    std::list<CachedDocument> m_documents;
+    MarkdownDocument *m_document = nullptr;
 
   public:
     explicit Preview(const PreviewOption &option);
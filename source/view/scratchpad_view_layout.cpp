@@ -42,6 +42,7 @@ ScratchpadViewLayout::ScratchpadViewLayout(InputHandlerBase *inputHandler,
     m_windowedMenu = WindowedMenu::make(WindowedMenuOption{
         .title = "Scratchpads",
         .entries = &m_scratchpadTitles,
+        .entriesVersion = nullptr,
         .onChange =
             [this]() {
                 if (m_windowedMenu->selected() == 0) {
@@ -55,6 +56,7 @@ ScratchpadViewLayout::ScratchpadViewLayout(InputHandlerBase *inputHandler,
         .border = m_config.theme.menuConfig.border,
         .entryDecorator = m_config.theme.menuConfig.entryDecorator,
         .selectedEntryDecorator = m_config.theme.menuConfig.selectedEntryDecorator,
+        .filterable = false,
     });
     m_preview = std::make_shared<Preview>(PreviewOption{
         .border = m_config.theme.previewConfig.border,
@@ -126,7 +128,7 @@ void ScratchpadViewLayout::setScratchpads(const std::vector<ScratchpadData> &scr
     m_scratchpadTitles.push_back("Make new scratchpad");
     m_scratchpadContents.push_back("Create a new scratchpad");
 
-    m_windowedMenu->selected() = 0; // Reset selection to the first item
+    m_windowedMenu->select(0); // Reset selection to the first item
 
     // sort on last modified date
     auto scratchpadsCopy = scratchpadData;
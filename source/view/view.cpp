@@ -4,6 +4,9 @@
 #include "view/scratchpad_view_layout.hpp"
 
 #include <ftxui/component/component.hpp>
+#include <ftxui/component/loop.hpp>
+#include <sstream>
+#include <utility>
 
 namespace caps_log::view {
 using namespace ftxui;
@@ -163,6 +166,15 @@ class PopUpViewLayoutWrapper : public PopUpViewBase, public ComponentBase {
         m_previousScreen = m_currentScreen;
     }
 
+    bool OnEvent(Event event) override {
+        m_view->markFrameStart();
+        if (event == Event::F12) {
+            m_view->m_showLatencyOverlay = not m_view->m_showLatencyOverlay;
+            return true;
+        }
+        return ComponentBase::OnEvent(std::move(event));
+    }
+
   private:
     void prompt(std::string message, PopUpCallback callback) {
         m_message = std::move(message);
@@ -206,6 +218,16 @@ class PopUpViewLayoutWrapper : public PopUpViewBase, public ComponentBase {
     }
 
     Element OnRender() override {
+        // only building the elements, the `frame` time also covers laying them out and drawing them
+        const utils::ScopedLatency latency{m_view->m_latencyStats, "render"};
+        auto screen = renderScreen();
+        if (not m_view->m_showLatencyOverlay) {
+            return screen;
+        }
+        return dbox(screen, vbox(hbox(filler(), renderLatencyOverlay() | clear_under), filler()));
+    }
+
+    Element renderScreen() {
         auto currentView = m_prompt->ChildAt(m_currentScreen)->Render();
         if (m_currentScreen == kIndexAnnualViewLayout ||
             m_currentScreen == kIndexScratchpadViewLayout) {
@@ -214,6 +236,15 @@ class PopUpViewLayoutWrapper : public PopUpViewBase, public ComponentBase {
         auto previousView = m_prompt->ChildAt(m_previousScreen)->Render();
         return dbox(previousView | dim | color(Color::Grey37), currentView | clear_under | center);
     }
+
+    Element renderLatencyOverlay() const {
+        Elements rows;
+        std::istringstream table{m_view->m_latencyStats.format()};
+        for (std::string row; std::getline(table, row);) {
+            rows.push_back(text(row));
+        }
+        return window(text("Latency (F12 to close)"), vbox(std::move(rows)));
+    }
 };
 
 View::View(const ViewConfig &conf, std::chrono::year_month_day today,
@@ -232,13 +263,28 @@ void View::run() {
     // NOLINTNEXTLINE(cppcoreguidelines-avoid-magic-numbers,readability-magic-numbers)
     ftxui::Terminal::SetFallbackSize(ftxui::Dimensions{/*dimx=*/80, /*dimy=*/24});
     m_running = true;
-    m_screen.Loop(m_rootWithPopUpSupport);
+    ftxui::Loop loop{&m_screen, m_rootWithPopUpSupport};
+    while (not loop.HasQuitted()) {
+        // waits for an event or task, handles it and the ones queued behind it and draws a frame
+        loop.RunOnceBlocking();
+        if (const auto start = std::exchange(m_frameStart, std::nullopt)) {
+            m_latencyStats.record("frame", std::chrono::steady_clock::now() - *start);
+        }
+    }
 }
 
 void View::stop() { m_screen.Exit(); }
 
-void View::post(const ftxui::Task &task) {
-    m_screen.Post(task);
+void View::post(std::string_view name, const ftxui::Task &task) {
+    if (const auto *closure = std::get_if<Closure>(&task)) {
+        m_screen.Post([this, name, closure = *closure]() {
+            markFrameStart();
+            const utils::ScopedLatency latency{m_latencyStats, name};
+            closure();
+        });
+    } else {
+        m_screen.Post(task);
+    }
     m_screen.PostEvent(Event::Custom);
 }
 
@@ -247,9 +293,27 @@ bool View::handleInputEvent(const UIEvent &event) {
         return false;
     }
     if (std::holds_alternative<UiStarted>(event)) {
-        m_screen.Post([this]() { m_inputHandler->handleInputEvent(UIEvent{UiStarted{}}); });
+        m_screen.Post([this, event]() {
+            markFrameStart();
+            const utils::ScopedLatency latency{m_latencyStats, uiEventName(event)};
+            m_inputHandler->handleInputEvent(event);
+        });
+        return true;
+    }
+    // the loop runs posted tasks after the input queued before them and before drawing, so
+    // holding an arrow key only loads the preview of the day the calendar ends up on
+    if (std::holds_alternative<FocusedDateChange>(event) && m_running) {
+        if (not std::exchange(m_focusChangePosted, true)) {
+            m_screen.Post([this, event]() {
+                markFrameStart();
+                m_focusChangePosted = false;
+                const utils::ScopedLatency latency{m_latencyStats, uiEventName(event)};
+                m_inputHandler->handleInputEvent(event);
+            });
+        }
         return true;
     }
+    const utils::ScopedLatency latency{m_latencyStats, uiEventName(event)};
     return m_inputHandler->handleInputEvent(event);
 }
 
@@ -275,6 +339,12 @@ void View::switchLayout() { m_rootWithPopUpSupport->switchLayout(); }
 
 bool View::onEvent(ftxui::Event event) { return m_rootWithPopUpSupport->OnEvent(std::move(event)); }
 
+void View::markFrameStart() {
+    if (not m_frameStart) {
+        m_frameStart = std::chrono::steady_clock::now();
+    }
+}
+
 std::string View::render() const {
     const auto dimensitons = m_terminalSizeProvider();
     ftxui::Screen screen{dimensitons.dimx, dimensitons.dimy};
@@ -1,10 +1,15 @@
 
 #pragma once
 
+#include "utils/latency_stats.hpp"
 #include "view/annual_view_layout.hpp"
 #include "view/scratchpad_view_layout.hpp"
 #include "view/view_base.hpp"
 
+#include <chrono>
+#include <optional>
+#include <string_view>
+
 namespace caps_log::view {
 
 struct ViewConfig {
@@ -21,6 +26,13 @@ class View : public ViewBase, public InputHandlerBase {
     InputHandlerBase *m_inputHandler = nullptr;
     std::function<ftxui::Dimensions()> m_terminalSizeProvider;
     bool m_running = false;
+    // a focused date change was posted and not handled yet, later ones are reported with it
+    bool m_focusChangePosted = false;
+    // time spent handling events, posted tasks and drawing the frames, shown with F12
+    utils::LatencyStats m_latencyStats;
+    bool m_showLatencyOverlay = false;
+    // when the loop woke up to handle the first event or task of the frame being drawn
+    std::optional<std::chrono::steady_clock::time_point> m_frameStart;
 
   public:
     View(const ViewConfig &conf, std::chrono::year_month_day today,
@@ -34,7 +46,7 @@ class View : public ViewBase, public InputHandlerBase {
     void run() override;
     void stop() override;
 
-    void post(const ftxui::Task &task) override;
+    void post(std::string_view name, const ftxui::Task &task) override;
 
     void withRestoredIO(std::function<void()> func) override;
     void setInputHandler(InputHandlerBase *handler) override;
@@ -48,10 +60,15 @@ class View : public ViewBase, public InputHandlerBase {
 
     void switchLayout() override;
 
+    [[nodiscard]] const utils::LatencyStats &getLatencyStats() const { return m_latencyStats; }
+
     // testing tools
     bool onEvent(ftxui::Event event);
 
     [[nodiscard]] std::string render() const;
+
+  private:
+    void markFrameStart();
 };
 
 } // namespace caps_log::view
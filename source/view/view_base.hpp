@@ -5,6 +5,7 @@
 #include "view/scratchpad_view_layout_base.hpp"
 #include <ftxui/component/component_base.hpp>
 #include <ftxui/component/task.hpp>
+#include <string_view>
 
 namespace caps_log::view {
 
@@ -69,7 +70,11 @@ class ViewBase {
     virtual void run() = 0;
     virtual void stop() = 0;
 
-    virtual void post(const ftxui::Task &task) = 0;
+    /**
+     * Runs the task on the UI thread. A closure's run time is recorded in the latency stats under
+     * `name`, which has to outlive the view, e.g. a string literal.
+     */
+    virtual void post(std::string_view name, const ftxui::Task &task) = 0;
 
     virtual void withRestoredIO(std::function<void()> func) = 0;
     virtual void setInputHandler(InputHandlerBase *handler) = 0;
@@ -0,0 +1,266 @@
+#include "windowed_menu.hpp"
+
+#include <algorithm>
+#include <fmt/format.h>
+#include <utility>
+
+namespace caps_log::view {
+
+namespace {
+// matches beyond these are only counted, they can be reached by typing more of the filter
+constexpr std::size_t kMaxVisibleMatches = 100;
+// used until the menu is rendered and the height of its window is known
+constexpr int kDefaultVisibleRows = 20;
+// rows rendered past both ends of the window, so a window that grew since the last render is
+// still filled
+constexpr int kOverscanRows = 4;
+} // namespace
+
+using namespace ftxui;
+
+WindowedMenu::WindowedMenu(const WindowedMenuOption &option)
+    : m_title{option.title}, m_entries{option.entries}, m_entriesVersion{option.entriesVersion},
+      m_onChange{option.onChange},
+      m_border{option.border}, m_entryDecorator{option.entryDecorator},
+      m_selectedEntryDecorator{option.selectedEntryDecorator}, m_filterable{option.filterable} {}
+
+void WindowedMenu::select(int index) {
+    rebuildFilterIfEntriesChanged();
+    m_selected = index;
+    if (m_filter) {
+        const auto visible = std::ranges::find(m_visible, static_cast<std::size_t>(index));
+        if (visible != m_visible.end()) {
+            m_selectedRow = static_cast<int>(std::distance(m_visible.begin(), visible));
+            return;
+        }
+        // the selection would be hidden by the filter
+        closeFilter();
+    }
+    m_selectedRow = index;
+}
+
+bool WindowedMenu::clearFilter() {
+    if (not m_filter) {
+        return false;
+    }
+    closeFilter();
+    return true;
+}
+
+Element WindowedMenu::OnRender() {
+    rebuildFilterIfEntriesChanged();
+
+    auto title = m_title;
+    if (m_filter) {
+        title += fmt::format(" f:{}{} ({})", m_filterText, m_isTypingFilter ? "_" : "",
+                             m_filter->matchCount());
+    }
+    auto windowElement =
+        window(text(title), renderRows() | vscroll_indicator | frame | reflect(m_box), m_border);
+
+    if (not Focused()) {
+        windowElement |= dim;
+    }
+    return windowElement;
+}
+
+Element WindowedMenu::renderRows() {
+    const auto rows = rowCount();
+    m_selectedRow = std::clamp(m_selectedRow, 0, std::max(0, rows - 1));
+
+    // the frame keeps the selected row in the middle of the window where it can
+    const auto visibleRows =
+        m_box.y_max > m_box.y_min ? m_box.y_max - m_box.y_min + 1 : kDefaultVisibleRows;
+    const auto windowTop = std::clamp(m_selectedRow - (visibleRows / 2), 0,
+                                      std::max(0, rows - visibleRows));
+    const auto first = std::max(0, windowTop - kOverscanRows);
+    const auto last = std::min(rows, windowTop + visibleRows + kOverscanRows);
+
+    Elements elements;
+    elements.reserve(static_cast<std::size_t>(last - first) + 2);
+    if (first > 0) {
+        elements.push_back(emptyElement() | size(HEIGHT, EQUAL, first));
+    }
+    m_firstRenderedRow = first;
+    m_renderedRowBoxes.resize(static_cast<std::size_t>(last - first));
+    for (int row = first; row < last; row++) {
+        const auto isSelected = row == m_selectedRow;
+        auto element = text((isSelected ? "> " : "  ") + rowLabel(row));
+        if (isSelected) {
+            element = m_selectedEntryDecorator ? element | m_selectedEntryDecorator
+                                               : element | bold | inverted;
+            element |= focus;
+        } else {
+            element = m_entryDecorator ? element | m_entryDecorator : element | bold;
+        }
+        elements.push_back(element |
+                           reflect(m_renderedRowBoxes[static_cast<std::size_t>(row - first)]));
+    }
+    if (last < rows) {
+        elements.push_back(emptyElement() | size(HEIGHT, EQUAL, rows - last));
+    }
+    return vbox(std::move(elements));
+}
+
+bool WindowedMenu::OnEvent(Event event) {
+    rebuildFilterIfEntriesChanged();
+    if (m_isTypingFilter) {
+        return handleFilterEvent(event);
+    }
+    if (m_filterable && event == Event::Character('f') && Focused()) {
+        openFilter();
+        return true;
+    }
+    return handleNavigationEvent(std::move(event));
+}
+
+bool WindowedMenu::handleNavigationEvent(Event event) {
+    if (event.is_mouse()) {
+        return handleMouseEvent(std::move(event));
+    }
+    if (not Focused()) {
+        return false;
+    }
+
+    const auto page = std::max(1, m_box.y_max - m_box.y_min);
+    if (event == Event::ArrowUp || event == Event::Character('k')) {
+        moveSelectedRow(m_selectedRow - 1);
+    } else if (event == Event::ArrowDown || event == Event::Character('j')) {
+        moveSelectedRow(m_selectedRow + 1);
+    } else if (event == Event::PageUp) {
+        moveSelectedRow(m_selectedRow - page);
+    } else if (event == Event::PageDown) {
+        moveSelectedRow(m_selectedRow + page);
+    } else if (event == Event::Home) {
+        moveSelectedRow(0);
+    } else if (event == Event::End) {
+        moveSelectedRow(rowCount() - 1);
+    } else {
+        return false;
+    }
+    return true;
+}
+
+bool WindowedMenu::handleMouseEvent(Event event) {
+    const auto &mouse = event.mouse();
+    if (not m_box.Contain(mouse.x, mouse.y) || not CaptureMouse(event)) {
+        return false;
+    }
+    if (mouse.button == Mouse::WheelUp || mouse.button == Mouse::WheelDown) {
+        TakeFocus();
+        moveSelectedRow(m_selectedRow + (mouse.button == Mouse::WheelUp ? -1 : 1));
+        return true;
+    }
+    if (mouse.button != Mouse::Left || mouse.motion != Mouse::Pressed) {
+        return false;
+    }
+    for (std::size_t i = 0; i < m_renderedRowBoxes.size(); i++) {
+        if (m_renderedRowBoxes[i].Contain(mouse.x, mouse.y)) {
+            TakeFocus();
+            moveSelectedRow(m_firstRenderedRow + static_cast<int>(i));
+            return true;
+        }
+    }
+    return false;
+}
+
+void WindowedMenu::moveSelectedRow(int row) {
+    const auto newRow = std::clamp(row, 0, std::max(0, rowCount() - 1));
+    if (newRow != m_selectedRow) {
+        m_selectedRow = newRow;
+        onSelectedRowChange();
+    }
+}
+
+int WindowedMenu::rowCount() const {
+    return static_cast<int>(m_filter ? m_visible.size() : m_entries->size());
+}
+
+const std::string &WindowedMenu::rowLabel(int row) const {
+    const auto index = static_cast<std::size_t>(row);
+    return m_entries->at(m_filter ? m_visible.at(index) : index);
+}
+
+bool WindowedMenu::handleFilterEvent(const Event &event) {
+    if (event == Event::Return) {
+        m_isTypingFilter = false;
+    } else if (event == Event::Escape) {
+        closeFilter();
+    } else if (event == Event::ArrowUp || event == Event::ArrowDown || event == Event::PageUp ||
+               event == Event::PageDown || event.is_mouse()) {
+        return handleNavigationEvent(event);
+    } else if (event == Event::Backspace) {
+        if (not m_filterText.empty()) {
+            m_filterText.pop_back();
+            refilter();
+        }
+    } else if (event.is_character()) {
+        m_filterText += event.character();
+        refilter();
+    }
+    // every other key is swallowed so it does not trigger any shortcut while typing
+    return true;
+}
+
+void WindowedMenu::openFilter() {
+    if (not m_filter) {
+        m_filteredVersion = m_entriesVersion ? *m_entriesVersion : 0;
+        m_filter.emplace(*m_entries);
+        m_filterText.clear();
+        refilter();
+    }
+    m_isTypingFilter = true;
+}
+
+void WindowedMenu::closeFilter() {
+    m_isTypingFilter = false;
+    m_filter.reset();
+    m_filterText.clear();
+    m_visible.clear();
+    m_selectedRow = m_selected;
+}
+
+void WindowedMenu::refilter() {
+    m_filter->setPattern(m_filterText);
+    m_visible = m_filter->top(kMaxVisibleMatches);
+    if (m_visible.empty()) {
+        m_selectedRow = 0;
+        return;
+    }
+
+    // keep the selection if it still matches, otherwise move it to the best match
+    const auto visible = std::ranges::find(m_visible, static_cast<std::size_t>(m_selected));
+    m_selectedRow = visible != m_visible.end()
+                        ? static_cast<int>(std::distance(m_visible.begin(), visible))
+                        : 0;
+    if (std::cmp_not_equal(m_visible[static_cast<std::size_t>(m_selectedRow)], m_selected)) {
+        onSelectedRowChange();
+    }
+}
+
+void WindowedMenu::rebuildFilterIfEntriesChanged() {
+    if (not m_filter || m_entriesVersion == nullptr || *m_entriesVersion == m_filteredVersion) {
+        return;
+    }
+    m_filteredVersion = *m_entriesVersion;
+    m_filter.emplace(*m_entries);
+    m_filter->setPattern(m_filterText);
+    m_visible = m_filter->top(kMaxVisibleMatches);
+    m_selectedRow = std::min(m_selectedRow, std::max(0, static_cast<int>(m_visible.size()) - 1));
+}
+
+void WindowedMenu::onSelectedRowChange() {
+    if (m_filter) {
+        if (m_visible.empty()) {
+            return;
+        }
+        m_selected = static_cast<int>(m_visible.at(static_cast<std::size_t>(m_selectedRow)));
+    } else {
+        m_selected = m_selectedRow;
+    }
+    if (m_onChange) {
+        m_onChange();
+    }
+}
+
+} // namespace caps_log::view
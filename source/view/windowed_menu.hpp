@@ -1,77 +1,102 @@
 #pragma once
 
+#include "utils/fuzzy_filter.hpp"
+
 #include <ftxui/component/captured_mouse.hpp>
 #include <ftxui/component/component.hpp>
 #include <ftxui/component/screen_interactive.hpp>
-#include <ftxui/util/ref.hpp>
+#include <cstdint>
+#include <ftxui/screen/box.hpp>
 #include <memory>
+#include <optional>
 #include <string>
+#include <vector>
 
 namespace caps_log::view {
 
 struct WindowedMenuOption {
     std::string title;
-    ftxui::ConstStringListRef entries;
+    const std::vector<std::string> *entries;
+    // changes whenever the entries are replaced, required for filterable menus so an applied
+    // filter is rebuilt from the new entries
+    const std::uint64_t *entriesVersion = nullptr;
     std::function<void()> onChange;
     ftxui::BorderStyle border;
     ftxui::Decorator entryDecorator = nullptr;
     ftxui::Decorator selectedEntryDecorator = nullptr;
+    // pressing 'f' while the menu is focused narrows the entries to the ones matching typed text
+    bool filterable = false;
 };
 
+/**
+ * A vertical menu in a window. Only the entries around the ones that fit the window are turned
+ * into elements on each render, the rest are represented by empty space of the same height so
+ * the menu scrolls like it would if all of them were rendered.
+ */
 class WindowedMenu : public ftxui::ComponentBase {
-    int m_selected = 0;
-
   public:
-    explicit WindowedMenu(const WindowedMenuOption &option) {
-        using namespace ftxui;
+    explicit WindowedMenu(const WindowedMenuOption &option);
 
-        MenuOption menuOption;
-        menuOption.entries = option.entries;
-        menuOption.on_change = option.onChange;
-        menuOption.selected = &m_selected;
-        menuOption.entries_option.transform =
-            [this, entryDecorator = option.entryDecorator,
-             selectedEntryDecorator = option.selectedEntryDecorator](const EntryState &state) {
-                std::string label = (state.active ? "> " : "  ") + state.label; // NOLINT
-                auto element = text(label);
-                if (state.focused || state.active) {
-                    if (selectedEntryDecorator) {
-                        element = element | selectedEntryDecorator;
-                    } else {
-                        element = element | bold | inverted;
-                    }
-                } else {
-                    if (entryDecorator) {
-                        element = element | entryDecorator;
-                    } else {
-                        element = element | bold;
-                    }
-                }
-                return element;
-            };
+    /**
+     * Index of the selected entry in the `entries` vector, regardless of any applied filter.
+     */
+    [[nodiscard]] int selected() const { return m_selected; }
+    void select(int index);
 
-        auto menuComponent = Menu(std::move(menuOption));
-        auto menuRenderer = Renderer(
-            menuComponent, [title = option.title, menu = menuComponent, border = option.border]() {
-                auto windowElement =
-                    window(text(title), menu->Render() | vscroll_indicator | frame, border);
-
-                if (not menu->Focused() || not menu->Active()) {
-                    windowElement |= dim;
-                }
-                return windowElement;
-            });
-        Add(menuRenderer);
-        menuComponent->SetActiveChild(0);
-    }
+    /**
+     * True while the filter text is being typed, all key events are consumed by the menu then.
+     */
+    [[nodiscard]] bool isFiltering() const { return m_isTypingFilter; }
+    /**
+     * Shows all entries again, returns false if no filter was applied.
+     */
+    bool clearFilter();
 
-    auto &selected() { return m_selected; }
+    ftxui::Element OnRender() override;
+    bool OnEvent(ftxui::Event event) override;
+    [[nodiscard]] bool Focusable() const override { return rowCount() > 0; }
 
     static auto make(const WindowedMenuOption &option) {
         return std::make_shared<WindowedMenu>(option);
     }
 
   private:
+    std::string m_title;
+    const std::vector<std::string> *m_entries;
+    const std::uint64_t *m_entriesVersion;
+    std::function<void()> m_onChange;
+    ftxui::BorderStyle m_border;
+    ftxui::Decorator m_entryDecorator;
+    ftxui::Decorator m_selectedEntryDecorator;
+    bool m_filterable;
+
+    int m_selected = 0;
+    int m_selectedRow = 0;
+    bool m_isTypingFilter = false;
+    std::optional<utils::FuzzyFilter> m_filter;
+    std::string m_filterText;
+    std::vector<std::size_t> m_visible;
+    // version of the entries the filter was built from, to notice when they are replaced
+    std::uint64_t m_filteredVersion = 0;
+
+    // the area the rows are shown in and the rows that were rendered into it on the last render
+    ftxui::Box m_box;
+    int m_firstRenderedRow = 0;
+    std::vector<ftxui::Box> m_renderedRowBoxes;
+
+    [[nodiscard]] int rowCount() const;
+    [[nodiscard]] const std::string &rowLabel(int row) const;
+    [[nodiscard]] ftxui::Element renderRows();
+    bool handleNavigationEvent(ftxui::Event event);
+    bool handleMouseEvent(ftxui::Event event);
+    void moveSelectedRow(int row);
+
+    bool handleFilterEvent(const ftxui::Event &event);
+    void openFilter();
+    void closeFilter();
+    void refilter();
+    void rebuildFilterIfEntriesChanged();
+    void onSelectedRowChange();
 };
 
 } // namespace caps_log::view
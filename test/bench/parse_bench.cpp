@@ -0,0 +1,95 @@
+#include "log/log_file.hpp"
+#include "log_parse_reference.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <fmt/format.h>
+#include <random>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/**
+ * Times the regex based reference parser against `LogFile::parse` on generated logs and prints the
+ * lines per second of both. Not part of the tests, build with -DCAPS_LOG_BUILD_BENCHMARKS=ON.
+ */
+
+namespace {
+using namespace caps_log::log;
+
+const std::chrono::year_month_day kDate{std::chrono::year{2021}, std::chrono::month{1},
+                                        std::chrono::day{1}};
+
+// a log the way they are usually written, the random ones sit on the edges of the grammar
+const auto kTypicalLog = R"(# 1. 1. 21.
+Some introductory text that is neither a section nor a tag.
+
+# Work
+* meeting (standup): talked about the release
+* code review
+Regular text line with some words in it and a bit of *emphasis*.
+- [ ] a task (that looks like a tag)
+
+# Health
+* run: 5km
+* weight (72.4)
+```sh
+# not a section
+* not a tag
+```
+
+# Notes
+Another regular text line, slightly longer than the others to make it realistic.
+)";
+
+std::vector<std::string> makeCorpus() {
+    constexpr auto kRandomLogCount = 2000;
+    constexpr auto kLinesPerRandomLog = 32;
+    constexpr auto kTypicalLogCount = 2000;
+
+    std::vector<std::string> corpus;
+    std::mt19937 rng{1}; // NOLINT(cert-msc32-c,cert-msc51-cpp): reproducible on purpose
+    for (auto i = 0; i < kRandomLogCount; i++) {
+        corpus.push_back(test::makeRandomLog(rng, kLinesPerRandomLog));
+    }
+    corpus.insert(corpus.end(), kTypicalLogCount, kTypicalLog);
+    return corpus;
+}
+
+template <typename Parse>
+double linesPerSecond(const std::vector<std::string> &corpus, std::size_t lines,
+                      const Parse &parse) {
+    constexpr auto kRepetitions = 5;
+    // the best of the repetitions, the others were slowed down by something else
+    auto best = std::chrono::steady_clock::duration::max();
+    for (auto i = 0; i < kRepetitions; i++) {
+        const auto start = std::chrono::steady_clock::now();
+        for (const auto &content : corpus) {
+            parse(content);
+        }
+        best = std::min(best, std::chrono::steady_clock::now() - start);
+    }
+    return static_cast<double>(lines) / std::chrono::duration<double>(best).count();
+}
+} // namespace
+
+int main() {
+    const auto corpus = makeCorpus();
+    std::size_t lines = 0;
+    for (const auto &content : corpus) {
+        lines += std::ranges::count(content, '\n');
+    }
+
+    std::size_t sink = 0;
+    const auto regex = linesPerSecond(corpus, lines, [&sink](const std::string &content) {
+        sink += test::regexParse(content).size();
+    });
+    const auto scanner = linesPerSecond(corpus, lines, [&sink](const std::string &content) {
+        sink += LogFile{kDate, content}.parse().getSections().size();
+    });
+
+    fmt::print("{} logs, {} lines ({} sections seen)\n", corpus.size(), lines, sink);
+    fmt::print("regex:   {:>12.0f} lines/s\n", regex);
+    fmt::print("scanner: {:>12.0f} lines/s ({:.1f}x)\n", scanner, scanner / regex);
+    return 0;
+}
@@ -226,6 +226,8 @@ class CapsLogE2ETest : public testing::Test {
     [[nodiscard]] CapsLog::Context createTestContext(std::vector<std::string> cliArgs) const {
         CapsLog::Context context;
         context.today = kToday;
+        // the ui loop is not run, so the logs have to be collected before the first render
+        context.progressiveCollect = false;
         // append "--log-dir-path" and the test log directory to the CLI args
         std::vector<std::string> args(cliArgs.begin(), cliArgs.end());
         args.push_back("--log-dir-path");
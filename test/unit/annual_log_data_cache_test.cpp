@@ -0,0 +1,100 @@
+#include <gtest/gtest.h>
+
+#include "log/annual_log_data_cache.hpp"
+#include "mocks.hpp"
+
+namespace caps_log::log::test {
+
+using ::testing::_;
+using ::testing::NiceMock;
+
+namespace {
+constexpr std::size_t kUnlimited = SIZE_MAX;
+
+std::shared_ptr<NiceMock<DMockRepo>> makeRepoWithLogsIn(int firstYear, int lastYear) {
+    auto repo = std::make_shared<NiceMock<DMockRepo>>();
+    for (int year = firstYear; year <= lastYear; year++) {
+        repo->write({std::chrono::year{year} / std::chrono::May / 1, "\n# section\n* tag"});
+    }
+    return repo;
+}
+} // namespace
+
+TEST(AnnualLogDataCacheTest, ResidentYearsAreNotCollectedAgain) {
+    auto repo = makeRepoWithLogsIn(2020, 2021);
+    AnnualLogDataCache cache{repo, nullptr, {.capacityBytes = kUnlimited}};
+
+    EXPECT_CALL(*repo, listLogDates(std::chrono::year{2020})).Times(1);
+    EXPECT_CALL(*repo, listLogDates(std::chrono::year{2021})).Times(1);
+    const auto data2020 = cache.get(std::chrono::year{2020});
+    const auto data2021 = cache.get(std::chrono::year{2021});
+    EXPECT_EQ(cache.get(std::chrono::year{2020}), data2020);
+    EXPECT_EQ(cache.get(std::chrono::year{2021}), data2021);
+    EXPECT_TRUE(data2020->datesWithLogs.contains(std::chrono::May / 1));
+}
+
+TEST(AnnualLogDataCacheTest, PutYearsAreNotCollected) {
+    auto repo = makeRepoWithLogsIn(2020, 2020);
+    AnnualLogDataCache cache{repo, nullptr, {.capacityBytes = kUnlimited}};
+
+    EXPECT_CALL(*repo, listLogDates(_)).Times(0);
+    const auto data = std::make_shared<AnnualLogData>();
+    cache.put(std::chrono::year{2020}, data);
+    EXPECT_TRUE(cache.contains(std::chrono::year{2020}));
+    EXPECT_EQ(cache.get(std::chrono::year{2020}), data);
+}
+
+TEST(AnnualLogDataCacheTest, PreloadCollectsNeighbouringYears) {
+    auto repo = makeRepoWithLogsIn(2018, 2022);
+    AnnualLogDataCache cache{repo, nullptr, {.capacityBytes = kUnlimited}};
+    (void)cache.get(std::chrono::year{2020});
+
+    cache.preload(std::chrono::year{2020}, 1);
+    cache.waitForPreload();
+    EXPECT_TRUE(cache.contains(std::chrono::year{2019}));
+    EXPECT_TRUE(cache.contains(std::chrono::year{2021}));
+    EXPECT_FALSE(cache.contains(std::chrono::year{2022}));
+
+    EXPECT_CALL(*repo, listLogDates(_)).Times(0);
+    const auto data = cache.get(std::chrono::year{2021});
+    EXPECT_EQ(data->findDates("section", "tag")->size(), 1);
+}
+
+TEST(AnnualLogDataCacheTest, YearsFarthestFromTheDisplayedOneAreEvictedFirst) {
+    auto repo = makeRepoWithLogsIn(2016, 2024);
+    const auto yearSize =
+        AnnualLogData::collect(repo, std::chrono::year{2020}).estimateMemoryUsage();
+    AnnualLogDataCache cache{repo, nullptr, {.capacityBytes = 3 * yearSize}};
+
+    (void)cache.get(std::chrono::year{2020});
+    cache.preload(std::chrono::year{2020}, 4);
+    cache.waitForPreload();
+    EXPECT_TRUE(cache.contains(std::chrono::year{2019}));
+    EXPECT_TRUE(cache.contains(std::chrono::year{2020}));
+    EXPECT_TRUE(cache.contains(std::chrono::year{2021}));
+    EXPECT_FALSE(cache.contains(std::chrono::year{2018}));
+    EXPECT_FALSE(cache.contains(std::chrono::year{2022}));
+    EXPECT_LE(cache.getMemoryUsage(), 3 * yearSize);
+
+    // moving on keeps the new neighbours
+    (void)cache.get(std::chrono::year{2022});
+    EXPECT_TRUE(cache.contains(std::chrono::year{2022}));
+    EXPECT_TRUE(cache.contains(std::chrono::year{2021}));
+    EXPECT_TRUE(cache.contains(std::chrono::year{2020}));
+    EXPECT_FALSE(cache.contains(std::chrono::year{2019}));
+}
+
+TEST(AnnualLogDataCacheTest, ClearDropsAllYears) {
+    auto repo = makeRepoWithLogsIn(2020, 2020);
+    AnnualLogDataCache cache{repo, nullptr, {.capacityBytes = kUnlimited}};
+    const auto before = cache.get(std::chrono::year{2020});
+
+    repo->write({std::chrono::year{2020} / std::chrono::May / 2, "\n* other tag"});
+    cache.clear();
+    EXPECT_FALSE(cache.contains(std::chrono::year{2020}));
+    const auto after = cache.get(std::chrono::year{2020});
+    EXPECT_NE(before, after);
+    EXPECT_TRUE(after->datesWithLogs.contains(std::chrono::May / 2));
+}
+
+} // namespace caps_log::log::test
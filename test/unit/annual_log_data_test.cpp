@@ -5,6 +5,7 @@
 
 #include "mocks.hpp"
 #include "utils/date.hpp"
+#include "utils/symbol_table.hpp"
 
 namespace caps_log::log::test {
 
@@ -69,7 +70,7 @@ TEST(YearOverviewDataTest, Collect) {
     auto data = AnnualLogData::collect(dummyRepo, dummyDate1.year());
 
     // initial collection
-    const std::set<std::chrono::month_day> allLogs{md1, md2, md3};
+    const utils::date::Dates allLogs{md1, md2, md3};
     EXPECT_EQ(data.datesWithLogs, allLogs);
 
     {
@@ -122,9 +123,10 @@ TEST(YearOverviewDataTest, Collect) {
         };
         // clang-format on
 
-        EXPECT_EQ(data.tagsPerSection.size(), expectedTagsPerSection.size());
+        auto tagsPerSection = data.getTagsPerSection();
+        EXPECT_EQ(tagsPerSection.size(), expectedTagsPerSection.size());
         for (const auto &[section, tags] : expectedTagsPerSection) {
-            EXPECT_EQ(data.tagsPerSection[section], tags) << "Failed at: " << section;
+            EXPECT_EQ(tagsPerSection[section], tags) << "Failed at: " << section;
         }
     }
 
@@ -132,7 +134,7 @@ TEST(YearOverviewDataTest, Collect) {
         SCOPED_TRACE("Collection after removal of a log entry");
         dummyRepo->remove(dummyDate1);
         data.collect(dummyRepo, dummyDate1);
-        const std::set<std::chrono::month_day> allLogs{md2, md3};
+        const utils::date::Dates allLogs{md2, md3};
         EXPECT_EQ(data.datesWithLogs, allLogs);
 
         // clang-format off
@@ -168,9 +170,10 @@ TEST(YearOverviewDataTest, Collect) {
         };
         //clang-format on
 
-        EXPECT_EQ(data.tagsPerSection.size(), postRemovalTagsPerSection.size());
+        const auto tagsPerSection = data.getTagsPerSection();
+        EXPECT_EQ(tagsPerSection.size(), postRemovalTagsPerSection.size());
         for (const auto &[section, tags] : postRemovalTagsPerSection) {
-            EXPECT_EQ(data.tagsPerSection.at(section), tags) << "Failed at: " << section;
+            EXPECT_EQ(tagsPerSection.at(section), tags) << "Failed at: " << section;
         }
     }
 }
@@ -199,8 +202,103 @@ TEST(YearOverviewDataTest, SectionWithNoTagPresent) {
     };
 
     // clang-format on
+    auto tagsPerSection = data.getTagsPerSection();
     for (const auto &[section, tags] : expectedTagsPerSection) {
-        EXPECT_EQ(data.tagsPerSection[section], tags) << "Failed at: " << section;
+        EXPECT_EQ(tagsPerSection[section], tags) << "Failed at: " << section;
+    }
+}
+
+TEST(YearOverviewDataTest, QueryingUnknownNamesDoesNotInternThem) {
+    auto dummyRepo = std::make_shared<DummyRepository>();
+    dummyRepo->write(LogFile{dummyDate1, "# DummyContent \n# section 1 \n* tag"});
+    auto data = AnnualLogData::collect(dummyRepo, dummyDate1.year());
+    const auto &symbols = utils::SymbolTable::global();
+    const auto symbolCount = symbols.size();
+
+    ASSERT_NE(data.findDates("section 1", "tag"), nullptr);
+    EXPECT_EQ(data.findDates("unknown section", "tag"), nullptr);
+    EXPECT_EQ(data.findDates("section 1", "unknown tag"), nullptr);
+    EXPECT_THROW((void)data.getAllTagsForSection("unknown section"), std::out_of_range);
+    EXPECT_EQ(symbols.size(), symbolCount);
+}
+
+TEST(YearOverviewDataTest, ParallelCollectMatchesSequentialCollect) {
+    auto dummyRepo = std::make_shared<DummyRepository>();
+    const std::array contents{kTestContent1, kTestContent2, kTestContent3};
+    const auto year = std::chrono::year{2020};
+    auto day = std::chrono::sys_days{year / std::chrono::January / 1};
+    for (std::size_t i = 0; day < std::chrono::sys_days{(year + std::chrono::years{1}) /
+                                                        std::chrono::January / 1};
+         day += std::chrono::days{1}, i++) {
+        // leave some days without a log
+        if (i % 4 != 3) {
+            dummyRepo->write(LogFile{std::chrono::year_month_day{day}, contents.at(i % 4)});
+        }
+    }
+
+    const auto sequential = AnnualLogData::collect(dummyRepo, year, true, 1);
+    for (const auto workers : {0U, 2U, 3U, 8U, 1000U}) {
+        const auto parallel = AnnualLogData::collect(dummyRepo, year, true, workers);
+        EXPECT_EQ(parallel.datesWithLogs, sequential.datesWithLogs) << "Workers: " << workers;
+        EXPECT_EQ(parallel.getTagsPerSection(), sequential.getTagsPerSection())
+            << "Workers: " << workers;
+    }
+    EXPECT_EQ(sequential.datesWithLogs.size(), 275);
+}
+
+TEST(YearOverviewDataTest, CollectByMonthStartsNearTheFirstMonthAndMatchesCollect) {
+    using namespace std::chrono;
+    auto dummyRepo = std::make_shared<DummyRepository>();
+    const auto year = std::chrono::year{2020};
+    for (const auto month : {January, March, April, June, December}) {
+        dummyRepo->write(LogFile{year / month / 3, kTestContent1});
+        dummyRepo->write(LogFile{year / month / 20, kTestContent2});
+    }
+
+    std::vector<std::chrono::month> months;
+    AnnualLogData merged;
+    AnnualLogData::collectByMonth(dummyRepo, year, April, true, 2, nullptr,
+                                  [&](std::chrono::month month, const AnnualLogData &data) {
+                                      months.push_back(month);
+                                      EXPECT_EQ(data.datesWithLogs.size(), 2);
+                                      merged.merge(data);
+                                      return true;
+                                  });
+    // months without logs are skipped
+    EXPECT_EQ(months, (std::vector{April, March, June, January, December}));
+    const auto collected = AnnualLogData::collect(dummyRepo, year);
+    EXPECT_EQ(merged.datesWithLogs, collected.datesWithLogs);
+    EXPECT_EQ(merged.getTagsPerSection(), collected.getTagsPerSection());
+
+    months.clear();
+    AnnualLogData::collectByMonth(dummyRepo, year, April, true, 1, nullptr,
+                                  [&](std::chrono::month month, const AnnualLogData &) {
+                                      months.push_back(month);
+                                      return months.size() < 2;
+                                  });
+    EXPECT_EQ(months, (std::vector{April, March}));
+}
+
+TEST(YearOverviewDataTest, RewritingLogsMatchesCollectingTheYearAgain) {
+    auto dummyRepo = std::make_shared<DummyRepository>();
+    dummyRepo->write(LogFile{dummyDate1, kTestContent1});
+    dummyRepo->write(LogFile{dummyDate2, kTestContent2});
+    auto data = AnnualLogData::collect(dummyRepo, dummyDate1.year());
+
+    const std::array edits{
+        LogFile{dummyDate1, kTestContent2},
+        LogFile{dummyDate2, kTestContent3},
+        LogFile{dummyDate3, kTestContent1},
+        LogFile{dummyDate1, "\n# section 1\n* tag 1 1"},
+    };
+    for (const auto &edit : edits) {
+        dummyRepo->write(edit);
+        data.collect(dummyRepo, edit.getDate());
+        const auto fresh = AnnualLogData::collect(dummyRepo, dummyDate1.year());
+        EXPECT_EQ(data.datesWithLogs, fresh.datesWithLogs);
+        EXPECT_EQ(data.getTagsPerSection(), fresh.getTagsPerSection());
+        EXPECT_EQ(data.getAllSections(), fresh.getAllSections());
+        EXPECT_EQ(data.getAllTags(), fresh.getAllTags());
     }
 }
 
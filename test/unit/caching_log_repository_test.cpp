@@ -0,0 +1,153 @@
+#include <gtest/gtest.h>
+
+#include "log/caching_log_repository.hpp"
+#include "mocks.hpp"
+
+#include <map>
+#include <string>
+#include <vector>
+
+namespace caps_log::log::test {
+
+using ::testing::_;
+using ::testing::NiceMock;
+
+namespace {
+const auto kDate = std::chrono::year{2024} / std::chrono::March / 10;
+const auto kOtherDate = std::chrono::year{2024} / std::chrono::March / 11;
+constexpr std::size_t kCapacity = 1024 * 1024;
+} // namespace
+
+TEST(CachingLogRepositoryTest, RepeatedReadsAreServedFromCache) {
+    auto repo = std::make_shared<NiceMock<DMockRepo>>();
+    repo->write({kDate, "content"});
+    CachingLogRepository cache{repo, kCapacity};
+
+    EXPECT_CALL(*repo, read(kDate)).Times(1);
+    EXPECT_CALL(*repo, read(kOtherDate)).Times(1);
+    for (int i = 0; i < 3; i++) {
+        ASSERT_TRUE(cache.read(kDate).has_value());
+        EXPECT_EQ(cache.read(kDate)->getContent(), "content");
+        // dates without a log are cached as well
+        EXPECT_FALSE(cache.read(kOtherDate).has_value());
+    }
+}
+
+TEST(CachingLogRepositoryTest, ReadManyServesCachedLogsWithoutCachingTheRest) {
+    auto repo = std::make_shared<NiceMock<DMockRepo>>();
+    repo->write({kDate, "content"});
+    repo->write({kOtherDate, "other content"});
+    const auto missingDate = std::chrono::year{2024} / std::chrono::March / 12;
+    CachingLogRepository cache{repo, kCapacity};
+    ASSERT_TRUE(cache.read(kDate).has_value());
+    const auto cachedBytes = cache.getCachedBytes();
+
+    // the cached log is not read again, the others are read by every `readMany`
+    EXPECT_CALL(*repo, read(kDate)).Times(0);
+    EXPECT_CALL(*repo, read(kOtherDate)).Times(2);
+    EXPECT_CALL(*repo, read(missingDate)).Times(2);
+    EXPECT_CALL(*repo, fingerprint(kOtherDate)).Times(0);
+    EXPECT_CALL(*repo, fingerprint(missingDate)).Times(0);
+    const std::vector dates{kDate, kOtherDate, missingDate};
+    for (int i = 0; i < 2; i++) {
+        std::map<std::chrono::year_month_day, std::string> logs;
+        cache.readMany(dates, [&logs](LogFile log) {
+            logs.emplace(log.getDate(), log.getContent());
+        });
+        EXPECT_EQ(logs, (std::map<std::chrono::year_month_day, std::string>{
+                            {kDate, "content"}, {kOtherDate, "other content"}}));
+    }
+    EXPECT_EQ(cache.getCachedBytes(), cachedBytes);
+}
+
+TEST(CachingLogRepositoryTest, WriteAndRemoveInvalidateTheCache) {
+    auto repo = std::make_shared<NiceMock<DMockRepo>>();
+    CachingLogRepository cache{repo, kCapacity};
+
+    EXPECT_FALSE(cache.read(kDate).has_value());
+    cache.write({kDate, "content"});
+    ASSERT_TRUE(cache.read(kDate).has_value());
+    EXPECT_EQ(cache.read(kDate)->getContent(), "content");
+
+    cache.write({kDate, "changed"});
+    EXPECT_EQ(cache.read(kDate)->getContent(), "changed");
+
+    cache.remove(kDate);
+    EXPECT_FALSE(cache.read(kDate).has_value());
+    EXPECT_GT(cache.getCachedBytes(), 0);
+}
+
+TEST(CachingLogRepositoryTest, ChangesBehindTheCacheAreDetectedByFingerprint) {
+    auto repo = std::make_shared<NiceMock<DMockRepo>>();
+    repo->write({kDate, "content"});
+    CachingLogRepository cache{repo, kCapacity, std::chrono::milliseconds{0}};
+    EXPECT_EQ(cache.read(kDate)->getContent(), "content");
+
+    // e.g. an external editor changing the file
+    repo->write({kDate, "edited"});
+    EXPECT_EQ(cache.read(kDate)->getContent(), "edited");
+
+    repo->remove(kDate);
+    EXPECT_FALSE(cache.read(kDate).has_value());
+}
+
+TEST(CachingLogRepositoryTest, RecentlyValidatedLogsAreServedUntilInvalidated) {
+    auto repo = std::make_shared<NiceMock<DMockRepo>>();
+    repo->write({kDate, "content"});
+    repo->write({kOtherDate, "other content"});
+    CachingLogRepository cache{repo, kCapacity, std::chrono::hours{1}};
+    EXPECT_EQ(cache.read(kDate)->getContent(), "content");
+    EXPECT_EQ(cache.read(kOtherDate)->getContent(), "other content");
+
+    EXPECT_CALL(*repo, fingerprint(_)).Times(0);
+    repo->write({kDate, "edited"});
+    repo->write({kOtherDate, "other edited"});
+    EXPECT_EQ(cache.read(kDate)->getContent(), "content");
+    ::testing::Mock::VerifyAndClearExpectations(repo.get());
+
+    cache.invalidate(kDate);
+    EXPECT_EQ(cache.read(kDate)->getContent(), "edited");
+    EXPECT_EQ(cache.read(kOtherDate)->getContent(), "other content");
+    cache.invalidateAll();
+    EXPECT_EQ(cache.read(kOtherDate)->getContent(), "other edited");
+}
+
+TEST(CachingLogRepositoryTest, LeastRecentlyUsedLogsAreEvicted) {
+    auto repo = std::make_shared<NiceMock<DMockRepo>>();
+    const std::string content(100, 'x');
+    const auto firstDay = std::chrono::sys_days{kDate};
+    for (int i = 0; i < 10; i++) {
+        repo->write({firstDay + std::chrono::days{i}, content});
+    }
+    CachingLogRepository cache{repo, 5 * (content.size() + 200)};
+
+    for (int i = 0; i < 10; i++) {
+        (void)cache.read(firstDay + std::chrono::days{i});
+        // keep the first log hot
+        (void)cache.read(kDate);
+        EXPECT_LE(cache.getCachedBytes(), 5 * (content.size() + 200));
+    }
+
+    EXPECT_CALL(*repo, read(kDate)).Times(0);
+    EXPECT_CALL(*repo, read(std::chrono::year_month_day{firstDay + std::chrono::days{1}}))
+        .Times(1);
+    (void)cache.read(kDate);
+    (void)cache.read(firstDay + std::chrono::days{1});
+}
+
+TEST(CachingLogRepositoryTest, PrefetchedLogsAreNotReadAgain) {
+    auto repo = std::make_shared<NiceMock<DMockRepo>>();
+    repo->write({kDate, "content"});
+    CachingLogRepository cache{repo, kCapacity};
+
+    EXPECT_CALL(*repo, read(_)).Times(2);
+    cache.prefetch({kDate, kOtherDate, std::chrono::year{2024} / std::chrono::February / 30});
+    cache.waitForPrefetch();
+    ::testing::Mock::VerifyAndClearExpectations(repo.get());
+
+    EXPECT_CALL(*repo, read(_)).Times(0);
+    EXPECT_EQ(cache.read(kDate)->getContent(), "content");
+    EXPECT_FALSE(cache.read(kOtherDate).has_value());
+}
+
+} // namespace caps_log::log::test
@@ -78,4 +78,61 @@ TEST(CalnedarComponentTest, EventHandling) {
     EXPECT_EQ(calendar.getFocusedDate(), nextMonth)
         << "Got date: " << caps_log::utils::date::formatToString(calendar.getFocusedDate());
 }
+TEST(CalnedarComponentTest, MonthIsRenderedAgainOnlyWhenItsStateChanges) {
+    using caps_log::view::CalendarOption;
+    CalendarOption::MonthState januaryState{};
+    std::size_t januaryDaysRendered = 0;
+    const CalendarOption option{
+        .transform =
+            [&](const std::chrono::year_month_day &date, const ftxui::EntryState &state) {
+                if (date.month() != std::chrono::January) {
+                    return ftxui::text(state.label);
+                }
+                januaryDaysRendered++;
+                const auto day = static_cast<unsigned>(date.day()) - 1;
+                return ftxui::text(januaryState.at(day) != 0 ? "XX" : state.label);
+            },
+        .focusChange = nullptr,
+        .enter = nullptr,
+        .monthState =
+            [&](std::chrono::month month) {
+                return month == std::chrono::January ? januaryState
+                                                     : CalendarOption::MonthState{};
+            },
+        .sundayStart = false,
+        .calendarBorder = ftxui::BorderStyle::ROUNDED,
+        .monthBorder = ftxui::BorderStyle::ROUNDED,
+    };
+    ftxui::Screen screen{184, 41};
+    caps_log::view::Calendar calendar{screenSizeProvider(ftxui::Dimensions{184, 41}),
+                                      {2024y, std::chrono::January, 1d}, option};
+
+    ftxui::Render(screen, calendar.Render());
+    EXPECT_EQ(januaryDaysRendered, 31);
+    EXPECT_EQ(screen.ToString().find("XX"), std::string::npos);
+
+    // nothing changed, the last element of the month is reused
+    ftxui::Render(screen, calendar.Render());
+    EXPECT_EQ(januaryDaysRendered, 31);
+
+    januaryState.at(14) = 1;
+    ftxui::Render(screen, calendar.Render());
+    EXPECT_EQ(januaryDaysRendered, 62);
+    EXPECT_NE(screen.ToString().find("XX"), std::string::npos);
+
+    // the mouse only makes the month it is over render again
+    const auto moveMouse = [&calendar](int x, int y) {
+        ftxui::Mouse mouse;
+        mouse.motion = ftxui::Mouse::Moved;
+        mouse.x = x;
+        mouse.y = y;
+        calendar.OnEvent(ftxui::Event::Mouse("", mouse));
+    };
+    moveMouse(0, 40);
+    ftxui::Render(screen, calendar.Render());
+    EXPECT_EQ(januaryDaysRendered, 62);
+    moveMouse(5, 4);
+    ftxui::Render(screen, calendar.Render());
+    EXPECT_EQ(januaryDaysRendered, 93);
+}
 // NOLINTEND(readability-magic-numbers,cppcoreguidelines-avoid-magic-numbers)
@@ -47,6 +47,20 @@ TEST(ConfigTest, DefaultConfigurations) {
     EXPECT_EQ(config.getPassword(), "");
     EXPECT_FALSE(config.getGitRepoConfig().has_value());
     EXPECT_TRUE(config.getAppConfig().events.empty());
+    EXPECT_FALSE(config.getPerfLogPath().has_value());
+    EXPECT_FALSE(config.shouldProfileStartup());
+    EXPECT_EQ(config.getAppConfig().collectWorkers, Configuration::kDefaultCollectWorkers);
+    EXPECT_EQ(config.getAppConfig().metadataIndexPath,
+              std::filesystem::path{Configuration::kDefaultLogDirPath} /
+                  Configuration::kDefaultMetadataIndexFileName);
+    EXPECT_EQ(config.getLogCacheSize(), Configuration::kDefaultLogCacheSize);
+    EXPECT_EQ(config.getAppConfig().preloadYears, Configuration::kDefaultPreloadYears);
+    EXPECT_EQ(config.getAppConfig().yearCacheSize, Configuration::kDefaultYearCacheSize);
+    EXPECT_EQ(config.getAppConfig().textSearch, Configuration::kDefaultTextSearch);
+    EXPECT_EQ(config.getAppConfig().taskIndex, Configuration::kDefaultTaskIndex);
+    EXPECT_EQ(config.getAppConfig().tagValues, Configuration::kDefaultTagValues);
+    EXPECT_EQ(config.getAppConfig().previewDebounce,
+              std::chrono::milliseconds{Configuration::kDefaultPreviewDebounceMs});
 }
 
 TEST(ConfigTest, ConfigFileOverrides) {
@@ -56,6 +70,14 @@ TEST(ConfigTest, ConfigFileOverrides) {
                                 "log-filename-format=override_format.md\n"
                                 "sunday-start=true\n"
                                 "first-line-section=false\n"
+                                "collect-workers=4\n"
+                                "metadata-index=false\n"
+                                "log-cache-size=1024\n"
+                                "preload-years=5\n"
+                                "text-search=false\n"
+                                "task-index=false\n"
+                                "tag-values=false\n"
+                                "preview-debounce-ms=0\n"
                                 "password=override_password";
     auto configFile = makeMockReadFileFunc(configContent);
 
@@ -65,6 +87,14 @@ TEST(ConfigTest, ConfigFileOverrides) {
     EXPECT_EQ(config.getLogFilenameFormat(), "override_format.md");
     EXPECT_TRUE(config.getViewConfig().annualViewConfig.sundayStart);
     EXPECT_TRUE(config.getAppConfig().skipFirstLine);
+    EXPECT_EQ(config.getAppConfig().collectWorkers, 4);
+    EXPECT_FALSE(config.getAppConfig().metadataIndexPath.has_value());
+    EXPECT_EQ(config.getLogCacheSize(), 1024);
+    EXPECT_EQ(config.getAppConfig().preloadYears, 5);
+    EXPECT_FALSE(config.getAppConfig().textSearch);
+    EXPECT_FALSE(config.getAppConfig().taskIndex);
+    EXPECT_FALSE(config.getAppConfig().tagValues);
+    EXPECT_EQ(config.getAppConfig().previewDebounce, std::chrono::milliseconds{0});
     EXPECT_EQ(config.getPassword(), "override_password");
     EXPECT_FALSE(config.getGitRepoConfig().has_value());
 }
@@ -80,7 +110,9 @@ TEST(ConfigTest, CommandLineOverrides) {
                                      "--sunday-start",
                                      "--first-line-section",
                                      "--password",
-                                     "cmd_override_password"};
+                                     "cmd_override_password",
+                                     "--perf-log",
+                                     "/tmp/caps-log-perf.txt"};
 
     std::string configContent = "log-dir-path=/file/override/path/\n"
                                 "log-filename-format=file_override_format.md\n"
@@ -97,6 +129,51 @@ TEST(ConfigTest, CommandLineOverrides) {
     EXPECT_FALSE(config.getAppConfig().skipFirstLine);
     EXPECT_EQ(config.getPassword(), "cmd_override_password");
     EXPECT_FALSE(config.getGitRepoConfig().has_value());
+    EXPECT_EQ(config.getPerfLogPath(), "/tmp/caps-log-perf.txt");
+}
+
+TEST(ConfigTest, GrepOptions) {
+    const auto configFile = makeMockReadFileFunc("collect-workers=3");
+    const auto grepConfig = [&configFile](const std::string &range) {
+        return Configuration({"caps-log", "--grep", "run", "--year-range", range}, configFile)
+            .getGrepConfig();
+    };
+
+    const Configuration config({"caps-log", "--grep", "^\\* run"}, configFile);
+    EXPECT_FALSE(config.shouldRunApplication());
+    EXPECT_EQ(config.getGrepPattern(), "^\\* run");
+    EXPECT_EQ(config.getGrepConfig().workers, 3);
+    EXPECT_FALSE(config.getGrepConfig().firstYear.has_value());
+
+    EXPECT_EQ(grepConfig("2019..2021").firstYear, std::chrono::year{2019});
+    EXPECT_EQ(grepConfig("2019..2021").lastYear, std::chrono::year{2021});
+    EXPECT_EQ(grepConfig("2019..").lastYear, std::nullopt);
+    EXPECT_EQ(grepConfig("..2021").firstYear, std::nullopt);
+    EXPECT_EQ(grepConfig("2020").firstYear, std::chrono::year{2020});
+    EXPECT_EQ(grepConfig("2020").lastYear, std::chrono::year{2020});
+    EXPECT_THROW(grepConfig("20x0..2021"), caps_log::ConfigParsingException);
+
+    EXPECT_THROW(Configuration({"caps-log", "--year-range", "2020"}, configFile).verify(),
+                 caps_log::ConfigParsingException);
+}
+
+TEST(ConfigTest, ProfileStartupOption) {
+    const auto configFile = makeMockReadFileFunc("");
+
+    const Configuration config({"caps-log", "--profile-startup"}, configFile);
+    EXPECT_TRUE(config.shouldProfileStartup());
+    EXPECT_FALSE(config.shouldProfileGitPull());
+    EXPECT_TRUE(config.shouldRunApplication());
+
+    EXPECT_THROW(
+        Configuration({"caps-log", "--profile-startup", "--grep", "run"}, configFile).verify(),
+        caps_log::ConfigParsingException);
+
+    // pulling changes the working copy, so it is only timed when asked for
+    EXPECT_TRUE(Configuration({"caps-log", "--profile-startup", "--profile-git-pull"}, configFile)
+                    .shouldProfileGitPull());
+    EXPECT_THROW(Configuration({"caps-log", "--profile-git-pull"}, configFile).verify(),
+                 caps_log::ConfigParsingException);
 }
 
 TEST(ConfigTest, GitConfigWorks) {
@@ -118,6 +195,12 @@ TEST(ConfigTest, GitConfigWorks) {
     EXPECT_EQ(config.getGitRepoConfig()->sshPubKeyPath, "/path/to/pub-key");
     EXPECT_EQ(config.getGitRepoConfig()->mainBranchName, "main-name");
     EXPECT_EQ(config.getGitRepoConfig()->remoteName, "remote-name");
+    // the index is not kept inside of the git repository by default
+    EXPECT_FALSE(config.getMetadataIndexPath().has_value());
+    // but one written before git was configured is still removed on encryption
+    EXPECT_EQ(config.getPossibleMetadataIndexPaths(),
+              (std::vector{std::filesystem::path{"/path/to/repo/log-dir"} /
+                           Configuration::kDefaultMetadataIndexFileName}));
 }
 
 TEST(ConfigTest, GitConfigDisabledIfUnset) {
@@ -8,7 +8,9 @@
 #include <ftxui/component/event.hpp>
 #include <gmock/gmock-spec-builders.h>
 #include <gmock/gmock.h>
+#include <condition_variable>
 #include <memory>
+#include <mutex>
 
 namespace caps_log::test {
 
@@ -213,6 +215,41 @@ TEST_F(ControllerTest, OnSelectedMenuItemChange_UpdateHighlightMap) {
     capsLog.run();
 }
 
+TEST_F(ControllerTest, OnQueryChange_HighlightsMatchesUntilTheQueryIsCleared) {
+    auto dummyLog1 = LogFile{day1, "\n# sectone \n* tagone\n* shared"};
+    auto dummyLog2 = LogFile{day2, "\n# secttwo \n* tagtwo\n* shared"};
+    mockRepo->getDummyRepo().write(dummyLog1);
+    mockRepo->getDummyRepo().write(dummyLog2);
+    auto capsLog = makeCapsLog();
+
+    EXPECT_CALL(*mockView, run());
+    ON_CALL(*mockView, run()).WillByDefault([&]() { // NOLINT
+        auto &dummyView = mockView->getDummyAnnualViewLayout();
+        using date::monthDay;
+
+        capsLog.handleInputEvent(UIEvent{QueryChange{"shared & !section:sectone"}});
+        ASSERT_NE(dummyView.m_highlightedDates, nullptr);
+        ASSERT_FALSE(dummyView.m_highlightedDates->contains(monthDay(dummyLog1.getDate())));
+        ASSERT_TRUE(dummyView.m_highlightedDates->contains(monthDay(dummyLog2.getDate())));
+
+        // an incomplete query keeps the last valid one highlighted
+        capsLog.handleInputEvent(UIEvent{QueryChange{"shared & !"}});
+        ASSERT_NE(dummyView.m_highlightedDates, nullptr);
+        ASSERT_TRUE(dummyView.m_highlightedDates->contains(monthDay(dummyLog2.getDate())));
+
+        // the menus do not override the query
+        dummyView.m_selectedTag = "tagone";
+        capsLog.handleInputEvent(UIEvent{FocusedTagChange{}});
+        ASSERT_FALSE(dummyView.m_highlightedDates->contains(monthDay(dummyLog1.getDate())));
+
+        capsLog.handleInputEvent(UIEvent{QueryChange{""}});
+        ASSERT_NE(dummyView.m_highlightedDates, nullptr);
+        ASSERT_TRUE(dummyView.m_highlightedDates->contains(monthDay(dummyLog1.getDate())));
+        ASSERT_FALSE(dummyView.m_highlightedDates->contains(monthDay(dummyLog2.getDate())));
+    });
+    capsLog.run();
+}
+
 TEST_F(ControllerTest, AddLog_UpdatesSectionsTagsAndMaps) {
     auto capsLog = makeCapsLog();
     EXPECT_TRUE(areTagMenuItemsEqual({"<select none>"}));
@@ -311,6 +348,39 @@ TEST_F(ControllerTest, AddLog_AddedLogWithTemplateOnlyGetsRemoved) {
     capsLog.run();
 }
 
+TEST_F(ControllerTest, ProgressiveCollect_FillsInTheYearAsTheMonthsArePosted) {
+    mockRepo->write(LogFile{day1, "\n# section title"});
+    mockRepo->write(LogFile{day1.year() / std::chrono::January / 3, "\n# other section"});
+
+    // posted tasks are run by the test once the whole year is collected
+    std::mutex mutex;
+    std::condition_variable condition;
+    std::vector<std::function<void()>> posted;
+    ON_CALL(*mockView, post).WillByDefault([&](std::string_view, const ftxui::Task &task) {
+        const std::scoped_lock lock{mutex};
+        posted.push_back(std::get<ftxui::Closure>(task));
+        condition.notify_one();
+    });
+
+    AppConfig conf;
+    conf.currentYear = day1.year();
+    conf.progressiveCollect = true;
+    auto capsLog =
+        App{mockView, mockRepo, mockScratchpadRepo, mockEditor, std::nullopt, std::move(conf)};
+    // only the focused log is read before the first frame
+    EXPECT_TRUE(areSectionMenuItemsEqual({"<select none>", makeMenuItemTitle("section title", 1)}));
+
+    std::unique_lock lock{mutex};
+    // both months and the end of the collection
+    ASSERT_TRUE(
+        condition.wait_for(lock, std::chrono::seconds{5}, [&] { return posted.size() == 3; }));
+    for (const auto &task : posted) {
+        task();
+    }
+    EXPECT_TRUE(areSectionMenuItemsEqual({"<select none>", makeMenuItemTitle("other section", 1),
+                                          makeMenuItemTitle("section title", 1)}));
+}
+
 TEST_F(ControllerTest, AddLog_ConfigSkipsFirstSection) {
     {
         auto capsLog = makeCapsLog();
@@ -386,7 +456,7 @@ TEST_F(ControllerTest, TagsPerSection_SelectingASectionShowsOnlyTagsAfterThatSec
         capsLog.handleInputEvent(UIEvent{FocusedSectionChange{}});
         EXPECT_TRUE(areTagMenuItemsEqual({"<select none>", makeMenuItemTitle("tag 1", 1)}));
         EXPECT_EQ(*(mockView->getDummyAnnualViewLayout().m_highlightedDates),
-                  std::set{date::monthDay(day1)});
+                  date::Dates{date::monthDay(day1)});
     });
     capsLog.run();
 }
@@ -434,7 +504,7 @@ TEST_F(ControllerTest,
         capsLog.handleInputEvent(UIEvent{FocusedSectionChange{}});
         EXPECT_TRUE(areTagMenuItemsEqual({"<select none>", makeMenuItemTitle("tag", 1)}));
         EXPECT_EQ(mockView->getDummyAnnualViewLayout().m_selectedTag, "<select none>");
-        const auto expectedDates = std::set{date::monthDay(day1), date::monthDay(day2)};
+        const auto expectedDates = date::Dates{date::monthDay(day1), date::monthDay(day2)};
         EXPECT_EQ(*(mockView->getDummyAnnualViewLayout().m_highlightedDates), expectedDates);
 
         // after selection of tag
@@ -443,7 +513,7 @@ TEST_F(ControllerTest,
         EXPECT_EQ(mockView->getDummyAnnualViewLayout().m_selectedSection, "section 1");
         EXPECT_EQ(mockView->getDummyAnnualViewLayout().m_selectedTag, "tag");
         EXPECT_EQ(*(mockView->getDummyAnnualViewLayout().m_highlightedDates),
-                  std::set{date::monthDay(day1)});
+                  date::Dates{date::monthDay(day1)});
     });
     capsLog.run();
 }
@@ -0,0 +1,99 @@
+#include <gtest/gtest.h>
+
+#include "utils/date.hpp"
+
+#include <chrono>
+#include <set>
+#include <vector>
+
+namespace caps_log::utils::date::testing {
+
+namespace {
+using std::chrono::April;
+using std::chrono::December;
+using std::chrono::February;
+using std::chrono::January;
+using std::chrono::March;
+using std::chrono::month_day;
+
+std::vector<month_day> allDaysOfLeapYear() {
+    std::vector<month_day> days;
+    const auto year = std::chrono::year{2020};
+    for (auto day = std::chrono::sys_days{year / January / 1};
+         day <= std::chrono::sys_days{year / December / 31}; day += std::chrono::days{1}) {
+        days.push_back(monthDay(std::chrono::year_month_day{day}));
+    }
+    return days;
+}
+
+} // namespace
+
+TEST(Dates, IndexRoundTripsForEveryDayOfALeapYear) {
+    const auto days = allDaysOfLeapYear();
+    ASSERT_EQ(days.size(), Dates::kCapacity);
+    for (std::size_t i = 0; i < days.size(); i++) {
+        EXPECT_EQ(Dates::toIndex(days[i]), i);
+        EXPECT_EQ(Dates::fromIndex(i), days[i]);
+    }
+}
+
+TEST(Dates, InsertEraseContainsAndSize) {
+    Dates dates;
+    EXPECT_TRUE(dates.empty());
+
+    dates.insert(January / 1);
+    dates.insert(February / 29);
+    dates.insert(December / 31);
+    dates.insert(December / 31);
+    EXPECT_EQ(dates.size(), 3);
+    EXPECT_TRUE(dates.contains(February / 29));
+    EXPECT_FALSE(dates.contains(March / 1));
+
+    EXPECT_EQ(dates.erase(February / 29), 1);
+    EXPECT_EQ(dates.erase(February / 29), 0);
+    EXPECT_EQ(dates.size(), 2);
+
+    dates.clear();
+    EXPECT_TRUE(dates.empty());
+}
+
+TEST(Dates, RejectsDaysThatAreNotInAYear) {
+    Dates dates{December / 31};
+    const std::chrono::month_day thirteenthMonth{std::chrono::month{13}, std::chrono::day{1}};
+    const std::chrono::month_day zerothMonth{std::chrono::month{0}, std::chrono::day{1}};
+
+    EXPECT_THROW(dates.insert(thirteenthMonth), std::out_of_range);
+    EXPECT_THROW(dates.insert(February / 30), std::out_of_range);
+    EXPECT_FALSE(dates.contains(thirteenthMonth));
+    EXPECT_FALSE(dates.contains(zerothMonth));
+    EXPECT_EQ(dates.erase(thirteenthMonth), 0);
+    EXPECT_EQ(dates, Dates{December / 31});
+    EXPECT_THROW((void)Dates::fromIndex(Dates::kCapacity), std::out_of_range);
+}
+
+TEST(Dates, IteratesInCalendarOrder) {
+    const Dates dates{December / 31, January / 1, March / 1, February / 29, April / 15};
+    const std::vector<month_day> expected{January / 1, February / 29, March / 1, April / 15,
+                                          December / 31};
+    EXPECT_EQ(std::vector<month_day>(dates.begin(), dates.end()), expected);
+
+    const auto allDays = allDaysOfLeapYear();
+    Dates full;
+    for (const auto &day : allDays) {
+        full.insert(day);
+    }
+    EXPECT_EQ(std::vector<month_day>(full.begin(), full.end()), allDays);
+    EXPECT_EQ(Dates{}.begin(), Dates{}.end());
+}
+
+TEST(Dates, SetOperationsMatchStdSet) {
+    const Dates lhs{January / 1, February / 29, March / 1, December / 31};
+    const Dates rhs{February / 29, March / 2, December / 31};
+
+    EXPECT_EQ(lhs | rhs, (Dates{January / 1, February / 29, March / 1, March / 2, December / 31}));
+    EXPECT_EQ(lhs & rhs, (Dates{February / 29, December / 31}));
+    EXPECT_EQ(lhs - rhs, (Dates{January / 1, March / 1}));
+    EXPECT_EQ(rhs - lhs, (Dates{March / 2}));
+}
+
+} // namespace caps_log::utils::date::testing
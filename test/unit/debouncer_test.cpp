@@ -0,0 +1,45 @@
+#include <gtest/gtest.h>
+
+#include "utils/debouncer.hpp"
+
+#include <atomic>
+#include <future>
+
+namespace caps_log::utils::test {
+
+using namespace std::chrono_literals;
+
+TEST(DebouncerTest, RunsOnlyTheLastTaskOfABurst) {
+    std::atomic<int> runs = 0;
+    std::promise<int> lastRun;
+    {
+        Debouncer debouncer{50ms};
+        for (int task = 1; task <= 5; task++) {
+            debouncer.schedule([&runs, &lastRun, task] {
+                runs++;
+                lastRun.set_value(task);
+            });
+        }
+        auto future = lastRun.get_future();
+        ASSERT_EQ(future.wait_for(5s), std::future_status::ready);
+        EXPECT_EQ(future.get(), 5);
+    }
+    EXPECT_EQ(runs, 1);
+}
+
+TEST(DebouncerTest, CancelledAndPendingTasksDoNotRun) {
+    std::atomic<int> runs = 0;
+    {
+        Debouncer debouncer{20ms};
+        debouncer.schedule([&runs] { runs++; });
+        debouncer.cancel();
+        std::this_thread::sleep_for(100ms);
+
+        // destroyed before its delay passes
+        Debouncer pending{1h};
+        pending.schedule([&runs] { runs++; });
+    }
+    EXPECT_EQ(runs, 0);
+}
+
+} // namespace caps_log::utils::test
@@ -0,0 +1,64 @@
+#include <gtest/gtest.h>
+
+#include "utils/fuzzy_filter.hpp"
+
+namespace caps_log::utils::test {
+
+namespace {
+const std::vector<std::string> kEntries{
+    "Health", "work meeting", "weekly review", "Running", "wm", "reading list",
+};
+} // namespace
+
+TEST(FuzzyFilterTest, EmptyPatternKeepsEveryEntryInOrder) {
+    FuzzyFilter filter{kEntries};
+    EXPECT_EQ(filter.matchCount(), kEntries.size());
+    EXPECT_EQ(filter.top(3), (std::vector<std::size_t>{0, 1, 2}));
+
+    filter.setPattern("wm");
+    filter.setPattern("");
+    EXPECT_EQ(filter.matchCount(), kEntries.size());
+    EXPECT_EQ(filter.top(100).size(), kEntries.size());
+}
+
+TEST(FuzzyFilterTest, MatchesSubsequencesCaseInsensitive) {
+    FuzzyFilter filter{kEntries};
+    filter.setPattern("HLT");
+    EXPECT_EQ(filter.top(10), (std::vector<std::size_t>{0}));
+
+    filter.setPattern("rng");
+    // "Running", "work meeting" and "reading list"
+    EXPECT_EQ(filter.matchCount(), 3);
+
+    filter.setPattern("xyz");
+    EXPECT_EQ(filter.matchCount(), 0);
+    EXPECT_TRUE(filter.top(10).empty());
+}
+
+TEST(FuzzyFilterTest, RanksWordStartsAndConsecutiveMatchesFirst) {
+    FuzzyFilter filter{kEntries};
+    filter.setPattern("wm");
+    const auto top = filter.top(10);
+    ASSERT_EQ(top.size(), 2);
+    // both characters consecutive and at word starts beats two word starts with a gap
+    EXPECT_EQ(top[0], 4);
+    EXPECT_EQ(top[1], 1);
+
+    filter.setPattern("re");
+    EXPECT_EQ(filter.top(1), (std::vector<std::size_t>{5}));
+}
+
+TEST(FuzzyFilterTest, NarrowingAndWideningGiveTheSameResultAsFreshFilter) {
+    FuzzyFilter incremental{kEntries};
+    for (const auto *pattern : {"r", "re", "rev", "re", "w", "we", "wee"}) {
+        incremental.setPattern(pattern);
+        FuzzyFilter fresh{kEntries};
+        fresh.setPattern(pattern);
+        EXPECT_EQ(incremental.top(100), fresh.top(100)) << pattern;
+    }
+    EXPECT_EQ(incremental.getPattern(), "wee");
+    // "weekly review" starts with the pattern, "work meeting" only contains it
+    EXPECT_EQ(incremental.top(10), (std::vector<std::size_t>{2, 1}));
+}
+
+} // namespace caps_log::utils::test
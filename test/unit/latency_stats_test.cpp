@@ -0,0 +1,65 @@
+#include <gtest/gtest.h>
+
+#include "utils/latency_stats.hpp"
+
+#include <algorithm>
+
+namespace caps_log::utils::test {
+
+using namespace std::chrono_literals;
+
+TEST(LatencyStatsTest, PercentilesAreWithinABucketOfTheRecordedValues) {
+    LatencyHistogram histogram;
+    EXPECT_EQ(histogram.percentile(0.5), 0ns);
+
+    for (int i = 1; i <= 100; i++) {
+        histogram.record(std::chrono::microseconds{i});
+    }
+    EXPECT_EQ(histogram.count(), 100);
+    EXPECT_EQ(histogram.max(), 100us);
+
+    const auto median = histogram.percentile(0.5);
+    EXPECT_GE(median, 50us);
+    EXPECT_LE(median, 50us * 5 / 4);
+    const auto tail = histogram.percentile(0.99);
+    EXPECT_GE(tail, 99us);
+    EXPECT_LE(tail, 100us);
+    EXPECT_EQ(histogram.percentile(1.0), 100us);
+}
+
+TEST(LatencyStatsTest, SmallAndHugeLatenciesAreRecorded) {
+    LatencyHistogram histogram;
+    histogram.record(-1ns);
+    histogram.record(0ns);
+    histogram.record(3ns);
+    EXPECT_EQ(histogram.percentile(0.5), 0ns);
+    EXPECT_EQ(histogram.percentile(1.0), 3ns);
+
+    histogram.record(std::chrono::nanoseconds::max());
+    EXPECT_EQ(histogram.max(), std::chrono::nanoseconds::max());
+    EXPECT_EQ(histogram.percentile(1.0), std::chrono::nanoseconds::max());
+}
+
+TEST(LatencyStatsTest, FormatsARowPerName) {
+    LatencyStats stats;
+    stats.record("render", 2ms);
+    stats.record("event:FocusedDateChange", 150us);
+    stats.record("render", 4ms);
+    {
+        const ScopedLatency latency{stats, "task"};
+    }
+
+    ASSERT_EQ(stats.histograms().size(), 3);
+    EXPECT_EQ(stats.histograms().at("render").count(), 2);
+    EXPECT_EQ(stats.histograms().at("task").count(), 1);
+
+    const auto table = stats.format();
+    EXPECT_NE(table.find("event:FocusedDateChange"), std::string::npos);
+    EXPECT_NE(table.find("150us"), std::string::npos);
+    EXPECT_NE(table.find("4.0ms"), std::string::npos);
+    // header and one row per name, sorted by name
+    EXPECT_EQ(std::ranges::count(table, '\n'), 4);
+    EXPECT_LT(table.find("event:"), table.find("render"));
+}
+
+} // namespace caps_log::utils::test
@@ -7,8 +7,10 @@
 #include <filesystem>
 #include <fstream>
 #include <gtest/gtest.h>
+#include <map>
 #include <sstream>
 #include <string>
+#include <vector>
 
 using namespace caps_log::log;
 using namespace ::testing;
@@ -76,6 +78,39 @@ TEST_F(LocalLogRepositoryTest, Read) {
     ASSERT_EQ(log->getContent(), logContent);
 }
 
+TEST_F(LocalLogRepositoryTest, LargeLogsOutliveTheirRewrite) {
+    auto repo = LocalLogRepository(TMPDirPathProvider);
+    // large enough to be memory mapped by `readMany`
+    const std::string logContent(256 * 1024, 'x');
+    writeDummyLog(kSelectedDate, logContent);
+
+    std::vector<LogFile> logs;
+    const std::vector dates{kSelectedDate};
+    repo.readMany(dates, [&logs](LogFile log) { logs.push_back(std::move(log)); });
+    ASSERT_EQ(logs.size(), 1);
+    const auto &log = logs.front();
+    ASSERT_EQ(log.getContent(), logContent);
+    // copies share the content
+    const auto copy = log;
+    EXPECT_EQ(copy.getContent().data(), log.getContent().data());
+
+    repo.write(LogFile{kSelectedDate, "rewritten"});
+    EXPECT_EQ(log.getContent(), logContent);
+    EXPECT_EQ(repo.read(kSelectedDate)->getContent(), "rewritten");
+}
+
+TEST_F(LocalLogRepositoryTest, ReadLargeLogsSurviveTruncationInPlace) {
+    auto repo = LocalLogRepository(TMPDirPathProvider);
+    const std::string logContent(256 * 1024, 'x');
+    writeDummyLog(kSelectedDate, logContent);
+    const auto log = repo.read(kSelectedDate);
+    ASSERT_TRUE(log.has_value());
+
+    // as editors that do not replace the file do, reading a mapping of it would raise SIGBUS
+    writeDummyLog(kSelectedDate, "truncated");
+    EXPECT_EQ(log->getContent(), logContent);
+}
+
 TEST_F(LocalLogRepositoryTest, Remove) {
     auto repo = LocalLogRepository(TMPDirPathProvider);
     const std::string logContent = "Dummy string";
@@ -94,6 +129,110 @@ TEST_F(LocalLogRepositoryTest, Write) {
     ASSERT_TRUE(std::filesystem::exists(TMPDirPathProvider.path(kSelectedDate)));
 }
 
+TEST_F(LocalLogRepositoryTest, WriteReplacesTheTargetOfALinkAndKeepsItsPermissions) {
+    auto repo = LocalLogRepository(TMPDirPathProvider);
+    const auto target = kTestLogDirectory / "target.md";
+    const auto path = TMPDirPathProvider.path(kSelectedDate);
+    writeDummyFile(target, "old");
+    std::filesystem::permissions(target, std::filesystem::perms::owner_read |
+                                             std::filesystem::perms::owner_write);
+    std::filesystem::create_directories(path.parent_path());
+    std::filesystem::create_symlink(target, path);
+
+    repo.write(LogFile{kSelectedDate, "new"});
+    EXPECT_TRUE(std::filesystem::is_symlink(path));
+    EXPECT_EQ(readFile(target), "new");
+    EXPECT_EQ(std::filesystem::status(target).permissions(),
+              std::filesystem::perms::owner_read | std::filesystem::perms::owner_write);
+    // no temporary file is left behind
+    EXPECT_EQ(std::distance(std::filesystem::directory_iterator{path.parent_path()},
+                            std::filesystem::directory_iterator{}),
+              1);
+}
+
+TEST_F(LocalLogRepositoryTest, ListLogDates) {
+    auto repo = LocalLogRepository(TMPDirPathProvider);
+    const auto otherYearDate = std::chrono::year{2006} / std::chrono::May / 25;
+    const auto leapDay = std::chrono::year{2004} / std::chrono::February / 29;
+
+    EXPECT_TRUE(repo.listLogDates(kSelectedDate.year()).empty());
+
+    writeDummyLog(kSelectedDate, "log");
+    writeDummyLog(otherYearDate, "log");
+    writeDummyLog(leapDay, "log");
+    const auto yearDir = TMPDirPathProvider.path(kSelectedDate).parent_path();
+    // files that do not match the format or belong to a different year are ignored
+    writeDummyFile((yearDir / "notes.md").string(), "not a log");
+    writeDummyFile((yearDir / "d2006_01_01.md").string(), "log from the wrong year directory");
+    writeDummyFile((yearDir / "d2005_02_30.md").string(), "invalid date");
+    writeDummyFile((yearDir / "d2005_01_01.md").string() + ".bak", "backup");
+    std::filesystem::create_directory(yearDir / "d2005_01_02.md");
+
+    using caps_log::utils::date::Dates;
+    using caps_log::utils::date::monthDay;
+    EXPECT_EQ(repo.listLogDates(kSelectedDate.year()), Dates{monthDay(kSelectedDate)});
+    EXPECT_EQ(repo.listLogDates(otherYearDate.year()), Dates{monthDay(otherYearDate)});
+    EXPECT_EQ(repo.listLogDates(leapDay.year()), Dates{monthDay(leapDay)});
+    EXPECT_TRUE(repo.listLogDates(std::chrono::year{2007}).empty());
+}
+
+TEST_F(LocalLogRepositoryTest, ListLogDatesFindsLeapDaysOfFormatsWithoutAYear) {
+    auto repo = LocalLogRepository(LocalFSLogFilePathProvider{kTestLogDirectory, "%m-%d.md"});
+    const auto leapDay = std::chrono::year{2024} / std::chrono::February / 29;
+    repo.write(LogFile{leapDay, "log"});
+    ASSERT_TRUE(repo.read(leapDay).has_value());
+
+    using caps_log::utils::date::Dates;
+    using caps_log::utils::date::monthDay;
+    EXPECT_EQ(repo.listLogDates(leapDay.year()), Dates{monthDay(leapDay)});
+}
+
+TEST_F(LocalLogRepositoryTest, ListLogYears) {
+    auto repo = LocalLogRepository(TMPDirPathProvider);
+    EXPECT_TRUE(repo.listLogYears().empty());
+
+    writeDummyLog(std::chrono::year{2006} / std::chrono::May / 25, "log");
+    writeDummyLog(std::chrono::year{2004} / std::chrono::May / 25, "log");
+    // only directories named like year directories count
+    std::filesystem::create_directory(TMPDirPathProvider.getLogDirPath() / "y20x5");
+    std::filesystem::create_directory(TMPDirPathProvider.getLogDirPath() / "scratchpads");
+    writeDummyFile((TMPDirPathProvider.getLogDirPath() / "y2005").string(), "not a directory");
+
+    EXPECT_EQ(repo.listLogYears(),
+              (std::vector<std::chrono::year>{std::chrono::year{2004}, std::chrono::year{2006}}));
+}
+
+TEST_F(LocalLogRepositoryTest, ReadRange) {
+    auto repo = LocalLogRepository(TMPDirPathProvider);
+    const auto before = std::chrono::year{2004} / std::chrono::December / 31;
+    const auto first = std::chrono::year{2005} / std::chrono::January / 1;
+    const auto emptyLog = std::chrono::year{2005} / std::chrono::May / 26;
+    const auto last = std::chrono::year{2006} / std::chrono::January / 1;
+    const auto after = std::chrono::year{2006} / std::chrono::January / 2;
+    for (const auto &date : {before, first, kSelectedDate, last, after}) {
+        writeDummyLog(date, caps_log::utils::date::formatToString(date, "%Y-%m-%d"));
+    }
+    writeDummyLog(emptyLog, "");
+
+    std::map<std::chrono::year_month_day, std::string> logs;
+    repo.readRange(first, last, [&logs](LogFile log) {
+        EXPECT_TRUE(logs.emplace(log.getDate(), log.getContent()).second);
+    });
+    EXPECT_EQ(logs, (std::map<std::chrono::year_month_day, std::string>{
+                        {first, "2005-01-01"},
+                        {kSelectedDate, "2005-05-25"},
+                        {emptyLog, ""},
+                        {last, "2006-01-01"},
+                    }));
+
+    // dates without a log are skipped
+    logs.clear();
+    const std::vector dates{before, std::chrono::year{2005} / std::chrono::May / 27};
+    repo.readMany(dates, [&logs](LogFile log) { logs.emplace(log.getDate(), log.getContent()); });
+    EXPECT_EQ(logs.size(), 1);
+    EXPECT_EQ(logs[before], "2004-12-31");
+}
+
 class EncryptedLocalLogRepositoryTest : public LocalLogRepositoryTest {
   public:
     void SetUp() override {
@@ -134,6 +273,18 @@ TEST_F(EncryptedLocalLogRepositoryTest, EncryptedRead) {
     EXPECT_EQ(readFile(TMPDirPathProvider.path(kSelectedDate)), kEncryptedDummyLogContent);
 }
 
+TEST_F(EncryptedLocalLogRepositoryTest, EncryptedReadMany) {
+    auto repo = LocalLogRepository(TMPDirPathProvider, kDummyPassword);
+    writeDummyLog(kSelectedDate, kEncryptedDummyLogContent);
+
+    std::vector<LogFile> logs;
+    const std::vector dates{kSelectedDate};
+    repo.readMany(dates, [&logs](LogFile log) { logs.push_back(std::move(log)); });
+    ASSERT_EQ(logs.size(), 1);
+    EXPECT_EQ(logs.front().getDate(), kSelectedDate);
+    EXPECT_EQ(logs.front().getContent(), kDummyLogContent);
+}
+
 TEST_F(EncryptedLocalLogRepositoryTest, EncryptedWrite) {
     auto repo = LocalLogRepository(TMPDirPathProvider, kDummyPassword);
 
@@ -2,8 +2,14 @@
 #include <gtest/gtest.h>
 
 #include "log/log_file.hpp"
+#include "log_parse_reference.hpp"
 #include "utils/string.hpp"
 
+#include <chrono>
+#include <random>
+#include <string_view>
+#include <vector>
+
 namespace caps_log::log::testing {
 
 namespace {
@@ -124,6 +130,39 @@ TEST(LogEntry, ParseTagsPerSection) {
     EXPECT_TRUE(parsedTagsPerSection.at("empty section").empty());
 }
 
+TEST(LogEntry, ParsedSectionsAreSortedViewsSharedByCopies) {
+    const auto *content = R"(date
+* root tag
+# Section B
+* Tag
+* tag
+* a tag
+# section a
+)";
+
+    auto log = LogFile{kDate, content};
+    EXPECT_TRUE(log.getSections().empty());
+    log.parse();
+    const auto copy = log;
+
+    const auto sections = log.getSections();
+    ASSERT_EQ(sections.size(), 3);
+    EXPECT_EQ(sections[0].title, LogFile::kRootSectionKey);
+    EXPECT_EQ(std::vector(sections[0].tags.begin(), sections[0].tags.end()),
+              std::vector<std::string_view>{"root tag"});
+    EXPECT_EQ(sections[1].title, "section a");
+    EXPECT_TRUE(sections[1].tags.empty());
+    EXPECT_EQ(sections[2].title, "section b");
+    EXPECT_EQ(std::vector(sections[2].tags.begin(), sections[2].tags.end()),
+              (std::vector<std::string_view>{"a tag", "tag"}));
+
+    // titles that are lowercase already point into the content
+    const auto contentView = log.getContent();
+    EXPECT_GE(sections[0].tags[0].data(), contentView.data());
+    EXPECT_LT(sections[0].tags[0].data(), contentView.data() + contentView.size());
+    EXPECT_EQ(copy.getSections().data(), sections.data());
+}
+
 TEST(LogEntry, ParseSectionTitles_IgnoreSectionsInCodeBlocks) {
     const auto *sectionInCodeBlock = R"(
 ```
@@ -167,4 +206,100 @@ TEST(LogEntry, ParseTagTitles_IgnoreTagInCodeBlocks) {
     EXPECT_TRUE(parsedSectionTag.empty());
 }
 
+TEST(LogEntry, ParseTasks) {
+    const auto *const content = R"(# 01. 05. 21.
+- [ ] Write the report: due friday
+- [x] (work) Send the invoice
+  [ ]   (home:garden)   Water the plants
+- [ ]
+- [ ] Call Bob's dentist
+- [ ] Čitati knjigu
+- [ ] #12 fix
+```
+- [ ] in a code block
+```
+* not a task
+)";
+
+    const LogFile log = LogFile{kDate, content}.parse();
+    const auto tasks = log.getTasks();
+    ASSERT_EQ(tasks.size(), 6);
+    EXPECT_TRUE(tasks[0].isOpen());
+    EXPECT_EQ(tasks[0].tag, "");
+    EXPECT_EQ(tasks[0].title, "Write the report: due friday");
+    EXPECT_FALSE(tasks[1].isOpen());
+    EXPECT_EQ(tasks[1].mark, 'x');
+    EXPECT_EQ(tasks[1].tag, "work");
+    EXPECT_EQ(tasks[1].title, "Send the invoice");
+    EXPECT_TRUE(tasks[2].isOpen());
+    EXPECT_EQ(tasks[2].tag, "home:garden");
+    EXPECT_EQ(tasks[2].title, "Water the plants");
+    EXPECT_EQ(tasks[3].title, "Call Bob's dentist");
+    EXPECT_EQ(tasks[4].title, "Čitati knjigu");
+    EXPECT_EQ(tasks[5].title, "#12 fix");
+
+    EXPECT_TRUE(LogFile(kDate, content).getTasks().empty());
+}
+
+TEST(LogEntry, ParseTagValues) {
+    const auto *const content = R"(# 01. 05. 21.
+* Weight (72.4)
+* sleep: 7.5 h
+* run (5km): morning
+* run: 3
+* mood (good)
+* date (10.5.2024)
+* score: 8/10
+# Section
+* focus (80%): deep work
+)";
+
+    const LogFile log = LogFile{kDate, content}.parse(false);
+    const auto values = log.getTagValues();
+    ASSERT_EQ(values.size(), 4);
+    EXPECT_EQ(values[0].tag, "focus");
+    EXPECT_DOUBLE_EQ(values[0].value, 80);
+    // a repeated tag keeps its last value
+    EXPECT_EQ(values[1].tag, "run");
+    EXPECT_DOUBLE_EQ(values[1].value, 3);
+    EXPECT_EQ(values[2].tag, "sleep");
+    EXPECT_DOUBLE_EQ(values[2].value, 7.5);
+    EXPECT_EQ(values[3].tag, "weight");
+    EXPECT_DOUBLE_EQ(values[3].value, 72.4);
+
+    // the values do not change which lines are tags
+    EXPECT_EQ(log.getTagTitles(), (std::set<std::string>{"date", "focus", "mood", "run", "score",
+                                                         "sleep", "weight"}));
+}
+
+TEST(LogEntry, Parse_MatchesRegexReference) {
+    const std::vector<std::string> handPicked{
+        "\n# section\r\n* tag\r\n",  "\n#   \n* tag\n",      "\n# a\rb\n* tag\n",
+        "\n# \v\f title \t\n",        "*  (x)\n",              "* a(b)c\n",
+        "* a()\n",                      "* a(b):c\n",            "* a(b)):c)\n",
+        "* a(b\n",                      "* a\0\n",               "* a:\0\n",
+        "* a(\0)\n",                    "*\ta\n",                "* a\xc3\xa9\n",
+        "```\n# in block\n```\n# after\n", "# first\n# second\n# first\n* tag\n",
+    };
+    for (const auto &content : handPicked) {
+        for (const auto skipFirstLine : {true, false}) {
+            EXPECT_EQ(LogFile(kDate, content).parse(skipFirstLine).getTagsPerSection(),
+                      test::regexParse(content, skipFirstLine))
+                << "Failed at: " << content;
+        }
+    }
+
+    constexpr auto kRandomLogCount = 2000;
+    constexpr auto kLinesPerLog = 8;
+    std::mt19937 rng{1}; // NOLINT(cert-msc32-c,cert-msc51-cpp): reproducible on purpose
+    for (auto i = 0; i < kRandomLogCount; i++) {
+        const auto content = test::makeRandomLog(rng, kLinesPerLog);
+        for (const auto skipFirstLine : {true, false}) {
+            ASSERT_EQ(LogFile(kDate, content).parse(skipFirstLine).getTagsPerSection(),
+                      test::regexParse(content, skipFirstLine))
+                << "Failed at: " << content;
+        }
+    }
+}
+
 } // namespace caps_log::log::testing
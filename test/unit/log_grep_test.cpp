@@ -0,0 +1,77 @@
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <fmt/format.h>
+
+#include "log/log_grep.hpp"
+#include "mocks.hpp"
+
+namespace caps_log::log::test {
+
+namespace {
+using std::chrono::May;
+
+std::vector<std::string> grepToStrings(const LogRepositoryBase &repo, const std::string &pattern,
+                                       const GrepConfig &config) {
+    std::vector<std::string> output;
+    grepLogs(repo, std::regex{pattern}, config, [&output](const GrepMatch &match) {
+        output.push_back(utils::date::formatToString(match.date, "%Y-%m-%d:") + match.line);
+    });
+    return output;
+}
+} // namespace
+
+TEST(LogGrepTest, ReportsMatchingLinesInDateOrder) {
+    DummyRepository repo;
+    for (int day = 1; day <= 28; day++) {
+        repo.write({std::chrono::year{2020} / May / day, fmt::format("day {}\nrun {}", day, day)});
+    }
+    repo.write({std::chrono::year{2019} / May / 1, "went for a run\nand a swim\nrun again"});
+
+    // a window smaller than the number of workers still reports every log once and in order
+    GrepConfig config;
+    config.workers = 4;
+    config.reorderWindow = 2;
+    const auto output = grepToStrings(repo, "^run", config);
+    ASSERT_EQ(output.size(), 29);
+    EXPECT_EQ(output[0], "2019-05-01:run again");
+    for (int day = 1; day <= 28; day++) {
+        EXPECT_EQ(output[day], fmt::format("2020-05-{:02}:run {}", day, day));
+    }
+}
+
+TEST(LogGrepTest, OnlySearchesTheYearRange) {
+    DummyRepository repo;
+    for (int year = 2015; year <= 2020; year++) {
+        repo.write({std::chrono::year{year} / May / 1, "entry"});
+    }
+    GrepConfig config;
+    config.firstYear = std::chrono::year{2017};
+    config.lastYear = std::chrono::year{2018};
+    EXPECT_EQ(grepToStrings(repo, "entry", config),
+              (std::vector<std::string>{"2017-05-01:entry", "2018-05-01:entry"}));
+
+    config.firstYear = std::chrono::year{2021};
+    config.lastYear = std::nullopt;
+    EXPECT_TRUE(grepToStrings(repo, "entry", config).empty());
+}
+
+TEST(LogGrepTest, RethrowsRepositoryErrors) {
+    DMockRepo repo;
+    for (int day = 1; day <= 10; day++) {
+        repo.getDummyRepo().write({std::chrono::year{2020} / May / day, "entry"});
+    }
+    EXPECT_CALL(repo, read(testing::_)).WillRepeatedly([&repo](const auto &date) {
+        if (date == std::chrono::year{2020} / May / 5) {
+            throw std::runtime_error{"can not decrypt"};
+        }
+        return repo.getDummyRepo().read(date);
+    });
+
+    GrepConfig config;
+    config.workers = 3;
+    config.reorderWindow = 4;
+    EXPECT_THROW((void)grepToStrings(repo, "entry", config), std::runtime_error);
+}
+
+} // namespace caps_log::log::test
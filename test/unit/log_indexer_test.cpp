@@ -0,0 +1,123 @@
+#include <gtest/gtest.h>
+
+#include "log/log_indexer.hpp"
+#include "log/tag_value_index.hpp"
+#include "log/task_index.hpp"
+#include "log/text_search_index.hpp"
+#include "mocks.hpp"
+
+#include <atomic>
+
+namespace caps_log::log::test {
+
+namespace {
+using std::chrono::April;
+using std::chrono::May;
+using Results = std::vector<std::chrono::year_month_day>;
+
+class CountingRepository : public DummyRepository {
+  public:
+    mutable std::atomic<int> reads{0};
+
+    [[nodiscard]] std::optional<LogFile>
+    read(const std::chrono::year_month_day &date) const override {
+        reads++;
+        return DummyRepository::read(date);
+    }
+};
+
+struct Indexes {
+    std::shared_ptr<TextSearchIndex> text = std::make_shared<TextSearchIndex>();
+    std::shared_ptr<TaskIndex> tasks = std::make_shared<TaskIndex>();
+    std::shared_ptr<TagValueIndex> tagValues = std::make_shared<TagValueIndex>();
+    LogIndexer indexer{{text, tasks, tagValues}, true};
+};
+} // namespace
+
+TEST(LogIndexerTest, BuildReadsEveryLogOnceForAllIndexes) {
+    const auto old = std::chrono::year{2019} / May / 1;
+    const auto recent = std::chrono::year{2021} / April / 3;
+    auto repo = std::make_shared<CountingRepository>();
+    repo->write({old, "- [ ] An old task\n* weight (90)"});
+    repo->write({recent, "- [ ] A recent task\n* weight (80)"});
+
+    Indexes indexes;
+    indexes.indexer.build(repo);
+    indexes.indexer.waitForBuild();
+    EXPECT_EQ(repo->reads, 2);
+    EXPECT_TRUE(indexes.indexer.contains(old));
+    EXPECT_TRUE(indexes.indexer.contains(recent));
+    EXPECT_EQ(indexes.text->search("task"), (Results{old, recent}));
+    EXPECT_EQ(indexes.tasks->openTasks(),
+              (std::vector<OpenTask>{{.date = recent, .tag = "", .title = "A recent task"},
+                                     {.date = old, .tag = "", .title = "An old task"}}));
+    EXPECT_EQ(indexes.tagValues->years("weight"),
+              (std::vector{std::chrono::year{2019}, std::chrono::year{2021}}));
+
+    // logs that are already indexed are not read again
+    indexes.indexer.build(repo);
+    indexes.indexer.waitForBuild();
+    EXPECT_EQ(repo->reads, 2);
+
+    indexes.indexer.clear();
+    EXPECT_FALSE(indexes.indexer.contains(old));
+    EXPECT_EQ(indexes.text->size(), 0);
+    EXPECT_TRUE(indexes.tasks->openTasks().empty());
+    EXPECT_TRUE(indexes.tagValues->years("weight").empty());
+}
+
+TEST(LogIndexerTest, BuildDoesNotOverwriteUpdatedLogs) {
+    const auto date = std::chrono::year{2021} / May / 1;
+    auto repo = std::make_shared<DummyRepository>();
+    repo->write({date, "- [ ] Write the report"});
+
+    Indexes indexes;
+    indexes.indexer.update({date, "- [x] Write the report\n* weight (80)"});
+    indexes.indexer.build(repo);
+    indexes.indexer.waitForBuild();
+    EXPECT_TRUE(indexes.tasks->openTasks().empty());
+    EXPECT_EQ(indexes.tagValues->years("weight"), (std::vector{std::chrono::year{2021}}));
+    EXPECT_EQ(indexes.text->search("report"), Results{date});
+}
+
+TEST(LogIndexerTest, RemovalsBeforeABuildDoNotKeepTheLogOut) {
+    const auto date = std::chrono::year{2021} / May / 1;
+    auto repo = std::make_shared<DummyRepository>();
+    repo->write({date, "- [ ] Write the report"});
+
+    Indexes indexes;
+    indexes.indexer.update({date, "- [ ] Write the report"});
+    indexes.indexer.remove(date);
+    EXPECT_FALSE(indexes.indexer.contains(date));
+    EXPECT_TRUE(indexes.tasks->openTasks().empty());
+
+    // only removals made while a build is running are kept out of it
+    indexes.indexer.build(repo);
+    indexes.indexer.waitForBuild();
+    EXPECT_TRUE(indexes.indexer.contains(date));
+    EXPECT_EQ(indexes.tasks->openTasks().size(), 1);
+}
+
+TEST(LogIndexerTest, LogsAreParsedWithTheGivenFirstLineSetting) {
+    const auto built = std::chrono::year{2021} / May / 1;
+    const auto updated = std::chrono::year{2021} / May / 2;
+    // with the first line as a section title the repeated section drops the weight
+    const auto content = "# Health\n* weight (80)\n# Health\n* sleep (7)";
+    auto repo = std::make_shared<DummyRepository>();
+    repo->write({built, content});
+
+    for (const auto skipFirstLine : {true, false}) {
+        auto tagValues = std::make_shared<TagValueIndex>();
+        LogIndexer indexer{{tagValues}, skipFirstLine};
+        indexer.build(repo);
+        indexer.waitForBuild();
+        indexer.update({updated, content});
+        const auto expected = skipFirstLine ? utils::date::Dates{May / 1, May / 2}
+                                            : utils::date::Dates{};
+        EXPECT_EQ(tagValues->datesWithValues("weight", std::chrono::year{2021}), expected);
+        EXPECT_EQ(tagValues->datesWithValues("sleep", std::chrono::year{2021}),
+                  (utils::date::Dates{May / 1, May / 2}));
+    }
+}
+
+} // namespace caps_log::log::test
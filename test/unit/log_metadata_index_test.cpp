@@ -0,0 +1,140 @@
+#include <gtest/gtest.h>
+
+#include "log/annual_log_data.hpp"
+#include "log/log_metadata_index.hpp"
+#include "mocks.hpp"
+
+#include <filesystem>
+#include <fstream>
+
+namespace caps_log::log::test {
+
+using ::testing::_;
+using ::testing::NiceMock;
+
+namespace {
+const std::filesystem::path kTestIndexDirectory =
+    std::filesystem::current_path() / "metadata_index_test_dir";
+const std::filesystem::path kTestIndexPath = kTestIndexDirectory / "index";
+
+const auto kDate1 = std::chrono::year{2020} / std::chrono::February / 29;
+const auto kDate2 = std::chrono::year{2020} / std::chrono::March / 1;
+const auto kDate3 = std::chrono::year{2021} / std::chrono::March / 1;
+
+using TagsPerSection = std::map<std::string, std::set<std::string>>;
+
+TagsPerSection toTagsPerSection(const LogMetadataView &view) {
+    TagsPerSection tagsPerSection;
+    view.forEachSectionTag([&](std::string_view section, std::optional<std::string_view> tag) {
+        auto &tags = tagsPerSection[std::string{section}];
+        if (tag) {
+            tags.emplace(*tag);
+        }
+    });
+    return tagsPerSection;
+}
+} // namespace
+
+class LogMetadataIndexTest : public ::testing::Test {
+  public:
+    void SetUp() override { std::filesystem::create_directories(kTestIndexDirectory); }
+    void TearDown() override { std::filesystem::remove_all(kTestIndexDirectory); }
+};
+
+TEST_F(LogMetadataIndexTest, UpdatesArePersistedBySave) {
+    const TagsPerSection tags1{{"<root section>", {"tag", "other tag"}}, {"empty section", {}}};
+    const TagsPerSection tags2{{"section", {"tag"}}};
+    {
+        LogMetadataIndex index{kTestIndexPath, true};
+        EXPECT_FALSE(index.find(kDate1).has_value());
+        index.update(kDate1, {.size = 10, .modificationTime = 1}, 1, tags1);
+        index.update(kDate2, {.size = 20, .modificationTime = 2}, 2, tags2);
+        index.update(kDate3, {.size = 30, .modificationTime = 3}, 3, {});
+        ASSERT_TRUE(index.find(kDate1).has_value());
+        EXPECT_EQ(toTagsPerSection(*index.find(kDate1)), tags1);
+        index.save();
+    }
+
+    LogMetadataIndex index{kTestIndexPath, true};
+    ASSERT_TRUE(index.find(kDate1).has_value());
+    EXPECT_EQ(index.find(kDate1)->fingerprint(),
+              (LogFileFingerprint{.size = 10, .modificationTime = 1}));
+    EXPECT_EQ(index.find(kDate1)->contentHash(), 1);
+    EXPECT_EQ(toTagsPerSection(*index.find(kDate1)), tags1);
+    ASSERT_TRUE(index.find(kDate2).has_value());
+    EXPECT_EQ(toTagsPerSection(*index.find(kDate2)), tags2);
+    ASSERT_TRUE(index.find(kDate3).has_value());
+    EXPECT_TRUE(toTagsPerSection(*index.find(kDate3)).empty());
+
+    // changes on top of a mapped index
+    index.erase(kDate1);
+    index.updateFingerprint(kDate2, {.size = 20, .modificationTime = 5});
+    index.retain(std::chrono::year{2021}, {});
+    EXPECT_FALSE(index.find(kDate1).has_value());
+    EXPECT_FALSE(index.find(kDate3).has_value());
+    index.save();
+
+    const LogMetadataIndex reopened{kTestIndexPath, true};
+    EXPECT_FALSE(reopened.find(kDate1).has_value());
+    EXPECT_FALSE(reopened.find(kDate3).has_value());
+    ASSERT_TRUE(reopened.find(kDate2).has_value());
+    EXPECT_EQ(reopened.find(kDate2)->fingerprint().modificationTime, 5);
+    EXPECT_EQ(toTagsPerSection(*reopened.find(kDate2)), tags2);
+}
+
+TEST_F(LogMetadataIndexTest, InvalidOrIncompatibleIndexIsTreatedAsEmpty) {
+    {
+        LogMetadataIndex index{kTestIndexPath, true};
+        index.update(kDate1, {.size = 10, .modificationTime = 1}, 1, {{"section", {"tag"}}});
+        index.save();
+    }
+    EXPECT_FALSE(LogMetadataIndex(kTestIndexPath, false).find(kDate1).has_value());
+
+    const auto size = std::filesystem::file_size(kTestIndexPath);
+    std::filesystem::resize_file(kTestIndexPath, size - 1);
+    EXPECT_FALSE(LogMetadataIndex(kTestIndexPath, true).find(kDate1).has_value());
+
+    std::ofstream{kTestIndexPath} << "definitely not an index";
+    EXPECT_FALSE(LogMetadataIndex(kTestIndexPath, true).find(kDate1).has_value());
+}
+
+TEST_F(LogMetadataIndexTest, CollectOnlyReadsLogsThatChanged) {
+    auto repo = std::make_shared<NiceMock<DMockRepo>>();
+    repo->write({kDate1, "\n# section\n* tag\n# empty section"});
+    repo->write({kDate2, "\n* root tag"});
+
+    const auto expected = AnnualLogData::collect(repo, kDate1.year());
+    {
+        auto index = std::make_shared<LogMetadataIndex>(kTestIndexPath, true);
+        EXPECT_CALL(*repo, read(_)).Times(2);
+        const auto data = AnnualLogData::collect(repo, kDate1.year(), true, 1, index);
+        EXPECT_EQ(data.getTagsPerSection(), expected.getTagsPerSection());
+        index->save();
+        ::testing::Mock::VerifyAndClearExpectations(repo.get());
+    }
+
+    auto index = std::make_shared<LogMetadataIndex>(kTestIndexPath, true);
+    {
+        EXPECT_CALL(*repo, read(_)).Times(0);
+        const auto data = AnnualLogData::collect(repo, kDate1.year(), true, 1, index);
+        EXPECT_EQ(data.datesWithLogs, expected.datesWithLogs);
+        EXPECT_EQ(data.getTagsPerSection(), expected.getTagsPerSection());
+        ::testing::Mock::VerifyAndClearExpectations(repo.get());
+    }
+
+    {
+        repo->write({kDate2, "\n* changed tag"});
+        EXPECT_CALL(*repo, read(kDate2)).Times(1);
+        auto data = AnnualLogData::collect(repo, kDate1.year(), true, 1, index);
+        EXPECT_NE(data.findDates(LogFile::kRootSectionKey, "changed tag"), nullptr);
+        ::testing::Mock::VerifyAndClearExpectations(repo.get());
+
+        repo->remove(kDate2);
+        EXPECT_CALL(*repo, read(kDate2)).Times(1);
+        data.collect(repo, kDate2, true, index);
+        EXPECT_FALSE(data.datesWithLogs.contains(utils::date::monthDay(kDate2)));
+        EXPECT_FALSE(index->find(kDate2).has_value());
+    }
+}
+
+} // namespace caps_log::log::test
@@ -0,0 +1,79 @@
+#pragma once
+
+#include "log/log_file.hpp"
+#include "utils/string.hpp"
+
+#include <map>
+#include <random>
+#include <regex>
+#include <set>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace caps_log::log::test {
+
+/**
+ * The original regex based parser, kept as a reference for the hand written scanner.
+ */
+inline std::map<std::string, std::set<std::string>> regexParse(const std::string &content,
+                                                               bool skipFirstLine = true) {
+    static const auto kSectionTitleRegex = std::regex{"^# \\s*(.*?)\\s*$"};
+    static const auto kTagRegex = std::regex{R"(^( +)?\*( +)([a-z A-Z 0-9 -]+)(\(.+\))?(:.*)?)",
+                                             std::regex_constants::extended};
+    constexpr auto kTagTitleMatch{3};
+    constexpr auto kSectionTitleMatch{1};
+
+    std::map<std::string, std::set<std::string>> tagsPerSection;
+    std::stringstream sstream{content};
+    std::string lastSection = LogFile::kRootSectionKey.data();
+    std::string line;
+    bool isInsideCodeBlock = false;
+    while (getline(sstream, line)) {
+        line = utils::lowercase(utils::trim(line));
+        if (line.substr(0, 3) == "```") {
+            isInsideCodeBlock = !isInsideCodeBlock;
+        }
+        if (isInsideCodeBlock) {
+            continue;
+        }
+        if (std::smatch sectionMatch; std::regex_match(line, sectionMatch, kSectionTitleRegex)) {
+            if (not skipFirstLine) {
+                lastSection = utils::trim(sectionMatch[kSectionTitleMatch]);
+                tagsPerSection[lastSection] = {};
+            }
+        } else if (std::smatch tagMatch; std::regex_match(line, tagMatch, kTagRegex)) {
+            tagsPerSection[lastSection].insert(utils::trim(tagMatch[kTagTitleMatch]));
+        }
+        skipFirstLine = false;
+    }
+    return tagsPerSection;
+}
+
+/**
+ * Builds a pseudo random log out of fragments that sit on the edges of the section and tag
+ * grammar.
+ */
+inline std::string makeRandomLog(std::mt19937 &rng, std::size_t lineCount) {
+    static const std::vector<std::string> kFragments{
+        "#",     "# ",    "## ",   "* ",    "*",    " ",     "  ",   "\t",   "\r",   "\v",
+        "\f",    "```",   "``",    "(",     ")",    "()",    "(x)",  ":",    "):",   "-",
+        "_",     "$",     "a",     "Tag",   "9",    "title", "X Y",  "\xc3", "\xa9", "*  ",
+        "# Sec", "* tag", "- [ ]", "(a)b",  ":b",   "((",    "))",   "#\t",  " * ",
+        // a NUL byte, which a "\0" literal would leave out
+        std::string{"\0", 1}};
+    std::uniform_int_distribution<std::size_t> fragmentDist{0, kFragments.size() - 1};
+    std::uniform_int_distribution<std::size_t> lengthDist{0, 6};
+
+    std::string log;
+    for (std::size_t i = 0; i < lineCount; i++) {
+        const auto length = lengthDist(rng);
+        for (std::size_t j = 0; j < length; j++) {
+            log += kFragments[fragmentDist(rng)];
+        }
+        log += '\n';
+    }
+    return log;
+}
+
+} // namespace caps_log::log::test
@@ -0,0 +1,20 @@
+#pragma once
+
+#include "log/log_file.hpp"
+
+#include <chrono>
+#include <string>
+#include <utility>
+
+namespace caps_log::log::test {
+
+/**
+ * A log with the given content that is already parsed, as the indexes expect them.
+ */
+inline LogFile parsed(const std::chrono::year_month_day &date, std::string content) {
+    LogFile log{date, std::move(content)};
+    log.parse();
+    return log;
+}
+
+} // namespace caps_log::log::test
@@ -196,7 +196,7 @@ class DMockView : public caps_log::view::ViewBase, public caps_log::view::InputH
         });
         ON_CALL(*this, run).WillByDefault([&]() { /* Do nothing */ });
         ON_CALL(*this, stop).WillByDefault([&]() { /* Do nothing */ });
-        ON_CALL(*this, post).WillByDefault([&](const ftxui::Task &task) {
+        ON_CALL(*this, post).WillByDefault([&](std::string_view name, const ftxui::Task &task) {
             // Do nothing, just a dummy implementation
         });
         ON_CALL(*this, withRestoredIO).WillByDefault([&](const std::function<void()> &func) {
@@ -230,7 +230,7 @@ class DMockView : public caps_log::view::ViewBase, public caps_log::view::InputH
                 (), (override));
     MOCK_METHOD(void, run, (), (override));
     MOCK_METHOD(void, stop, (), (override));
-    MOCK_METHOD(void, post, (const ftxui::Task &task), (override));
+    MOCK_METHOD(void, post, (std::string_view name, const ftxui::Task &task), (override));
     MOCK_METHOD(void, withRestoredIO, (std::function<void()> func), (override));
     MOCK_METHOD(void, setInputHandler, (caps_log::view::InputHandlerBase * handler), (override));
     MOCK_METHOD(caps_log::view::PopUpViewBase &, getPopUpView, (), (override));
@@ -248,6 +248,8 @@ class DMockView : public caps_log::view::ViewBase, public caps_log::view::InputH
 
 class DummyRepository : public caps_log::log::LogRepositoryBase {
     std::map<std::chrono::year_month_day, std::string> m_data;
+    // stands in for the modification time, bumped on every write
+    std::map<std::chrono::year_month_day, std::int64_t> m_writeCounts;
 
   public:
     [[nodiscard]] std::optional<caps_log::log::LogFile>
@@ -258,10 +260,40 @@ class DummyRepository : public caps_log::log::LogRepositoryBase {
         return std::nullopt;
     }
 
+    [[nodiscard]] caps_log::utils::date::Dates listLogDates(std::chrono::year year) const override {
+        caps_log::utils::date::Dates dates;
+        for (const auto &[date, _] : m_data) {
+            if (date.year() == year) {
+                dates.insert(caps_log::utils::date::monthDay(date));
+            }
+        }
+        return dates;
+    }
+
+    [[nodiscard]] std::vector<std::chrono::year> listLogYears() const override {
+        std::vector<std::chrono::year> years;
+        for (const auto &[date, _] : m_data) {
+            if (years.empty() || years.back() != date.year()) {
+                years.push_back(date.year());
+            }
+        }
+        return years;
+    }
+
+    [[nodiscard]] std::optional<caps_log::log::LogFileFingerprint>
+    fingerprint(const std::chrono::year_month_day &date) const override {
+        if (auto it = m_data.find(date); it != m_data.end()) {
+            return caps_log::log::LogFileFingerprint{.size = it->second.size(),
+                                                     .modificationTime = m_writeCounts.at(date)};
+        }
+        return std::nullopt;
+    }
+
     void remove(const std::chrono::year_month_day &date) override { m_data.erase(date); }
 
     void write(const caps_log::log::LogFile &file) override {
         m_data[file.getDate()] = file.getContent();
+        m_writeCounts[file.getDate()]++;
     }
 };
 
@@ -294,6 +326,13 @@ class DMockRepo : public caps_log::log::LogRepositoryBase {
   public:
     DMockRepo() {
         ON_CALL(*this, read).WillByDefault([this](const auto &date) { return m_repo.read(date); });
+        ON_CALL(*this, listLogDates).WillByDefault([this](auto year) {
+            return m_repo.listLogDates(year);
+        });
+        ON_CALL(*this, listLogYears).WillByDefault([this]() { return m_repo.listLogYears(); });
+        ON_CALL(*this, fingerprint).WillByDefault([this](const auto &date) {
+            return m_repo.fingerprint(date);
+        });
         ON_CALL(*this, write).WillByDefault([this](const auto &log) { return m_repo.write(log); });
         ON_CALL(*this, remove).WillByDefault([this](const auto &date) {
             return m_repo.remove(date);
@@ -304,6 +343,11 @@ class DMockRepo : public caps_log::log::LogRepositoryBase {
 
     MOCK_METHOD(std::optional<caps_log::log::LogFile>, read,
                 (const std::chrono::year_month_day &date), (const, override));
+    MOCK_METHOD(caps_log::utils::date::Dates, listLogDates, (std::chrono::year year),
+                (const, override));
+    MOCK_METHOD(std::vector<std::chrono::year>, listLogYears, (), (const, override));
+    MOCK_METHOD(std::optional<caps_log::log::LogFileFingerprint>, fingerprint,
+                (const std::chrono::year_month_day &date), (const, override));
     MOCK_METHOD(void, remove, (const std::chrono::year_month_day &date), (override));
     MOCK_METHOD(void, write, (const caps_log::log::LogFile &file), (override));
 };
@@ -0,0 +1,57 @@
+#include <gtest/gtest.h>
+
+#include "utils/phase_profiler.hpp"
+
+#include <stdexcept>
+#include <thread>
+
+namespace caps_log::utils::test {
+
+using namespace std::chrono_literals;
+
+TEST(PhaseProfilerTest, RecordsPhasesInOrder) {
+    PhaseProfiler profiler;
+    const auto result = profiler.measure("sleep", [] {
+        std::this_thread::sleep_for(20ms);
+        return 42;
+    });
+    EXPECT_EQ(result, 42);
+    profiler.measure("nothing", [] {});
+    EXPECT_THROW(profiler.measure("throws", [] { throw std::runtime_error{"failed"}; }),
+                 std::runtime_error);
+
+    const auto &phases = profiler.getPhases();
+    ASSERT_EQ(phases.size(), 3);
+    EXPECT_EQ(phases[0].name, "sleep");
+    EXPECT_EQ(phases[1].name, "nothing");
+    EXPECT_EQ(phases[2].name, "throws");
+    EXPECT_GE(phases[0].wallTime, 20ms);
+    // sleeping takes no cpu time
+    EXPECT_LT(phases[0].cpuTime, phases[0].wallTime);
+}
+
+TEST(PhaseProfilerTest, FormatsARowPerPhaseAndTheirTotal) {
+    PhaseProfiler profiler;
+    profiler.measure("parse configuration", [] {});
+    profiler.measure("construct app", [] {});
+
+    const auto table = profiler.format();
+    const auto configuration = table.find("parse configuration");
+    const auto app = table.find("construct app");
+    const auto total = table.find("total");
+    ASSERT_NE(configuration, std::string::npos);
+    ASSERT_NE(app, std::string::npos);
+    ASSERT_NE(total, std::string::npos);
+    EXPECT_LT(configuration, app);
+    EXPECT_LT(app, total);
+}
+
+TEST(PhaseProfilerTest, DisabledProfilerOnlyRunsThePhases) {
+    PhaseProfiler profiler{false};
+    EXPECT_EQ(profiler.measure("answer", [] { return 42; }), 42);
+    EXPECT_THROW(profiler.measure("throws", [] { throw std::runtime_error{"failed"}; }),
+                 std::runtime_error);
+    EXPECT_TRUE(profiler.getPhases().empty());
+}
+
+} // namespace caps_log::utils::test
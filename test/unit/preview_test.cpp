@@ -0,0 +1,39 @@
+#include <gtest/gtest.h>
+
+#include "view/preview.hpp"
+
+#include <ftxui/screen/screen.hpp>
+#include <string>
+
+namespace caps_log::view::test {
+
+namespace {
+std::string render(Preview &preview) {
+    ftxui::Screen screen{40, 10};
+    ftxui::Render(screen, preview.Render());
+    return screen.ToString();
+}
+} // namespace
+
+TEST(PreviewTest, ShowsTheNewDocumentWhenTheContentChanges) {
+    Preview preview{PreviewOption{.border = ftxui::BorderStyle::ROUNDED,
+                                  .markdownTheme = getDefaultMarkdownTheme()}};
+
+    preview.setContent("log", "first content");
+    auto output = render(preview);
+    EXPECT_NE(output.find("first content"), std::string::npos);
+
+    preview.setContent("log", "second content");
+    output = render(preview);
+    EXPECT_NE(output.find("second content"), std::string::npos);
+    EXPECT_EQ(output.find("first content"), std::string::npos);
+
+    // a content shown before is taken from the cache, with the title it is shown with now
+    preview.setContent("other log", "first content");
+    output = render(preview);
+    EXPECT_NE(output.find("first content"), std::string::npos);
+    EXPECT_NE(output.find("other log"), std::string::npos);
+    EXPECT_EQ(output.find("second content"), std::string::npos);
+}
+
+} // namespace caps_log::view::test
@@ -0,0 +1,63 @@
+#include <gtest/gtest.h>
+
+#include "log/tag_query.hpp"
+#include "mocks.hpp"
+
+namespace caps_log::log::test {
+
+namespace {
+using std::chrono::May;
+const auto kYear = std::chrono::year{2021};
+
+AnnualLogData makeData() {
+    auto repo = std::make_shared<DummyRepository>();
+    repo->write({kYear / May / 1, "\n* work\n* meeting"});
+    repo->write({kYear / May / 2, "\n* work\n# health\n* run"});
+    repo->write({kYear / May / 3, "\n# health\n* swim"});
+    repo->write({kYear / May / 4, "\n* run\n* Tag With Spaces"});
+    repo->write({kYear / May / 5, "\nno tags at all"});
+    return AnnualLogData::collect(repo, kYear);
+}
+
+utils::date::Dates evaluate(std::string_view query) {
+    static const auto kData = makeData();
+    return TagQuery::compile(query).evaluate(kData);
+}
+} // namespace
+
+TEST(TagQueryTest, SingleTermsMatchTagsAndSections) {
+    EXPECT_EQ(evaluate("work"), (utils::date::Dates{May / 1, May / 2}));
+    EXPECT_EQ(evaluate("tag:run"), (utils::date::Dates{May / 2, May / 4}));
+    EXPECT_EQ(evaluate("section:health"), (utils::date::Dates{May / 2, May / 3}));
+    EXPECT_EQ(evaluate("  TAG WITH spaces "), (utils::date::Dates{May / 4}));
+    EXPECT_EQ(evaluate("\"tag with spaces\""), (utils::date::Dates{May / 4}));
+    EXPECT_TRUE(evaluate("unknown tag").empty());
+}
+
+TEST(TagQueryTest, OperatorsFollowPrecedence) {
+    EXPECT_EQ(evaluate("work & !meeting"), (utils::date::Dates{May / 2}));
+    EXPECT_EQ(evaluate("!work"), (utils::date::Dates{May / 3, May / 4, May / 5}));
+    EXPECT_EQ(evaluate("work & !meeting | (section:health & run)"), (utils::date::Dates{May / 2}));
+    EXPECT_EQ(evaluate("meeting | swim & section:health"), (utils::date::Dates{May / 1, May / 3}));
+    EXPECT_EQ(evaluate("(meeting | swim) & section:health"), (utils::date::Dates{May / 3}));
+    EXPECT_EQ(evaluate("!!run"), (utils::date::Dates{May / 2, May / 4}));
+}
+
+TEST(TagQueryTest, MalformedQueriesReportThePosition) {
+    const auto errorPosition = [](std::string_view query) -> std::optional<std::size_t> {
+        try {
+            (void)TagQuery::compile(query);
+        } catch (const TagQueryError &error) {
+            return error.getPosition();
+        }
+        return std::nullopt;
+    };
+    EXPECT_EQ(errorPosition(""), 0);
+    EXPECT_EQ(errorPosition("work &"), 6);
+    EXPECT_EQ(errorPosition("(work | run"), 0);
+    EXPECT_EQ(errorPosition("work)"), 4);
+    EXPECT_EQ(errorPosition("\"work"), 0);
+    EXPECT_EQ(errorPosition("work & !meeting"), std::nullopt);
+}
+
+} // namespace caps_log::log::test
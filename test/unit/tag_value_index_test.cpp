@@ -0,0 +1,150 @@
+#include <gtest/gtest.h>
+
+#include "log/tag_value_index.hpp"
+#include "log_test_helpers.hpp"
+
+namespace caps_log::log::test {
+
+namespace {
+using std::chrono::December;
+using std::chrono::January;
+using std::chrono::March;
+using Aggregation = TagValueIndex::Aggregation;
+using Period = TagValueIndex::Period;
+using Bucket = TagValueIndex::Bucket;
+
+std::vector<std::optional<double>> valuesOf(const std::vector<Bucket> &buckets) {
+    std::vector<std::optional<double>> values;
+    for (const auto &bucket : buckets) {
+        values.push_back(bucket.value);
+    }
+    return values;
+}
+} // namespace
+
+TEST(TagValueIndexTest, AggregatesPerYearAndMonth) {
+    const auto year = std::chrono::year{2021};
+    TagValueIndex index;
+    index.update(parsed(year / January / 1, "* weight (80)\n* sleep: 7"));
+    index.update(parsed(year / January / 31, "* weight (78)"));
+    index.update(parsed(year / March / 2, "* weight (76)"));
+    index.update(parsed(std::chrono::year{2022} / March / 2, "* weight (74)"));
+
+    const auto sums = index.aggregate("weight", Aggregation::kSum, Period::kYear, year,
+                                      std::chrono::year{2022});
+    EXPECT_EQ(sums, (std::vector<Bucket>{{.begin = year / January / 1, .value = 234},
+                                         {.begin = std::chrono::year{2022} / January / 1,
+                                          .value = 74}}));
+
+    const auto averages =
+        index.aggregate("weight", Aggregation::kAverage, Period::kMonth, year, year);
+    ASSERT_EQ(averages.size(), 12);
+    EXPECT_EQ(averages[0].value, 79);
+    EXPECT_EQ(averages[1].value, std::nullopt);
+    EXPECT_EQ(averages[2].value, 76);
+    EXPECT_EQ(averages[2].begin, year / March / 1);
+
+    EXPECT_EQ(valuesOf(index.aggregate("weight", Aggregation::kMin, Period::kYear, year, year)),
+              (std::vector<std::optional<double>>{76}));
+    EXPECT_EQ(valuesOf(index.aggregate("weight", Aggregation::kMax, Period::kYear, year, year)),
+              (std::vector<std::optional<double>>{80}));
+    EXPECT_EQ(valuesOf(index.aggregate("sleep", Aggregation::kCount, Period::kYear, year,
+                                       std::chrono::year{2022})),
+              (std::vector<std::optional<double>>{1, 0}));
+    EXPECT_EQ(valuesOf(index.aggregate("unknown", Aggregation::kSum, Period::kYear, year, year)),
+              (std::vector<std::optional<double>>{std::nullopt}));
+
+    EXPECT_EQ(index.years("weight"), (std::vector{year, std::chrono::year{2022}}));
+    EXPECT_EQ(index.datesWithValues("weight", year),
+              (utils::date::Dates{January / 1, January / 31, March / 2}));
+}
+
+TEST(TagValueIndexTest, WeeksStartOnMondayAndSpanTheTurnOfTheYear) {
+    TagValueIndex index;
+    // thursday and friday of the week starting on monday the 28th of december 2020
+    index.update(parsed(std::chrono::year{2020} / December / 31, "* run (5)"));
+    index.update(parsed(std::chrono::year{2021} / January / 1, "* run (3)"));
+    index.update(parsed(std::chrono::year{2021} / January / 4, "* run (10)"));
+
+    const auto year = std::chrono::year{2021};
+    const auto weeks = index.aggregate("run", Aggregation::kSum, Period::kWeek, year, year);
+    ASSERT_EQ(weeks.size(), 53);
+    EXPECT_EQ(weeks[0], (Bucket{.begin = std::chrono::year{2020} / December / 28, .value = 8}));
+    EXPECT_EQ(weeks[1], (Bucket{.begin = year / January / 4, .value = 10}));
+    EXPECT_EQ(weeks[52].begin, std::chrono::year{2021} / December / 27);
+}
+
+TEST(TagValueIndexTest, UpdateReplacesTheValuesOfItsDate) {
+    const auto year = std::chrono::year{2021};
+    const auto date = year / January / 1;
+    TagValueIndex index;
+    index.update(parsed(date, "* weight (80)"));
+    index.update(parsed(year / January / 2, "* weight (79)"));
+
+    index.update(parsed(date, "* weight (70)"));
+    EXPECT_EQ(valuesOf(index.aggregate("weight", Aggregation::kSum, Period::kYear, year, year)),
+              (std::vector<std::optional<double>>{149}));
+
+    // a tag the log no longer has loses its value, the other logs keep theirs
+    index.update(parsed(date, "* sleep (8)"));
+    EXPECT_EQ(index.datesWithValues("weight", year), (utils::date::Dates{January / 2}));
+    EXPECT_EQ(valuesOf(index.aggregate("weight", Aggregation::kMin, Period::kYear, year, year)),
+              (std::vector<std::optional<double>>{79}));
+    EXPECT_EQ(index.datesWithValues("sleep", year), (utils::date::Dates{January / 1}));
+}
+
+TEST(TagValueIndexTest, LogsWithoutValuesAreNotKept) {
+    const auto year = std::chrono::year{2021};
+    const auto date = year / January / 1;
+    TagValueIndex index;
+    index.update(parsed(year / January / 2, "* weight\nno values here"));
+    EXPECT_FALSE(index.contains(year / January / 2));
+
+    index.update(parsed(date, "* weight (80)"));
+    EXPECT_TRUE(index.contains(date));
+    index.update(parsed(date, "* weight"));
+    EXPECT_FALSE(index.contains(date));
+    EXPECT_TRUE(index.years("weight").empty());
+}
+
+TEST(TagValueIndexTest, ARepeatedTagCountsOncePerDate) {
+    const auto year = std::chrono::year{2021};
+    TagValueIndex index;
+    index.update(parsed(year / January / 1, "* weight (80)\n# Evening\n* weight (81)"));
+
+    EXPECT_EQ(valuesOf(index.aggregate("weight", Aggregation::kSum, Period::kYear, year, year)),
+              (std::vector<std::optional<double>>{81}));
+    EXPECT_EQ(valuesOf(index.aggregate("weight", Aggregation::kCount, Period::kYear, year, year)),
+              (std::vector<std::optional<double>>{1}));
+}
+
+TEST(TagValueIndexTest, RemovingTheLastValueOfAYearDropsTheYear) {
+    const auto date = std::chrono::year{2020} / March / 2;
+    const auto other = std::chrono::year{2021} / March / 2;
+    TagValueIndex index;
+    index.update(parsed(date, "* weight (80)\n* sleep: 7"));
+    index.update(parsed(other, "* weight (79)"));
+
+    index.remove(date);
+    EXPECT_FALSE(index.contains(date));
+    EXPECT_EQ(index.years("weight"), (std::vector{std::chrono::year{2021}}));
+    EXPECT_TRUE(index.years("sleep").empty());
+    EXPECT_EQ(valuesOf(index.aggregate("weight", Aggregation::kCount, Period::kYear,
+                                       std::chrono::year{2020}, std::chrono::year{2021})),
+              (std::vector<std::optional<double>>{0, 1}));
+
+    index.clear();
+    EXPECT_TRUE(index.years("weight").empty());
+    EXPECT_FALSE(index.contains(other));
+}
+
+TEST(TagValueIndexTest, SparklinesAreScaledBetweenLowAndHigh) {
+    const auto date = std::chrono::year{2021} / January / 1;
+    const std::vector<Bucket> buckets{
+        {.begin = date, .value = 0}, {.begin = date, .value = std::nullopt},
+        {.begin = date, .value = 5}, {.begin = date, .value = 10}, {.begin = date, .value = 20}};
+    EXPECT_EQ(TagValueIndex::makeSparkline(buckets, 0, 10), "▁ ▅██");
+    EXPECT_EQ(TagValueIndex::makeSparkline(std::span{buckets}.first(1), 0, 0), "▅");
+}
+
+} // namespace caps_log::log::test
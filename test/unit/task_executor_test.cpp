@@ -0,0 +1,69 @@
+#include <gtest/gtest.h>
+
+#include "utils/task_executor.hpp"
+
+#include <atomic>
+#include <future>
+#include <thread>
+
+namespace caps_log::utils::test {
+
+TEST(CancellableTaskExecutorTest, PostingAJobCancelsTheOlderOnes) {
+    std::promise<void> started;
+    std::promise<void> release;
+    auto releaseFuture = release.get_future();
+    std::atomic<bool> firstCancelled = false;
+    std::atomic<bool> secondCancelled = true;
+
+    CancellableTaskExecutor executor;
+    executor.post([&](const CancellableTaskExecutor::Token &token) {
+        started.set_value();
+        releaseFuture.wait();
+        firstCancelled = token.isCancelled();
+    });
+    started.get_future().wait();
+    executor.post([&](const CancellableTaskExecutor::Token &token) {
+        secondCancelled = token.isCancelled();
+    });
+    release.set_value();
+    executor.wait();
+
+    EXPECT_TRUE(firstCancelled);
+    EXPECT_FALSE(secondCancelled);
+}
+
+TEST(CancellableTaskExecutorTest, CancelCancelsTheRunningJob) {
+    std::promise<void> started;
+    std::promise<void> release;
+    auto releaseFuture = release.get_future();
+    std::atomic<bool> cancelled = false;
+
+    CancellableTaskExecutor executor;
+    executor.post([&](const CancellableTaskExecutor::Token &token) {
+        started.set_value();
+        releaseFuture.wait();
+        cancelled = token.isCancelled();
+    });
+    started.get_future().wait();
+    executor.cancel();
+    release.set_value();
+    executor.wait();
+
+    EXPECT_TRUE(cancelled);
+}
+
+TEST(CancellableTaskExecutorTest, DestructionCancelsTheRunningJob) {
+    std::atomic<bool> cancelled = false;
+    {
+        CancellableTaskExecutor executor;
+        executor.post([&](const CancellableTaskExecutor::Token &token) {
+            while (not token.isCancelled()) {
+                std::this_thread::yield();
+            }
+            cancelled = true;
+        });
+    }
+    EXPECT_TRUE(cancelled);
+}
+
+} // namespace caps_log::utils::test
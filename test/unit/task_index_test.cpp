@@ -0,0 +1,50 @@
+#include <gtest/gtest.h>
+
+#include "log/task_index.hpp"
+#include "log_test_helpers.hpp"
+
+namespace caps_log::log::test {
+
+namespace {
+using std::chrono::April;
+using std::chrono::May;
+using Tasks = std::vector<OpenTask>;
+} // namespace
+
+TEST(TaskIndexTest, ListsOpenTasksMostRecentFirst) {
+    const auto first = std::chrono::year{2021} / May / 1;
+    const auto second = std::chrono::year{2021} / May / 2;
+    TaskIndex index;
+    index.update(parsed(
+        first, "- [ ] (work) Write the report\n- [x] Done already\n- [ ] Call Anna's dentist"));
+    index.update(parsed(second, "- [ ] Water the plants"));
+    index.update(parsed(std::chrono::year{2020} / April / 3, "- [x] Nothing open"));
+
+    EXPECT_EQ(index.openTasks(), (Tasks{
+                                     {.date = second, .tag = "", .title = "Water the plants"},
+                                     {.date = first, .tag = "work", .title = "Write the report"},
+                                     {.date = first, .tag = "", .title = "Call Anna's dentist"},
+                                 }));
+    EXPECT_EQ(index.datesWithOpenTasks(std::chrono::year{2021}),
+              (utils::date::Dates{May / 1, May / 2}));
+    EXPECT_TRUE(index.datesWithOpenTasks(std::chrono::year{2020}).empty());
+}
+
+TEST(TaskIndexTest, UpdateAndRemoveOnlyTouchTheirDate) {
+    const auto date = std::chrono::year{2021} / May / 1;
+    const auto other = std::chrono::year{2021} / May / 2;
+    TaskIndex index;
+    index.update(parsed(date, "- [ ] Write the report"));
+    index.update(parsed(other, "- [ ] Water the plants"));
+
+    index.update(parsed(date, "- [x] Write the report"));
+    EXPECT_EQ(index.openTasks(), (Tasks{{.date = other, .tag = "", .title = "Water the plants"}}));
+
+    index.remove(other);
+    EXPECT_EQ(index.openTasks(), Tasks{});
+
+    index.clear();
+    EXPECT_TRUE(index.datesWithOpenTasks(std::chrono::year{2021}).empty());
+}
+
+} // namespace caps_log::log::test
@@ -0,0 +1,80 @@
+#include <gtest/gtest.h>
+
+#include "log/text_search_index.hpp"
+
+namespace caps_log::log::test {
+
+namespace {
+using std::chrono::April;
+using std::chrono::May;
+using Results = std::vector<std::chrono::year_month_day>;
+} // namespace
+
+TEST(TextSearchIndexTest, SearchMatchesAllWordsAndTheLastOneAsAPrefix) {
+    TextSearchIndex index;
+    index.update({std::chrono::year{2021} / May / 1, "# Work\nMet Anna about the budget."});
+    index.update({std::chrono::year{2021} / May / 2, "Went for a run with ANNA."});
+    index.update({std::chrono::year{2020} / April / 3, "budget, budgeting and more budgets"});
+
+    EXPECT_EQ(index.search("anna"),
+              (Results{std::chrono::year{2021} / May / 1, std::chrono::year{2021} / May / 2}));
+    EXPECT_EQ(index.search("Anna budget"), (Results{std::chrono::year{2021} / May / 1}));
+    EXPECT_EQ(index.search("budget"),
+              (Results{std::chrono::year{2020} / April / 3, std::chrono::year{2021} / May / 1}));
+    // a trailing space ends the last word
+    EXPECT_EQ(index.search("budgets "), (Results{std::chrono::year{2020} / April / 3}));
+    EXPECT_EQ(index.search("budg "), Results{});
+    EXPECT_EQ(index.search("anna r"), (Results{std::chrono::year{2021} / May / 2}));
+    EXPECT_EQ(index.search("unknown anna"), Results{});
+    EXPECT_EQ(index.search(" !? "), Results{});
+}
+
+TEST(TextSearchIndexTest, UpdateAndRemoveReplaceWhatWasIndexed) {
+    const auto date = std::chrono::year{2021} / May / 1;
+    TextSearchIndex index;
+    index.update({date, "first version"});
+    index.update({date, "second version"});
+    EXPECT_EQ(index.search("first "), Results{});
+    EXPECT_EQ(index.search("second "), Results{date});
+    EXPECT_EQ(index.size(), 1);
+
+    index.remove(date);
+    EXPECT_EQ(index.search("version"), Results{});
+    EXPECT_FALSE(index.contains(date));
+    EXPECT_EQ(index.size(), 0);
+
+    index.update({date, "third version"});
+    index.clear();
+    EXPECT_EQ(index.search("version"), Results{});
+    EXPECT_EQ(index.size(), 0);
+}
+
+TEST(TextSearchIndexTest, BatchesInAnyOrderKeepThePostingsSorted) {
+    const auto first = std::chrono::year{2020} / April / 3;
+    const auto second = std::chrono::year{2021} / May / 1;
+    const auto third = std::chrono::year{2021} / May / 2;
+    const auto fourth = std::chrono::year{2022} / April / 3;
+    TextSearchIndex index;
+    // newer batches first and out of order within a batch, like a build reads them
+    const std::vector<LogFile> newer{{fourth, "a run"}, {third, "a run and a swim"}};
+    index.updateMany(newer);
+    const std::vector<LogFile> older{{second, "a swim"}, {first, "a run"}, {second, "a walk"}};
+    index.updateMany(older);
+
+    EXPECT_EQ(index.search("run "), (Results{first, third, fourth}));
+    EXPECT_EQ(index.search("a "), (Results{first, second, third, fourth}));
+    // the last log of a date in a batch wins
+    EXPECT_EQ(index.search("swim "), Results{third});
+    EXPECT_EQ(index.search("walk "), Results{second});
+    EXPECT_EQ(index.size(), 4);
+}
+
+TEST(TextSearchIndexTest, SnippetsShowTheFirstMatchOnASingleLine) {
+    EXPECT_EQ(TextSearchIndex::makeSnippet("line one\n\nline two", "missing", 40),
+              "line one line two");
+    EXPECT_EQ(TextSearchIndex::makeSnippet("0123456789 some words then the MATCH and more", "match",
+                                           15),
+              "...the MATCH and...");
+}
+
+} // namespace caps_log::log::test
@@ -0,0 +1,101 @@
+#include <gtest/gtest.h>
+
+#include "view/annual_view_layout_base.hpp"
+#include "view/windowed_menu.hpp"
+
+#include <fmt/format.h>
+#include <ftxui/component/event.hpp>
+#include <ftxui/screen/screen.hpp>
+#include <string>
+#include <vector>
+
+namespace caps_log::view::test {
+
+namespace {
+constexpr int kScreenWidth = 40;
+// the border of the window takes two rows, ten are left for the entries
+constexpr int kScreenHeight = 12;
+constexpr std::size_t kVisibleRows = 10;
+
+WindowedMenuOption makeOption(const std::vector<std::string> &entries,
+                              const std::uint64_t *entriesVersion, bool filterable) {
+    return WindowedMenuOption{
+        .title = "Menu",
+        .entries = &entries,
+        .entriesVersion = entriesVersion,
+        .onChange = nullptr,
+        .border = ftxui::BorderStyle::ROUNDED,
+        .entryDecorator = nullptr,
+        .selectedEntryDecorator = nullptr,
+        .filterable = filterable,
+    };
+}
+
+std::string render(WindowedMenu &menu) {
+    ftxui::Screen screen{kScreenWidth, kScreenHeight};
+    ftxui::Render(screen, menu.Render());
+    return screen.ToString();
+}
+
+std::size_t countOccurrences(const std::string &text, const std::string &word) {
+    std::size_t count = 0;
+    for (auto pos = text.find(word); pos != std::string::npos; pos = text.find(word, pos + 1)) {
+        count++;
+    }
+    return count;
+}
+} // namespace
+
+TEST(WindowedMenuTest, FillsTheWindowWithTheRowsAroundTheSelectedEntry) {
+    std::vector<std::string> entries;
+    for (int i = 0; i < 1000; i++) {
+        entries.push_back(fmt::format("entry {:04}", i));
+    }
+    WindowedMenu menu{makeOption(entries, nullptr, false)};
+    // the first render measures the window
+    (void)render(menu);
+
+    menu.select(500);
+    auto output = render(menu);
+    EXPECT_NE(output.find("> entry 0500"), std::string::npos);
+    EXPECT_EQ(countOccurrences(output, "entry 0"), kVisibleRows);
+    EXPECT_EQ(output.find("entry 0000"), std::string::npos);
+    EXPECT_EQ(output.find("entry 0999"), std::string::npos);
+
+    // the window stops at the ends of the list instead of centering the selected entry
+    menu.OnEvent(ftxui::Event::End);
+    EXPECT_EQ(menu.selected(), 999);
+    output = render(menu);
+    EXPECT_NE(output.find("> entry 0999"), std::string::npos);
+    EXPECT_NE(output.find("entry 0990"), std::string::npos);
+    EXPECT_EQ(countOccurrences(output, "entry 0"), kVisibleRows);
+
+    menu.OnEvent(ftxui::Event::Home);
+    EXPECT_EQ(menu.selected(), 0);
+    output = render(menu);
+    EXPECT_NE(output.find("> entry 0000"), std::string::npos);
+    EXPECT_NE(output.find("entry 0009"), std::string::npos);
+    EXPECT_EQ(countOccurrences(output, "entry 0"), kVisibleRows);
+}
+
+TEST(WindowedMenuTest, FilterIsRebuiltWhenTheEntriesAreReplaced) {
+    MenuItems items{{"apple", "banana", "cherry"}, {"apple", "banana", "cherry"}};
+    WindowedMenu menu{makeOption(items.getDisplayTexts(), &items.getVersion(), true)};
+    for (const auto character : {'f', 'a', 'n'}) {
+        menu.OnEvent(ftxui::Event::Character(character));
+    }
+    ASSERT_TRUE(menu.isFiltering());
+    auto output = render(menu);
+    EXPECT_NE(output.find("banana"), std::string::npos);
+    EXPECT_EQ(output.find("apple"), std::string::npos);
+    EXPECT_EQ(output.find("cherry"), std::string::npos);
+
+    items = MenuItems{{"mango", "kiwi", "orange"}, {"mango", "kiwi", "orange"}};
+    output = render(menu);
+    EXPECT_NE(output.find("mango"), std::string::npos);
+    EXPECT_NE(output.find("orange"), std::string::npos);
+    EXPECT_EQ(output.find("kiwi"), std::string::npos);
+    EXPECT_NE(output.find("(2)"), std::string::npos);
+}
+
+} // namespace caps_log::view::test